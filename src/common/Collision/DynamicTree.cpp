@@ -27,6 +27,7 @@
 #include "VMapFactory.h"
 #include "VMapMgr2.h"
 #include "WorldModel.h"
+#include <atomic>
 
 using VMAP::ModelInstance;
 
@@ -60,7 +61,8 @@ struct DynTreeImpl : public ParentTree
 
     DynTreeImpl() :
         rebalance_timer(CHECK_TREE_PERIOD),
-        unbalanced_times(0)
+        unbalanced_times(0),
+        generation(0)
     {
     }
 
@@ -68,12 +70,14 @@ struct DynTreeImpl : public ParentTree
     {
         base::insert(mdl);
         ++unbalanced_times;
+        ++generation;
     }
 
     void remove(const Model& mdl)
     {
         base::remove(mdl);
         ++unbalanced_times;
+        ++generation;
     }
 
     void balance()
@@ -102,6 +106,7 @@ struct DynTreeImpl : public ParentTree
 
     TimeTrackerSmall rebalance_timer;
     int unbalanced_times;
+    std::atomic<uint32> generation;
 };
 
 DynamicMapTree::DynamicMapTree() : impl(new DynTreeImpl()) { }
@@ -141,6 +146,16 @@ void DynamicMapTree::update(uint32 t_diff)
     impl->update(t_diff);
 }
 
+uint32 DynamicMapTree::GetGeneration() const
+{
+    return impl->generation.load(std::memory_order_acquire);
+}
+
+void DynamicMapTree::NotifyModelChanged()
+{
+    ++impl->generation;
+}
+
 struct DynamicTreeIntersectionCallback
 {
     DynamicTreeIntersectionCallback(uint32 phasemask, VMAP::ModelIgnoreFlags ignoreFlags) :
@@ -63,6 +63,10 @@ public:
 
     void balance();
     void update(uint32 diff);
+
+    // Changes whenever a model is inserted, removed or toggled, results cached under an older generation are stale
+    [[nodiscard]] uint32 GetGeneration() const;
+    void NotifyModelChanged();
 };
 
 #endif // _DYNTREE_H
@@ -23,12 +23,30 @@
 #include "Errors.h"
 #include "Log.h"
 #include "MapDefines.h"
+#include <memory>
 
 namespace MMAP
 {
     constexpr auto MAP_FILE_NAME_FORMAT = "{}/mmaps/{:03}.mmap";
     constexpr auto TILE_FILE_NAME_FORMAT = "{}/mmaps/{:03}{:02}{:02}.mmtile";
 
+    namespace
+    {
+        struct NavMeshQueryDeleter
+        {
+            void operator()(dtNavMeshQuery* query) const { dtFreeNavMeshQuery(query); }
+        };
+
+        struct ThreadNavMeshQuery
+        {
+            uint32 meshSerial{};
+            std::unique_ptr<dtNavMeshQuery, NavMeshQueryDeleter> query;
+        };
+
+        // dtNavMeshQuery is not thread safe, every thread keeps one per navmesh it paths on
+        thread_local std::unordered_map<uint32 /*mapId*/, ThreadNavMeshQuery> ThreadNavMeshQueries;
+    }
+
     // ######################## MMapMgr ########################
     MMapMgr::~MMapMgr()
     {
@@ -110,7 +128,7 @@ namespace MMAP
         LOG_DEBUG("maps", "MMAP:loadMapData: Loaded {:03}.mmap", mapId);
 
         // store inside our map list
-        MMapData* mmap_data = new MMapData(mesh);
+        MMapData* mmap_data = new MMapData(mesh, ++nextMeshSerial);
         itr->second = mmap_data;
         return true;
     }
@@ -122,6 +140,8 @@ namespace MMAP
 
     bool MMapMgr::loadMap(uint32 mapId, int32 x, int32 y)
     {
+        std::lock_guard<std::mutex> guard(loadLock);
+
         // make sure the mmap is loaded and ready to load tiles
         if (!loadMapData(mapId))
         {
@@ -134,10 +154,11 @@ namespace MMAP
 
         // check if we already have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
-        if (mmap->loadedTileRefs.find(packedGridPos) != mmap->loadedTileRefs.end())
+        MMapTileSet::iterator tile = mmap->loadedTileRefs.find(packedGridPos);
+        if (tile != mmap->loadedTileRefs.end())
         {
-            LOG_ERROR("maps", "MMAP:loadMap: Asked to load already loaded navmesh tile. {:03}{:02}{:02}.mmtile", mapId, x, y);
-            return false;
+            ++tile->second.refCount;
+            return true;
         }
 
         // load this tile :: mmaps/MMMXXYY.mmtile
@@ -180,11 +201,17 @@ namespace MMAP
         fclose(file);
 
         dtTileRef tileRef = 0;
+        dtStatus addStatus;
 
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef)))
         {
-            mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+            std::unique_lock<std::shared_mutex> tilesGuard(mmap->tilesLock);
+            addStatus = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
+        }
+
+        if (dtStatusSucceed(addStatus))
+        {
+            mmap->loadedTileRefs.emplace(packedGridPos, MMapTile{ tileRef, 1 });
             ++loadedTiles;
             dtMeshHeader* header = (dtMeshHeader*)data;
             LOG_DEBUG("maps", "MMAP:loadMap: Loaded mmtile {:03}[{:02},{:02}] into {:03}[{:02},{:02}]", mapId, x, y, mapId, header->x, header->y);
@@ -198,6 +225,8 @@ namespace MMAP
 
     bool MMapMgr::unloadMap(uint32 mapId, int32 x, int32 y)
     {
+        std::lock_guard<std::mutex> guard(loadLock);
+
         // check if we have this map loaded
         MMapDataSet::const_iterator itr = GetMMapData(mapId);
         if (itr == loadedMMaps.end())
@@ -211,17 +240,26 @@ namespace MMAP
 
         // check if we have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
-        if (mmap->loadedTileRefs.find(packedGridPos) == mmap->loadedTileRefs.end())
+        MMapTileSet::iterator tile = mmap->loadedTileRefs.find(packedGridPos);
+        if (tile == mmap->loadedTileRefs.end())
         {
             // file may not exist, therefore not loaded
             LOG_DEBUG("maps", "MMAP:unloadMap: Asked to unload not loaded navmesh tile. {:03}{:02}{:02}.mmtile", mapId, x, y);
             return false;
         }
 
-        dtTileRef tileRef = mmap->loadedTileRefs[packedGridPos];
+        // still used by another map
+        if (--tile->second.refCount)
+            return true;
+
+        dtStatus removeStatus;
+        {
+            std::unique_lock<std::shared_mutex> tilesGuard(mmap->tilesLock);
+            removeStatus = mmap->navMesh->removeTile(tile->second.tileRef, nullptr, nullptr);
+        }
 
         // unload, and mark as non loaded
-        if (dtStatusFailed(mmap->navMesh->removeTile(tileRef, nullptr, nullptr)))
+        if (dtStatusFailed(removeStatus))
         {
             // this is technically a memory leak
             // if the grid is later reloaded, dtNavMesh::addTile will return error but no extra memory is used
@@ -230,7 +268,7 @@ namespace MMAP
             ABORT();
         }
 
-        mmap->loadedTileRefs.erase(packedGridPos);
+        mmap->loadedTileRefs.erase(tile);
         --loadedTiles;
         LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile {:03}[{:02},{:02}] from {:03}", mapId, x, y, mapId);
         return true;
@@ -238,6 +276,8 @@ namespace MMAP
 
     bool MMapMgr::unloadMap(uint32 mapId)
     {
+        std::lock_guard<std::mutex> guard(loadLock);
+
         MMapDataSet::iterator itr = loadedMMaps.find(mapId);
         if (itr == loadedMMaps.end() || !itr->second)
         {
@@ -248,12 +288,13 @@ namespace MMAP
 
         // unload all tiles from given map
         MMapData* mmap = itr->second;
-        for (auto i : mmap->loadedTileRefs)
+        std::unique_lock<std::shared_mutex> tilesGuard(mmap->tilesLock);
+        for (auto const& i : mmap->loadedTileRefs)
         {
             uint32 x = (i.first >> 16);
             uint32 y = (i.first & 0x0000FFFF);
 
-            if (dtStatusFailed(mmap->navMesh->removeTile(i.second, nullptr, nullptr)))
+            if (dtStatusFailed(mmap->navMesh->removeTile(i.second.tileRef, nullptr, nullptr)))
             {
                 LOG_ERROR("maps", "MMAP:unloadMap: Could not unload {:03}{:02}{:02}.mmtile from navmesh", mapId, x, y);
             }
@@ -264,6 +305,7 @@ namespace MMAP
             }
         }
 
+        tilesGuard.unlock();
         delete mmap;
         itr->second = nullptr;
         LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded {:03}.mmap", mapId);
@@ -271,34 +313,18 @@ namespace MMAP
         return true;
     }
 
-    bool MMapMgr::unloadMapInstance(uint32 mapId, uint32 instanceId)
+    dtNavMesh const* MMapMgr::GetNavMesh(uint32 mapId)
     {
-        // check if we have this map loaded
         MMapDataSet::const_iterator itr = GetMMapData(mapId);
         if (itr == loadedMMaps.end())
         {
-            // file may not exist, therefore not loaded
-            LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map {:03}", mapId);
-            return false;
-        }
-
-        MMapData* mmap = itr->second;
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-        {
-            LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId {:03} instanceId {}", mapId, instanceId);
-            return false;
+            return nullptr;
         }
 
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
-
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
-        LOG_DEBUG("maps", "MMAP:unloadMapInstance: Unloaded mapId {:03} instanceId {}", mapId, instanceId);
-
-        return true;
+        return itr->second->navMesh;
     }
 
-    dtNavMesh const* MMapMgr::GetNavMesh(uint32 mapId)
+    dtNavMeshQuery const* MMapMgr::GetNavMeshQuery(uint32 mapId)
     {
         MMapDataSet::const_iterator itr = GetMMapData(mapId);
         if (itr == loadedMMaps.end())
@@ -306,39 +332,37 @@ namespace MMAP
             return nullptr;
         }
 
-        return itr->second->navMesh;
-    }
+        MMapData const* mmap = itr->second;
+        ThreadNavMeshQuery& threadQuery = ThreadNavMeshQueries[mapId];
+        if (threadQuery.query && threadQuery.meshSerial == mmap->serial)
+        {
+            return threadQuery.query.get();
+        }
 
-    dtNavMeshQuery const* MMapMgr::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
-    {
-        MMapDataSet::const_iterator itr = GetMMapData(mapId);
-        if (itr == loadedMMaps.end())
+        // allocate mesh query
+        std::unique_ptr<dtNavMeshQuery, NavMeshQueryDeleter> query(dtAllocNavMeshQuery());
+        ASSERT(query);
+
+        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
         {
+            LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId {:03}", mapId);
             return nullptr;
         }
 
-        MMapData* mmap = itr->second;
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId {:03}", mapId);
+        threadQuery.meshSerial = mmap->serial;
+        threadQuery.query = std::move(query);
+        return threadQuery.query.get();
+    }
+
+    std::shared_lock<std::shared_mutex> MMapMgr::LockNavMeshTiles(uint32 mapId)
+    {
+        MMapDataSet::const_iterator itr = GetMMapData(mapId);
+        if (itr == loadedMMaps.end())
         {
-            // check again after acquiring mutex
-            if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-            {
-                // allocate mesh query
-                dtNavMeshQuery* query = dtAllocNavMeshQuery();
-                ASSERT(query);
-
-                if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
-                {
-                    dtFreeNavMeshQuery(query);
-                    LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId {:03} instanceId {}", mapId, instanceId);
-                    return nullptr;
-                }
-
-                LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId {:03} instanceId {}", mapId, instanceId);
-                mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
-            }
+            return {};
         }
 
-        return mmap->navMeshQueries[instanceId];
+        return std::shared_lock<std::shared_mutex>(itr->second->tilesLock);
     }
 }
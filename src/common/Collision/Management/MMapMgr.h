@@ -22,6 +22,9 @@
 #include "DetourAlloc.h"
 #include "DetourExtended.h"
 #include "DetourNavMesh.h"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -39,31 +42,34 @@ inline void dtCustomFree(void* ptr)
 //  move map related classes
 namespace MMAP
 {
-    typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    // loaded navmesh tile, shared by every map using the grid
+    struct MMapTile
+    {
+        dtTileRef tileRef;
+        uint32 refCount;
+    };
+
+    typedef std::unordered_map<uint32, MMapTile> MMapTileSet;
 
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) { }
+        MMapData(dtNavMesh* mesh, uint32 meshSerial) : navMesh(mesh), serial(meshSerial) { }
 
         ~MMapData()
         {
-            for (auto& navMeshQuerie : navMeshQueries)
-            {
-                dtFreeNavMeshQuery(navMeshQuerie.second);
-            }
-
             if (navMesh)
             {
                 dtFreeNavMesh(navMesh);
             }
         }
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries; // instanceId to query
         dtNavMesh* navMesh;
+        uint32 serial; // tells thread local queries of a freed navmesh apart from the ones of a new navmesh at the same address
         MMapTileSet loadedTileRefs; // maps [map grid coords] to [dtTile]
+
+        // adding and removing tiles rewrites the links of the neighbour tiles, queries hold it shared
+        std::shared_mutex tilesLock;
     };
 
     typedef std::unordered_map<uint32, MMapData*> MMapDataSet;
@@ -77,15 +83,19 @@ namespace MMAP
         ~MMapMgr();
 
         void InitializeThreadUnsafe(const std::vector<uint32>& mapIds);
+
+        // tiles are reference counted, every loadMap of a tile must be matched by an unloadMap
         bool loadMap(uint32 mapId, int32 x, int32 y);
         bool unloadMap(uint32 mapId, int32 x, int32 y);
         bool unloadMap(uint32 mapId);
-        bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-        // the returned [dtNavMeshQuery const*] is NOT threadsafe
-        dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+        // the returned [dtNavMeshQuery const*] belongs to the calling thread, it must not be handed to other threads
+        dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId);
         dtNavMesh const* GetNavMesh(uint32 mapId);
 
+        // hold while querying the navmesh, tiles are not added or removed meanwhile
+        [[nodiscard]] std::shared_lock<std::shared_mutex> LockNavMeshTiles(uint32 mapId);
+
         [[nodiscard]] uint32 getLoadedTilesCount() const { return loadedTiles; }
         [[nodiscard]] uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
 
@@ -95,8 +105,12 @@ namespace MMAP
         [[nodiscard]] MMapDataSet::const_iterator GetMMapData(uint32 mapId) const;
 
         MMapDataSet loadedMMaps;
-        uint32 loadedTiles{0};
+        std::atomic<uint32> loadedTiles{0};
+        uint32 nextMeshSerial{0};
         bool thread_safe_environment{true};
+
+        // tiles of different maps are loaded from different map update threads
+        std::mutex loadLock;
     };
 }
 
@@ -115,6 +115,22 @@ namespace VMAP
         return result;
     }
 
+    void VMapMgr2::preloadMapTile(const char* basePath, unsigned int mapId, int x, int y)
+    {
+        if (!isMapLoadingEnabled())
+        {
+            return;
+        }
+
+        std::string path = basePath;
+        if (!path.empty() && path.back() != '/' && path.back() != '\\')
+        {
+            path.push_back('/');
+        }
+
+        StaticMapTree::PreloadMapTile(path, mapId, x, y, this);
+    }
+
     // load one tile (internal use only)
     bool VMapMgr2::_loadMap(uint32 mapId, const std::string& basePath, uint32 tileX, uint32 tileY)
     {
@@ -101,6 +101,8 @@ namespace VMAP
 
         int loadMap(const char* pBasePath, unsigned int mapId, int x, int y) override;
 
+        // loads the models of a tile ahead of loadMap, may be called from any thread
+        void preloadMapTile(const char* basePath, unsigned int mapId, int x, int y);
         void unloadMap(unsigned int mapId, int x, int y) override;
         void unloadMap(unsigned int mapId) override;
 
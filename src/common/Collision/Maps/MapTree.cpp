@@ -466,6 +466,38 @@ namespace VMAP
 
     //=========================================================
 
+    bool StaticMapTree::PreloadMapTile(const std::string& basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapMgr2* vm)
+    {
+        std::string tilefile = basePath + getTileFileName(mapID, tileX, tileY);
+        FILE* tf = fopen(tilefile.c_str(), "rb");
+        if (!tf)
+        {
+            return false; // not tiled or no models in this tile
+        }
+
+        char chunk[8];
+        uint32 numSpawns = 0;
+        bool result = readChunk(tf, chunk, VMAP_MAGIC, 8) && fread(&numSpawns, sizeof(uint32), 1, tf) == 1;
+
+        for (uint32 i = 0; i < numSpawns && result; ++i)
+        {
+            ModelSpawn spawn;
+            uint32 referencedVal;
+            result = ModelSpawn::readFromFile(tf, spawn) && fread(&referencedVal, sizeof(uint32), 1, tf) == 1;
+
+            // LoadMapTile gets the already loaded model when the grid is created
+            if (result)
+            {
+                vm->acquireModelInstance(basePath, spawn.name, spawn.flags);
+            }
+        }
+
+        fclose(tf);
+        return result;
+    }
+
+    //=========================================================
+
     void StaticMapTree::UnloadMapTile(uint32 tileX, uint32 tileY, VMapMgr2* vm)
     {
         uint32 tileID = packTileID(tileX, tileY);
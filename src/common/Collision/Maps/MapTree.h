@@ -71,6 +71,8 @@ namespace VMAP
         static uint32 packTileID(uint32 tileX, uint32 tileY) { return tileX << 16 | tileY; }
         static void unpackTileID(uint32 ID, uint32& tileX, uint32& tileY) { tileX = ID >> 16; tileY = ID & 0xFF; }
         static LoadResult CanLoadMap(const std::string& basePath, uint32 mapID, uint32 tileX, uint32 tileY);
+        // Reads the model files referenced by a tile without touching any tree, safe from any thread
+        static bool PreloadMapTile(const std::string& basePath, uint32 mapID, uint32 tileX, uint32 tileY, VMapMgr2* vm);
 
         StaticMapTree(uint32 mapID, const std::string& basePath);
         ~StaticMapTree();
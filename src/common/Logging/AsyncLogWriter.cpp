@@ -0,0 +1,169 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "AsyncLogWriter.h"
+#include "Duration.h"
+#include "LogMessage.h"
+#include "StringFormat.h"
+
+namespace
+{
+    // Messages written between two channel flushes
+    constexpr std::size_t MAX_BATCH_SIZE = 512;
+
+    // Upper bound for a missed wake up, the writer never sleeps longer than this
+    constexpr Milliseconds WRITER_IDLE_SLEEP = 10ms;
+}
+
+Warhead::AsyncLogWriter::AsyncLogWriter(std::size_t queueSize, LogOverflowPolicy policy, WriteFn write, FlushFn flush) :
+    _queue(queueSize), _policy(policy), _write(std::move(write)), _flush(std::move(flush))
+{
+    _thread = std::thread(&AsyncLogWriter::WriterThread, this);
+}
+
+Warhead::AsyncLogWriter::~AsyncLogWriter()
+{
+    Stop();
+}
+
+bool Warhead::AsyncLogWriter::Push(std::unique_ptr<LogMessage>&& msg)
+{
+    // A channel logging from inside its own Write must not wait for itself
+    if (IsWriterThread())
+    {
+        _write(*msg);
+        return true;
+    }
+
+    // Announced before checking _stop, Stop() waits for it to be queued
+    ++_pushing;
+    if (_stop)
+    {
+        --_pushing;
+        return false;
+    }
+
+    // Counted before the enqueue, so the writer never goes to sleep while a message is on its way
+    ++_pushed;
+
+    while (!_queue.Enqueue(std::move(msg)))
+    {
+        switch (_policy)
+        {
+            case LogOverflowPolicy::DropOldest:
+            {
+                std::unique_ptr<LogMessage> oldest;
+                if (_queue.Dequeue(oldest))
+                {
+                    ++_dropped;
+                    ++_processed;
+                }
+                break;
+            }
+            case LogOverflowPolicy::DropNew:
+                ++_dropped;
+                ++_processed;
+                --_pushing;
+                return true;
+            default:
+                WakeUp();
+                std::this_thread::yield();
+                break;
+        }
+    }
+
+    --_pushing;
+
+    if (_sleeping)
+        WakeUp();
+
+    return true;
+}
+
+void Warhead::AsyncLogWriter::Stop()
+{
+    if (_stop.exchange(true))
+        return;
+
+    // the writer keeps running meanwhile, a blocked push gets its space
+    while (_pushing)
+    {
+        WakeUp();
+        std::this_thread::yield();
+    }
+
+    _exit = true;
+    WakeUp();
+
+    if (_thread.joinable())
+        _thread.join();
+}
+
+void Warhead::AsyncLogWriter::WakeUp()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _condition.notify_one();
+}
+
+void Warhead::AsyncLogWriter::WriterThread()
+{
+    uint64 reportedDrops = 0;
+
+    for (;;)
+    {
+        // read before the queue, once set every message is queued and an empty pass below is the last one
+        bool const exit = _exit;
+
+        std::size_t count = 0;
+        std::unique_ptr<LogMessage> msg;
+
+        while (count < MAX_BATCH_SIZE && _queue.Dequeue(msg))
+        {
+            _write(*msg);
+            msg.reset();
+            ++_processed;
+            ++count;
+        }
+
+        if (uint64 dropped = _dropped; dropped != reportedDrops)
+        {
+            _write(LogMessage("server", Warhead::StringFormat("AsyncLogWriter: log queue overflow, {} messages dropped", dropped - reportedDrops), LogLevel::Warning));
+            reportedDrops = dropped;
+            ++count;
+        }
+
+        if (count)
+        {
+            _flush();
+            continue;
+        }
+
+        if (exit)
+            break;
+
+        std::unique_lock<std::mutex> lock(_lock);
+        _sleeping = true;
+
+        if (_processed == _pushed && !_exit)
+            _condition.wait_for(lock, WRITER_IDLE_SLEEP);
+
+        _sleeping = false;
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WARHEAD_ASYNC_LOG_WRITER_H_
+#define _WARHEAD_ASYNC_LOG_WRITER_H_
+
+#include "LogCommon.h"
+#include "MPMCQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Warhead
+{
+    class LogMessage;
+
+    // Moves channel formatting and writing off the logging threads.
+    // Producers push already formatted messages into a bounded lock free queue, a single writer
+    // thread dispatches them in batches and flushes the channels once per batch.
+    class WH_COMMON_API AsyncLogWriter
+    {
+    public:
+        using WriteFn = std::function<void(LogMessage const&)>;
+        using FlushFn = std::function<void()>;
+
+        AsyncLogWriter(std::size_t queueSize, LogOverflowPolicy policy, WriteFn write, FlushFn flush);
+        ~AsyncLogWriter();
+
+        // False once the writer is stopped, msg is left to the caller then
+        bool Push(std::unique_ptr<LogMessage>&& msg);
+
+        // Writes every message pushed so far and ends the writer thread, later pushes fail. Not from the writer thread
+        void Stop();
+
+        bool IsWriterThread() const { return std::this_thread::get_id() == _thread.get_id(); }
+
+        inline std::size_t GetQueueSize() const { return _queue.GetSize(); }
+        inline uint64 GetDroppedMessages() const { return _dropped.load(std::memory_order_relaxed); }
+
+    private:
+        void WriterThread();
+        void WakeUp();
+
+        BoundedMPMCQueue<std::unique_ptr<LogMessage>> _queue;
+        LogOverflowPolicy _policy;
+        WriteFn _write;
+        FlushFn _flush;
+
+        std::atomic<uint64> _pushed{ 0 };
+        std::atomic<uint64> _processed{ 0 };
+        std::atomic<uint64> _dropped{ 0 };
+
+        std::atomic<bool> _stop{ false };     // no new pushes
+        std::atomic<uint32> _pushing{ 0 };    // pushes started before _stop
+        std::atomic<bool> _exit{ false };     // the last push is queued, the writer leaves once the queue is empty
+        std::atomic<bool> _sleeping{ false };
+        std::mutex _lock;
+        std::condition_variable _condition;
+        std::thread _thread;
+
+        AsyncLogWriter(AsyncLogWriter const&) = delete;
+        AsyncLogWriter& operator=(AsyncLogWriter const&) = delete;
+    };
+}
+
+#endif // _WARHEAD_ASYNC_LOG_WRITER_H_
@@ -214,12 +214,23 @@ void Warhead::FileChannel::Write(LogMessage const& msg)
         throw Exception("Cannot open file '{}'", _fileName);
 
     *_logFile << text;
-    _isFlush ? *_logFile << std::endl : *_logFile << "\n";
+    _isFlush && !IsDeferredFlush() ? *_logFile << std::endl : *_logFile << "\n";
 
     if (!_logFile->good())
         throw Exception("Incorrect write to file '{}'", _fileName);
 }
 
+void Warhead::FileChannel::Flush()
+{
+    if (!_isFlush)
+        return;
+
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    if (_logFile)
+        _logFile->flush();
+}
+
 bool Warhead::FileChannel::OpenFile()
 {
     if (_logFile)
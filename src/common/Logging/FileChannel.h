@@ -32,6 +32,7 @@ namespace Warhead
         ~FileChannel() override;
 
         void Write(LogMessage const& msg) override;
+        void Flush() override;
 
     private:
         bool OpenFile();
@@ -19,6 +19,7 @@
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 
 #include "Log.h"
+#include "AsyncLogWriter.h"
 #include "Config.h"
 #include "ConsoleChannel.h"
 #include "Errors.h"
@@ -52,6 +53,8 @@ Warhead::Log::Log()
 
 Warhead::Log::~Log()
 {
+    // Write out everything still queued before the channels go away
+    StopAsyncWriter();
     Clear();
 }
 
@@ -85,10 +88,57 @@ void Warhead::Log::LoadFromConfig()
 
     ASSERT(Warhead::File::CreateDirIfNeed(_logsDir));
 
+    // Queued messages point to the old loggers, drain them before the reload
+    StopAsyncWriter();
+
     Clear();
     //InitLogsDir();
     ReadChannelsFromConfig();
     ReadLoggersFromConfig();
+    InitAsyncWriter();
+}
+
+void Warhead::Log::InitAsyncWriter()
+{
+    bool const isAsync = sConfigMgr->GetOption<bool>("Log.Async.Enable", false, false);
+
+    for (auto const& [name, channel] : _channels)
+        channel->SetDeferredFlush(isAsync);
+
+    if (!isAsync)
+        return;
+
+    auto queueSize = sConfigMgr->GetOption<uint32>("Log.Async.QueueSize", 16384, false);
+    auto policy = sConfigMgr->GetOption<uint8>("Log.Async.OverflowPolicy", 0, false);
+
+    if (!queueSize)
+    {
+        fmt::print("Log::InitAsyncWriter: Log.Async.QueueSize can't be 0, set to 16384\n");
+        queueSize = 16384;
+    }
+
+    if (policy >= static_cast<uint8>(LogOverflowPolicy::Max))
+    {
+        fmt::print("Log::InitAsyncWriter: Incorrect Log.Async.OverflowPolicy ({}), set to 0\n", policy);
+        policy = 0;
+    }
+
+    _asyncWriter.store(std::make_shared<AsyncLogWriter>(queueSize, static_cast<LogOverflowPolicy>(policy),
+        [this](LogMessage const& msg) { WriteMessage(msg); },
+        [this]() { FlushChannels(); }), std::memory_order_release);
+}
+
+void Warhead::Log::StopAsyncWriter()
+{
+    std::shared_ptr<AsyncLogWriter> writer = _asyncWriter.exchange(nullptr, std::memory_order_acq_rel);
+    if (!writer)
+        return;
+
+    // Pushes racing with the swap are written before Stop returns, the ones after it are written synchronously
+    writer->Stop();
+
+    for (auto const& [name, channel] : _channels)
+        channel->SetDeferredFlush(false);
 }
 
 void Warhead::Log::ReadLoggersFromConfig()
@@ -253,6 +303,7 @@ void Warhead::Log::UsingDefaultLogs(bool value /*= true*/)
         return;
 
     // Clear all before create default
+    StopAsyncWriter();
     Clear();
 
     highestLogLevel = LogLevel::Debug;
@@ -340,11 +391,27 @@ void Warhead::Log::_OutCommand(uint32 accountID, std::string_view message)
 
 void Warhead::Log::Write(std::unique_ptr<LogMessage>&& msg)
 {
-    if (auto const& logger = GetLoggerByType(msg->GetSource()))
+    if (std::shared_ptr<AsyncLogWriter> writer = _asyncWriter.load(std::memory_order_acquire))
+    {
+        // A fatal message usually precedes an abort. Everything before it is written first and the writer thread
+        // is gone before it is written here, the following messages are written synchronously too.
+        // On the writer thread itself Push writes right away.
+        if (msg->GetLevel() == LogLevel::Fatal && !writer->IsWriterThread())
+            StopAsyncWriter();
+        else if (writer->Push(std::move(msg)))
+            return;
+    }
+
+    WriteMessage(*msg);
+}
+
+void Warhead::Log::WriteMessage(LogMessage const& msg)
+{
+    if (auto const& logger = GetLoggerByType(msg.GetSource()))
     {
         try
         {
-            logger->Write(*msg);
+            logger->Write(msg);
         }
         catch (const Exception& e)
         {
@@ -353,6 +420,35 @@ void Warhead::Log::Write(std::unique_ptr<LogMessage>&& msg)
     }
 }
 
+void Warhead::Log::FlushChannels()
+{
+    for (auto const& [name, channel] : _channels)
+        channel->Flush();
+}
+
+std::size_t Warhead::Log::GetAsyncQueueSize() const
+{
+    std::shared_ptr<AsyncLogWriter> writer = _asyncWriter.load(std::memory_order_acquire);
+    return writer ? writer->GetQueueSize() : 0;
+}
+
+uint64 Warhead::Log::GetDroppedMessages() const
+{
+    std::shared_ptr<AsyncLogWriter> writer = _asyncWriter.load(std::memory_order_acquire);
+    return writer ? writer->GetDroppedMessages() : 0;
+}
+
+std::vector<std::pair<std::string, uint64>> Warhead::Log::GetChannelsWrittenMessages()
+{
+    std::vector<std::pair<std::string, uint64>> result;
+    result.reserve(_channels.size());
+
+    for (auto const& [name, channel] : _channels)
+        result.emplace_back(name, channel->GetWrittenMessages());
+
+    return result;
+}
+
 void Warhead::Log::RegisterChannel(ChannelType type, ChannelCreateFn channelCreateFn)
 {
     ASSERT(type < ChannelType::Max);
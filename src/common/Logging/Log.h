@@ -19,12 +19,15 @@
 #define _LOG_H
 
 #include "LogCommon.h"
+#include <atomic>
 #include <fmt/format.h>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 namespace Warhead
 {
+    class AsyncLogWriter;
     class Logger;
     class LogChannel;
     class LogMessage;
@@ -82,12 +85,23 @@ namespace Warhead
 
         inline std::string_view GetLogsDir() { return _logsDir; }
 
+        // Async mode (Log.Async.Enable)
+        inline bool IsAsync() const { return _asyncWriter.load(std::memory_order_acquire) != nullptr; }
+        std::size_t GetAsyncQueueSize() const;
+        uint64 GetDroppedMessages() const;
+        std::vector<std::pair<std::string, uint64>> GetChannelsWrittenMessages();
+
         void UsingDefaultLogs(bool value = true);
 
     private:
         void _OutMessage(std::string_view filter, LogLevel level, std::string_view file, std::size_t line, std::string_view function, std::string_view message);
         void _OutCommand(uint32 accountID, std::string_view message);
         void Write(std::unique_ptr<LogMessage>&& msg);
+        void WriteMessage(LogMessage const& msg);
+        void FlushChannels();
+
+        void InitAsyncWriter();
+        void StopAsyncWriter();
 
         void CreateLoggerFromConfig(std::string_view configLoggerName);
         void CreateChannelsFromConfig(std::string_view logChannelName);
@@ -109,6 +123,9 @@ namespace Warhead
         LogLevel highestLogLevel{ LogLevel::Disabled };
         std::string _logsDir;
 
+        // swapped while other threads log, they keep the writer they loaded alive until their push returns
+        std::atomic<std::shared_ptr<AsyncLogWriter>> _asyncWriter;
+
         //
         bool _isUseDefaultLogs{ false };
     };
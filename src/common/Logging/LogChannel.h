@@ -19,6 +19,7 @@
 #define _WARHEAD_LOG_CHANNEL_H_
 
 #include "LogCommon.h"
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -43,6 +44,14 @@ namespace Warhead
         virtual void Write(LogMessage const& msg) = 0;
         virtual void SetRealmId(uint32 /*realmId*/) { }
 
+        // Called by the async log writer after each batch, channels with deferred flush push their buffers here
+        virtual void Flush() { }
+        inline void SetDeferredFlush(bool deferred) { _isDeferredFlush.store(deferred, std::memory_order_relaxed); }
+        inline bool IsDeferredFlush() const { return _isDeferredFlush.load(std::memory_order_relaxed); }
+
+        inline void AddWrittenMessage() { _writtenMessages.fetch_add(1, std::memory_order_relaxed); }
+        inline uint64 GetWrittenMessages() const { return _writtenMessages.load(std::memory_order_relaxed); }
+
     private:
         struct PatternAction
         {
@@ -63,6 +72,9 @@ namespace Warhead
         std::string _pattern;
         std::vector<PatternAction> _patternActions;
 
+        std::atomic<bool> _isDeferredFlush{ false }; // cleared while other threads write when the async writer stops
+        std::atomic<uint64> _writtenMessages{ 0 };
+
         LogChannel(const LogChannel&) = delete;
         LogChannel& operator= (const LogChannel&) = delete;
     };
@@ -74,6 +74,16 @@ namespace Warhead
         Max
     };
 
+    // What an asynchronous logger does when its queue is full
+    enum class LogOverflowPolicy : uint8
+    {
+        Block,      // wait for the writer thread to make room
+        DropOldest, // discard the oldest queued message
+        DropNew,    // discard the new message, only counting it
+
+        Max
+    };
+
     constexpr std::size_t MAX_LOG_LEVEL = static_cast<std::size_t>(LogLevel::Max);
     constexpr std::size_t MAX_CHANNEL_TYPE = static_cast<std::size_t>(ChannelType::Max);
     constexpr std::size_t MAX_CHANNEL_OPTIONS = 7;
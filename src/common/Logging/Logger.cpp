@@ -40,6 +40,7 @@ void Warhead::Logger::Write(LogMessage const& msg)
             continue;
 
         channel->Write(msg);
+        channel->AddWrittenMessage();
     }
 }
 
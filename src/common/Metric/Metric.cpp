@@ -155,6 +155,16 @@ void Metric::LogEvent(std::string const& category, std::string const& title, std
     _queuedData.Enqueue(data);
 }
 
+uint32 Metric::Register(MetricKind kind, std::string const& category, std::vector<MetricTag> const& tags /*= {}*/)
+{
+    std::string formattedTags;
+
+    for (MetricTag const& tag : tags)
+        formattedTags.append(",").append(tag.first).append("=").append(FormatInfluxDBTagValue(tag.second));
+
+    return _registry.Register(kind, category, formattedTags);
+}
+
 void Metric::SendBatch()
 {
     using namespace std::chrono;
@@ -193,6 +203,8 @@ void Metric::SendBatch()
         delete data;
     }
 
+    _registry.WriteAggregates(batchedData, _realmName, std::to_string(duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count()), firstLoop);
+
     // Check if there's any data to send
     if (batchedData.tellp() == std::streampos(0))
     {
@@ -22,6 +22,7 @@
 #include "Define.h"
 #include "Duration.h"
 #include "MPSCQueue.h"
+#include "MetricRegistry.h"
 #include <functional>
 #include <iosfwd>
 #include <memory>
@@ -70,6 +71,7 @@ private:
     std::function<void()> _overallStatusLogger;
     std::string _realmName;
     std::unordered_map<std::string, int64> _thresholds;
+    MetricRegistry _registry;
 
     bool Connect();
     void SendBatch();
@@ -119,12 +121,88 @@ public:
 
     void LogEvent(std::string const& category, std::string const& title, std::string const& description);
 
+    // Aggregated metrics, see MetricRegistry. Register once (startup, object creation) and keep the handle
+    uint32 Register(MetricKind kind, std::string const& category, std::vector<MetricTag> const& tags = {});
+    void Unregister(MetricKind kind, uint32 id) { _registry.Unregister(kind, id); }
+    MetricRegistry& GetRegistry() { return _registry; }
+
     void Unload();
     bool IsEnabled() const { return _enabled; }
 };
 
 #define sMetric Metric::instance()
 
+// Handles of registered metrics. Updating one never allocates and does nothing while metrics are disabled
+class MetricCounter
+{
+public:
+    MetricCounter() = default;
+    MetricCounter(std::string const& category, std::vector<MetricTag> const& tags = {}) :
+        _id(sMetric->Register(MetricKind::Counter, category, tags)) { }
+
+    void Add(uint64 value = 1) const
+    {
+#if !defined PERFORMANCE_PROFILING && !defined WITHOUT_METRICS
+        if (sMetric->IsEnabled())
+            sMetric->GetRegistry().AddCounter(_id, value);
+#endif
+    }
+
+private:
+    uint32 _id{ MetricRegistry::INVALID_ID };
+};
+
+class MetricGauge
+{
+public:
+    MetricGauge() = default;
+    MetricGauge(std::string const& category, std::vector<MetricTag> const& tags = {}) :
+        _id(sMetric->Register(MetricKind::Gauge, category, tags)) { }
+
+    ~MetricGauge() { sMetric->Unregister(MetricKind::Gauge, _id); }
+
+    MetricGauge(MetricGauge&& other) noexcept : _id(std::exchange(other._id, MetricRegistry::INVALID_ID)) { }
+    MetricGauge& operator=(MetricGauge&& other) noexcept
+    {
+        std::swap(_id, other._id);
+        return *this;
+    }
+
+    void Set(int64 value) const
+    {
+#if !defined PERFORMANCE_PROFILING && !defined WITHOUT_METRICS
+        if (sMetric->IsEnabled())
+            sMetric->GetRegistry().SetGauge(_id, value);
+#endif
+    }
+
+private:
+    uint32 _id{ MetricRegistry::INVALID_ID };
+};
+
+// Values are sent as count, p50, p99 and max of everything recorded since the last send
+class MetricHistogram
+{
+public:
+    MetricHistogram() = default;
+    MetricHistogram(std::string const& category, std::vector<MetricTag> const& tags = {}) :
+        _id(sMetric->Register(MetricKind::Histogram, category, tags)) { }
+
+    void Record(uint64 value) const
+    {
+#if !defined PERFORMANCE_PROFILING && !defined WITHOUT_METRICS
+        if (sMetric->IsEnabled())
+            sMetric->GetRegistry().RecordHistogram(_id, value);
+#endif
+    }
+
+    // Durations are recorded in microseconds
+    void Record(std::chrono::nanoseconds value) const { Record(uint64(std::chrono::duration_cast<Microseconds>(value).count())); }
+
+private:
+    uint32 _id{ MetricRegistry::INVALID_ID };
+};
+
 template<typename LoggerType>
 class MetricStopWatch
 {
@@ -165,6 +243,7 @@ MetricStopWatch<LoggerType> MakeMetricStopWatch(LoggerType&& loggerFunc)
 #define METRIC_DETAILED_EVENT(category, title, description) ((void)0)
 #define METRIC_DETAILED_TIMER(category, ...) ((void)0)
 #define METRIC_DETAILED_NO_THRESHOLD_TIMER(category, ...) ((void)0)
+#define METRIC_HISTOGRAM_TIMER(histogram) ((void)0)
 #else
 #if WARHEAD_PLATFORM != WARHEAD_PLATFORM_WINDOWS
 #define METRIC_EVENT(category, title, description)                  \
@@ -200,6 +279,11 @@ MetricStopWatch<LoggerType> MakeMetricStopWatch(LoggerType&& loggerFunc)
         {                                                                                                        \
             sMetric->LogValue(category, std::chrono::steady_clock::now() - start, { __VA_ARGS__ });              \
         });
+#define METRIC_HISTOGRAM_TIMER(histogram)                                                                     \
+        MetricStopWatch METRIC_UNIQUE_NAME(__ac_metric_stop_watch) = MakeMetricStopWatch([&](TimePoint start) \
+        {                                                                                                        \
+            (histogram).Record(std::chrono::steady_clock::now() - start);                                       \
+        });
 #if defined WITH_DETAILED_METRICS
 #define METRIC_DETAILED_TIMER(category, ...)                                                                  \
         MetricStopWatch METRIC_UNIQUE_NAME(__ac_metric_stop_watch) = MakeMetricStopWatch([&](TimePoint start) \
@@ -0,0 +1,318 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "MetricRegistry.h"
+#include "Errors.h"
+#include <bit>
+#include <ostream>
+
+namespace
+{
+    // Histogram buckets are powers of two, estimate the quantile inside the bucket linearly
+    uint64 GetHistogramQuantile(std::array<uint64, MetricRegistry::HISTOGRAM_BUCKETS> const& buckets, uint64 count, uint64 max, double quantile)
+    {
+        uint64 const rank = std::max<uint64>(uint64(double(count) * quantile), 1);
+        uint64 seen = 0;
+
+        for (std::size_t i = 0; i < buckets.size(); ++i)
+        {
+            if (!buckets[i] || seen + buckets[i] < rank)
+            {
+                seen += buckets[i];
+                continue;
+            }
+
+            if (!i)
+                return 0;
+
+            uint64 const lower = uint64(1) << (i - 1);
+            uint64 const upper = i + 1 < buckets.size() ? (uint64(1) << i) - 1 : max;
+            uint64 const value = lower + uint64(double(upper - lower) * double(rank - seen) / double(buckets[i]));
+            return std::min(value, max);
+        }
+
+        return max;
+    }
+}
+
+MetricRegistry::Shard::~Shard()
+{
+    for (auto& chunk : Counters)
+        delete chunk.load(std::memory_order_relaxed);
+
+    for (auto& chunk : Histograms)
+        delete chunk.load(std::memory_order_relaxed);
+}
+
+MetricRegistry::~MetricRegistry()
+{
+    for (auto& chunk : _gauges)
+        delete chunk.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+T& MetricRegistry::GetSlot(ChunkArray<T>& chunks, uint32 id)
+{
+    auto& chunkPtr = chunks[id / CHUNK_SIZE];
+
+    Chunk<T>* chunk = chunkPtr.load(std::memory_order_acquire);
+    if (!chunk)
+    {
+        chunk = new Chunk<T>();
+        chunkPtr.store(chunk, std::memory_order_release);
+    }
+
+    return chunk->Slots[id % CHUNK_SIZE];
+}
+
+template<typename T>
+T* MetricRegistry::FindSlot(ChunkArray<T> const& chunks, uint32 id)
+{
+    if (Chunk<T>* chunk = chunks[id / CHUNK_SIZE].load(std::memory_order_acquire))
+        return &chunk->Slots[id % CHUNK_SIZE];
+
+    return nullptr;
+}
+
+uint32 MetricRegistry::Register(MetricKind kind, std::string_view category, std::string_view tags)
+{
+    ASSERT(kind < MetricKind::Max);
+
+    std::string key{ category };
+    key.append(tags);
+
+    std::lock_guard<std::mutex> guard(_lock);
+
+    auto& definitions = _definitions[std::size_t(kind)];
+    auto& ids = _ids[std::size_t(kind)];
+
+    if (auto itr = ids.find(key); itr != ids.end())
+    {
+        ++definitions[itr->second].RefCount;
+        return itr->second;
+    }
+
+    uint32 id;
+    auto& freeIds = _freeIds[std::size_t(kind)];
+
+    if (!freeIds.empty())
+    {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else
+    {
+        if (definitions.size() >= CHUNK_SIZE * MAX_CHUNKS)
+            return INVALID_ID;
+
+        id = uint32(definitions.size());
+        definitions.emplace_back();
+    }
+
+    definitions[id].Key = key;
+    definitions[id].RefCount = 1;
+    ids.emplace(std::move(key), id);
+
+    // Gauges are written by any thread, so their chunk must exist before the id is handed out
+    if (kind == MetricKind::Gauge)
+        GetSlot(_gauges, id).store(GAUGE_NOT_SET, std::memory_order_relaxed);
+
+    return id;
+}
+
+void MetricRegistry::Unregister(MetricKind kind, uint32 id)
+{
+    ASSERT(kind == MetricKind::Gauge, "Only gauges can be unregistered");
+
+    if (id == INVALID_ID)
+        return;
+
+    std::lock_guard<std::mutex> guard(_lock);
+
+    auto& definition = _definitions[std::size_t(kind)][id];
+    if (!definition.RefCount || --definition.RefCount)
+        return;
+
+    _ids[std::size_t(kind)].erase(definition.Key);
+    definition.Key.clear();
+    _freeIds[std::size_t(kind)].push_back(id);
+}
+
+MetricRegistry::Shard& MetricRegistry::GetLocalShard()
+{
+    struct LocalShard
+    {
+        ~LocalShard()
+        {
+            if (Current)
+                Current->InUse = false;
+        }
+
+        Shard* Current{ nullptr };
+    };
+
+    thread_local LocalShard localShard;
+
+    if (localShard.Current)
+        return *localShard.Current;
+
+    std::lock_guard<std::mutex> guard(_lock);
+
+    // Reuse the shard of a finished thread, its totals stay valid
+    for (auto const& shard : _shards)
+    {
+        bool inUse = false;
+        if (shard->InUse.compare_exchange_strong(inUse, true))
+        {
+            localShard.Current = shard.get();
+            return *shard;
+        }
+    }
+
+    auto& shard = _shards.emplace_back(std::make_unique<Shard>());
+    shard->InUse = true;
+    localShard.Current = shard.get();
+    return *shard;
+}
+
+void MetricRegistry::AddCounter(uint32 id, uint64 value)
+{
+    if (id == INVALID_ID)
+        return;
+
+    GetSlot(GetLocalShard().Counters, id).fetch_add(value, std::memory_order_relaxed);
+}
+
+void MetricRegistry::SetGauge(uint32 id, int64 value)
+{
+    if (id == INVALID_ID)
+        return;
+
+    if (auto slot = FindSlot(_gauges, id))
+        slot->store(value, std::memory_order_relaxed);
+}
+
+void MetricRegistry::RecordHistogram(uint32 id, uint64 value)
+{
+    if (id == INVALID_ID)
+        return;
+
+    HistogramSlot& slot = GetSlot(GetLocalShard().Histograms, id);
+    slot.Buckets[std::min<std::size_t>(std::bit_width(value), HISTOGRAM_BUCKETS - 1)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64 max = slot.Max.load(std::memory_order_relaxed);
+    while (value > max && !slot.Max.compare_exchange_weak(max, value, std::memory_order_relaxed)) { }
+}
+
+void MetricRegistry::WriteAggregates(std::ostream& batch, std::string const& realmName, std::string const& timestamp, bool& firstLine)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    auto writeLine = [&](std::string const& key)
+    {
+        if (!firstLine)
+            batch << "\n";
+
+        firstLine = false;
+
+        std::size_t const categoryLength = key.find(',');
+        batch << std::string_view(key).substr(0, categoryLength);
+
+        if (!realmName.empty())
+            batch << ",realm=" << realmName;
+
+        if (categoryLength != std::string::npos)
+            batch << std::string_view(key).substr(categoryLength);
+
+        batch << " ";
+    };
+
+    auto const& counters = _definitions[std::size_t(MetricKind::Counter)];
+    for (uint32 id = 0; id < counters.size(); ++id)
+    {
+        uint64 total = 0;
+        bool found = false;
+
+        for (auto const& shard : _shards)
+        {
+            if (auto slot = FindSlot(shard->Counters, id))
+            {
+                total += slot->load(std::memory_order_relaxed);
+                found = true;
+            }
+        }
+
+        if (!found)
+            continue;
+
+        writeLine(counters[id].Key);
+        batch << "value=" << total << "i " << timestamp;
+    }
+
+    auto const& gauges = _definitions[std::size_t(MetricKind::Gauge)];
+    for (uint32 id = 0; id < gauges.size(); ++id)
+    {
+        if (!gauges[id].RefCount)
+            continue;
+
+        int64 value = GAUGE_NOT_SET;
+        if (auto slot = FindSlot(_gauges, id))
+            value = slot->load(std::memory_order_relaxed);
+
+        if (value == GAUGE_NOT_SET)
+            continue;
+
+        writeLine(gauges[id].Key);
+        batch << "value=" << value << "i " << timestamp;
+    }
+
+    auto const& histograms = _definitions[std::size_t(MetricKind::Histogram)];
+    for (uint32 id = 0; id < histograms.size(); ++id)
+    {
+        std::array<uint64, HISTOGRAM_BUCKETS> buckets{};
+        uint64 count = 0;
+        uint64 max = 0;
+
+        for (auto const& shard : _shards)
+        {
+            auto slot = FindSlot(shard->Histograms, id);
+            if (!slot)
+                continue;
+
+            for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+            {
+                uint64 const bucket = slot->Buckets[i].exchange(0, std::memory_order_relaxed);
+                buckets[i] += bucket;
+                count += bucket;
+            }
+
+            max = std::max(max, slot->Max.exchange(0, std::memory_order_relaxed));
+        }
+
+        if (!count)
+            continue;
+
+        writeLine(histograms[id].Key);
+        batch << "count=" << count << "i"
+              << ",p50=" << GetHistogramQuantile(buckets, count, max, 0.5) << "i"
+              << ",p99=" << GetHistogramQuantile(buckets, count, max, 0.99) << "i"
+              << ",max=" << max << "i " << timestamp;
+    }
+}
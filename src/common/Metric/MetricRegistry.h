@@ -0,0 +1,127 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef METRIC_REGISTRY_H__
+#define METRIC_REGISTRY_H__
+
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class MetricKind : uint8
+{
+    Counter,   // monotonic total, sent as is
+    Gauge,     // last set value
+    Histogram, // distribution of the values recorded since the previous send
+    Max
+};
+
+// Pre-registered metrics updated without allocations or locks.
+// Counters and histograms are written to per-thread shards that only the owning thread modifies,
+// gauges are a single shared slot. Metric::SendBatch collects everything as one line per metric.
+class WH_COMMON_API MetricRegistry
+{
+public:
+    static constexpr uint32 INVALID_ID = std::numeric_limits<uint32>::max();
+
+    // Bucket i holds values with bit width i (bucket 0 = 0, bucket 1 = 1, bucket 2 = 2..3, ...),
+    // the last one everything from 2^30 on
+    static constexpr std::size_t HISTOGRAM_BUCKETS = 32;
+
+    MetricRegistry() = default;
+    ~MetricRegistry();
+
+    // Same category and tags always return the same id. Gauges are reference counted and
+    // should be unregistered by their owner, counters and histograms live as long as the registry.
+    // tags is the already formatted tag part of the line (",key=value,...")
+    uint32 Register(MetricKind kind, std::string_view category, std::string_view tags);
+    void Unregister(MetricKind kind, uint32 id);
+
+    void AddCounter(uint32 id, uint64 value);
+    void SetGauge(uint32 id, int64 value);
+    void RecordHistogram(uint32 id, uint64 value);
+
+    // Appends one InfluxDB line per metric with data, histograms are reset by the call
+    void WriteAggregates(std::ostream& batch, std::string const& realmName, std::string const& timestamp, bool& firstLine);
+
+private:
+    static constexpr std::size_t CHUNK_SIZE = 64;
+    static constexpr std::size_t MAX_CHUNKS = 256;
+
+    struct HistogramSlot
+    {
+        std::array<std::atomic<uint64>, HISTOGRAM_BUCKETS> Buckets{};
+        std::atomic<uint64> Max{ 0 };
+    };
+
+    template<typename T>
+    struct Chunk
+    {
+        std::array<T, CHUNK_SIZE> Slots{};
+    };
+
+    // Slots are allocated in chunks on first use, the chunk arrays never move
+    template<typename T>
+    using ChunkArray = std::array<std::atomic<Chunk<T>*>, MAX_CHUNKS>;
+
+    struct Shard
+    {
+        ~Shard();
+
+        ChunkArray<std::atomic<uint64>> Counters{};
+        ChunkArray<HistogramSlot> Histograms{};
+        std::atomic<bool> InUse{ false };
+    };
+
+    struct Definition
+    {
+        std::string Key; // category followed by the formatted tags
+        uint32 RefCount{};
+    };
+
+    // Value of a gauge that was never set, such gauges are not sent
+    static constexpr int64 GAUGE_NOT_SET = std::numeric_limits<int64>::min();
+
+    template<typename T>
+    static T& GetSlot(ChunkArray<T>& chunks, uint32 id);
+
+    template<typename T>
+    static T* FindSlot(ChunkArray<T> const& chunks, uint32 id);
+
+    Shard& GetLocalShard();
+
+    std::mutex _lock;
+    std::array<std::vector<Definition>, std::size_t(MetricKind::Max)> _definitions;
+    std::array<std::vector<uint32>, std::size_t(MetricKind::Max)> _freeIds;
+    std::array<std::unordered_map<std::string, uint32>, std::size_t(MetricKind::Max)> _ids;
+    std::vector<std::unique_ptr<Shard>> _shards;
+
+    ChunkArray<std::atomic<int64>> _gauges{};
+
+    MetricRegistry(MetricRegistry const&) = delete;
+    MetricRegistry& operator=(MetricRegistry const&) = delete;
+};
+
+#endif // METRIC_REGISTRY_H__
@@ -0,0 +1,210 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WARHEAD_CONCURRENT_LOOKUP_MAP_H_
+#define _WARHEAD_CONCURRENT_LOOKUP_MAP_H_
+
+#include "EpochReclaimer.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace Warhead
+{
+    // Hash map for read mostly data shared between threads. Find never takes a lock and never waits:
+    // slots are atomic pointers to immutable nodes, replaced nodes and outgrown tables are freed
+    // through the EpochReclaimer. Writers are serialized by a mutex.
+    // Open addressing with linear probing, erased slots keep a tombstone until the next rehash.
+    template<class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+    class ConcurrentLookupMap
+    {
+        struct Node
+        {
+            Key NodeKey;
+            Value NodeValue;
+        };
+
+        using Slot = std::atomic<Node const*>;
+
+        struct Table
+        {
+            explicit Table(std::size_t capacity) : Slots(new Slot[capacity]), Mask(capacity - 1)
+            {
+                for (std::size_t i = 0; i < capacity; ++i)
+                    Slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+
+            std::unique_ptr<Slot[]> Slots;
+            std::size_t Mask;
+            std::size_t Used{}; // nodes and tombstones
+        };
+
+        static constexpr std::size_t MIN_CAPACITY = 64;
+
+    public:
+        ConcurrentLookupMap() : _table(new Table(MIN_CAPACITY)) { }
+
+        ~ConcurrentLookupMap()
+        {
+            Table* table = _table.load(std::memory_order_relaxed);
+
+            for (std::size_t i = 0; i <= table->Mask; ++i)
+                if (Node const* node = table->Slots[i].load(std::memory_order_relaxed); node && node != Tombstone())
+                    delete node;
+
+            delete table;
+        }
+
+        // Wait-free, returns notFound if there is no such key
+        Value Find(Key const& key, Value notFound = Value()) const
+        {
+            EpochGuard guard;
+
+            Table const* table = _table.load(std::memory_order_acquire);
+
+            for (std::size_t i = Hash{}(key), probes = 0; probes <= table->Mask; ++i, ++probes)
+            {
+                Node const* node = table->Slots[i & table->Mask].load(std::memory_order_acquire);
+                if (!node)
+                    break;
+
+                if (node != Tombstone() && KeyEqual{}(node->NodeKey, key))
+                    return node->NodeValue;
+            }
+
+            return notFound;
+        }
+
+        void InsertOrAssign(Key const& key, Value value)
+        {
+            std::lock_guard<std::mutex> guard(_writeLock);
+
+            Table* table = _table.load(std::memory_order_relaxed);
+
+            // Keep at least half of the slots empty, so probe sequences stay short
+            if ((table->Used + 1) * 2 > table->Mask + 1)
+                table = Rehash(table);
+
+            Slot* freeSlot = nullptr;
+
+            for (std::size_t i = Hash{}(key);; ++i)
+            {
+                Slot& slot = table->Slots[i & table->Mask];
+                Node const* node = slot.load(std::memory_order_relaxed);
+
+                if (!node)
+                {
+                    if (!freeSlot)
+                    {
+                        freeSlot = &slot;
+                        ++table->Used;
+                    }
+
+                    break;
+                }
+
+                if (node == Tombstone())
+                {
+                    if (!freeSlot)
+                        freeSlot = &slot;
+
+                    continue;
+                }
+
+                if (KeyEqual{}(node->NodeKey, key))
+                {
+                    slot.store(new Node{ key, value }, std::memory_order_release);
+                    EpochReclaimer::instance()->Retire(node);
+                    return;
+                }
+            }
+
+            freeSlot->store(new Node{ key, value }, std::memory_order_release);
+            ++_size;
+        }
+
+        bool Erase(Key const& key)
+        {
+            std::lock_guard<std::mutex> guard(_writeLock);
+
+            Table* table = _table.load(std::memory_order_relaxed);
+
+            for (std::size_t i = Hash{}(key), probes = 0; probes <= table->Mask; ++i, ++probes)
+            {
+                Slot& slot = table->Slots[i & table->Mask];
+                Node const* node = slot.load(std::memory_order_relaxed);
+                if (!node)
+                    break;
+
+                if (node != Tombstone() && KeyEqual{}(node->NodeKey, key))
+                {
+                    slot.store(Tombstone(), std::memory_order_release);
+                    EpochReclaimer::instance()->Retire(node);
+                    --_size;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    private:
+        static Node const* Tombstone()
+        {
+            static char const tombstone{};
+            return reinterpret_cast<Node const*>(&tombstone);
+        }
+
+        // Moves the live nodes to a new table, readers still probing the old one keep it alive
+        Table* Rehash(Table* oldTable)
+        {
+            std::size_t capacity = MIN_CAPACITY;
+            while (capacity < (_size + 1) * 4)
+                capacity *= 2;
+
+            auto newTable = new Table(capacity);
+
+            for (std::size_t i = 0; i <= oldTable->Mask; ++i)
+            {
+                Node const* node = oldTable->Slots[i].load(std::memory_order_relaxed);
+                if (!node || node == Tombstone())
+                    continue;
+
+                std::size_t index = Hash{}(node->NodeKey);
+                while (newTable->Slots[index & newTable->Mask].load(std::memory_order_relaxed))
+                    ++index;
+
+                newTable->Slots[index & newTable->Mask].store(node, std::memory_order_relaxed);
+                ++newTable->Used;
+            }
+
+            _table.store(newTable, std::memory_order_release);
+            EpochReclaimer::instance()->Retire(oldTable);
+            return newTable;
+        }
+
+        std::atomic<Table*> _table;
+        std::mutex _writeLock;
+        std::size_t _size{};
+
+        ConcurrentLookupMap(ConcurrentLookupMap const&) = delete;
+        ConcurrentLookupMap& operator=(ConcurrentLookupMap const&) = delete;
+    };
+}
+
+#endif
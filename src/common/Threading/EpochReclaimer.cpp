@@ -0,0 +1,137 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "EpochReclaimer.h"
+#include <algorithm>
+#include <limits>
+
+namespace Warhead
+{
+    struct alignas(64) EpochThreadRecord
+    {
+        std::atomic<uint64> Epoch{ 0 }; // 0 - not inside a guard
+        std::atomic<bool> InUse{ false };
+        uint32 Depth{ 0 };
+        EpochThreadRecord* Next{ nullptr };
+    };
+}
+
+namespace
+{
+    // Records are never freed, a record of a finished thread is taken over by the next new thread
+    struct ThreadRecordHolder
+    {
+        ~ThreadRecordHolder()
+        {
+            if (Record)
+                Record->InUse.store(false, std::memory_order_release);
+        }
+
+        Warhead::EpochThreadRecord* Record{ nullptr };
+    };
+
+    thread_local ThreadRecordHolder _threadRecord;
+}
+
+/*static*/ Warhead::EpochReclaimer* Warhead::EpochReclaimer::instance()
+{
+    static EpochReclaimer instance;
+    return &instance;
+}
+
+Warhead::EpochReclaimer::~EpochReclaimer()
+{
+    for (RetiredObject const& retired : _retired)
+        retired.Deleter(retired.Object);
+}
+
+Warhead::EpochThreadRecord* Warhead::EpochReclaimer::GetThreadRecord()
+{
+    if (_threadRecord.Record)
+        return _threadRecord.Record;
+
+    for (EpochThreadRecord* record = _records.load(std::memory_order_acquire); record; record = record->Next)
+    {
+        bool inUse = false;
+        if (record->InUse.compare_exchange_strong(inUse, true, std::memory_order_acq_rel))
+            return _threadRecord.Record = record;
+    }
+
+    auto record = new EpochThreadRecord();
+    record->InUse.store(true, std::memory_order_relaxed);
+    record->Next = _records.load(std::memory_order_relaxed);
+
+    while (!_records.compare_exchange_weak(record->Next, record, std::memory_order_release, std::memory_order_relaxed))
+        ;
+
+    return _threadRecord.Record = record;
+}
+
+void Warhead::EpochReclaimer::Enter()
+{
+    EpochThreadRecord* record = GetThreadRecord();
+    if (record->Depth++)
+        return;
+
+    record->Epoch.store(_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    // Pairs with the fence in Reclaim: either the writer sees this epoch or we see the unlinked state
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void Warhead::EpochReclaimer::Leave()
+{
+    EpochThreadRecord* record = _threadRecord.Record;
+    if (--record->Depth)
+        return;
+
+    record->Epoch.store(0, std::memory_order_release);
+}
+
+void Warhead::EpochReclaimer::Retire(void* object, void(*deleter)(void*))
+{
+    std::lock_guard<std::mutex> guard(_retiredLock);
+
+    // Readers entering from now on get a newer epoch and can't reach the object anymore
+    _retired.emplace_back(RetiredObject{ _epoch.fetch_add(1, std::memory_order_acq_rel), object, deleter });
+
+    Reclaim();
+}
+
+void Warhead::EpochReclaimer::Reclaim()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    uint64 oldestEpoch = std::numeric_limits<uint64>::max();
+
+    for (EpochThreadRecord* record = _records.load(std::memory_order_acquire); record; record = record->Next)
+        if (uint64 epoch = record->Epoch.load(std::memory_order_acquire))
+            oldestEpoch = std::min(oldestEpoch, epoch);
+
+    auto itr = std::partition(_retired.begin(), _retired.end(), [oldestEpoch](RetiredObject const& retired)
+    {
+        return retired.Epoch >= oldestEpoch;
+    });
+
+    for (auto deleteItr = itr; deleteItr != _retired.end(); ++deleteItr)
+        deleteItr->Deleter(deleteItr->Object);
+
+    _retired.erase(itr, _retired.end());
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WARHEAD_EPOCH_RECLAIMER_H_
+#define _WARHEAD_EPOCH_RECLAIMER_H_
+
+#include "Define.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace Warhead
+{
+    struct EpochThreadRecord;
+
+    // Epoch based memory reclamation for lock-free readers. A reader stays inside an EpochGuard while
+    // it uses objects of a shared structure, a writer unlinks an object and retires it. The object is
+    // deleted once every guard that could still have seen it is gone.
+    // Each thread publishes its epoch in its own cache line, so entering a guard never writes shared memory.
+    class WH_COMMON_API EpochReclaimer
+    {
+    public:
+        static EpochReclaimer* instance();
+
+        void Enter();
+        void Leave();
+
+        template<class T>
+        void Retire(T const* object)
+        {
+            Retire(const_cast<T*>(object), [](void* ptr) { delete static_cast<T*>(ptr); });
+        }
+
+        void Retire(void* object, void(*deleter)(void*));
+
+    private:
+        EpochReclaimer() = default;
+        ~EpochReclaimer();
+
+        struct RetiredObject
+        {
+            uint64 Epoch;
+            void* Object;
+            void(*Deleter)(void*);
+        };
+
+        EpochThreadRecord* GetThreadRecord();
+        void Reclaim();
+
+        std::atomic<uint64> _epoch{ 1 };
+        std::atomic<EpochThreadRecord*> _records{ nullptr };
+
+        std::mutex _retiredLock;
+        std::vector<RetiredObject> _retired;
+
+        EpochReclaimer(EpochReclaimer const&) = delete;
+        EpochReclaimer& operator=(EpochReclaimer const&) = delete;
+    };
+
+    class EpochGuard
+    {
+    public:
+        EpochGuard() { EpochReclaimer::instance()->Enter(); }
+        ~EpochGuard() { EpochReclaimer::instance()->Leave(); }
+
+        EpochGuard(EpochGuard const&) = delete;
+        EpochGuard& operator=(EpochGuard const&) = delete;
+    };
+}
+
+#endif
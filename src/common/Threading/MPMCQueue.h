@@ -0,0 +1,128 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MPMCQueue_h__
+#define MPMCQueue_h__
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Warhead
+{
+    // C++ implementation of Dmitry Vyukov's bounded lock free MPMC queue
+    // https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+    // Unlike MPSCQueue nothing is allocated per element, Enqueue simply fails when the queue is full
+    template<typename T>
+    class BoundedMPMCQueue
+    {
+    public:
+        // capacity is rounded up to the next power of two
+        explicit BoundedMPMCQueue(std::size_t capacity) :
+            _buffer(std::make_unique<Cell[]>(std::bit_ceil(std::max<std::size_t>(capacity, 2)))),
+            _mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1)
+        {
+            for (std::size_t i = 0; i <= _mask; ++i)
+                _buffer[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+
+        bool Enqueue(T&& input)
+        {
+            Cell* cell;
+            std::size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                cell = &_buffer[pos & _mask];
+                std::size_t seq = cell->Sequence.load(std::memory_order_acquire);
+                std::intptr_t diff = std::intptr_t(seq) - std::intptr_t(pos);
+
+                if (!diff)
+                {
+                    if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+
+            cell->Data = std::move(input);
+            cell->Sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool Dequeue(T& result)
+        {
+            Cell* cell;
+            std::size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                cell = &_buffer[pos & _mask];
+                std::size_t seq = cell->Sequence.load(std::memory_order_acquire);
+                std::intptr_t diff = std::intptr_t(seq) - std::intptr_t(pos + 1);
+
+                if (!diff)
+                {
+                    if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = _dequeuePos.load(std::memory_order_relaxed);
+            }
+
+            result = std::move(cell->Data);
+            cell->Sequence.store(pos + _mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline std::size_t GetCapacity() const { return _mask + 1; }
+
+        // Only a snapshot, other threads may change it at any moment
+        inline std::size_t GetSize() const
+        {
+            std::size_t dequeuePos = _dequeuePos.load(std::memory_order_relaxed);
+            std::size_t enqueuePos = _enqueuePos.load(std::memory_order_relaxed);
+            return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> Sequence;
+            T Data;
+        };
+
+        std::unique_ptr<Cell[]> _buffer;
+        std::size_t const _mask;
+
+        alignas(64) std::atomic<std::size_t> _enqueuePos{ 0 };
+        alignas(64) std::atomic<std::size_t> _dequeuePos{ 0 };
+
+        BoundedMPMCQueue(BoundedMPMCQueue const&) = delete;
+        BoundedMPMCQueue& operator=(BoundedMPMCQueue const&) = delete;
+    };
+}
+
+#endif // MPMCQueue_h__
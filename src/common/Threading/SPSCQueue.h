@@ -0,0 +1,101 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPSCQueue_h__
+#define SPSCQueue_h__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Bounded lock free ring for exactly one producer thread and one consumer thread
+template<typename T, std::size_t Capacity>
+class SPSCQueue
+{
+    static_assert(Capacity && !(Capacity & (Capacity - 1)), "SPSCQueue capacity must be a power of two");
+
+public:
+    SPSCQueue() = default;
+
+    //! Producer side, fails when the ring is full
+    bool Enqueue(T input)
+    {
+        std::size_t const head = _head.load(std::memory_order_relaxed);
+        if (head - _cachedTail == Capacity)
+        {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head - _cachedTail == Capacity)
+                return false;
+        }
+
+        _items[head & (Capacity - 1)] = std::move(input);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! Consumer side, the oldest element stays in the ring until Pop()
+    T* Peek()
+    {
+        std::size_t const tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _cachedHead)
+        {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail == _cachedHead)
+                return nullptr;
+        }
+
+        return &_items[tail & (Capacity - 1)];
+    }
+
+    //! Consumer side, only valid after Peek() returned an element
+    void Pop()
+    {
+        _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool Dequeue(T& result)
+    {
+        T* front = Peek();
+        if (!front)
+            return false;
+
+        result = std::move(*front);
+        Pop();
+        return true;
+    }
+
+    //! Approximate when called while the other side is running
+    std::size_t Size() const
+    {
+        std::size_t const tail = _tail.load(std::memory_order_acquire);
+        return _head.load(std::memory_order_acquire) - tail;
+    }
+
+private:
+    // producer and consumer indices live on separate cache lines, each side caches the other one
+    alignas(64) std::atomic<std::size_t> _head{ 0 };
+    std::size_t _cachedTail{ 0 };
+    alignas(64) std::atomic<std::size_t> _tail{ 0 };
+    std::size_t _cachedHead{ 0 };
+    alignas(64) std::array<T, Capacity> _items{ };
+
+    SPSCQueue(SPSCQueue const&) = delete;
+    SPSCQueue& operator=(SPSCQueue const&) = delete;
+};
+
+#endif // SPSCQueue_h__
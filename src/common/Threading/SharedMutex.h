@@ -0,0 +1,62 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WARHEAD_SHARED_MUTEX_H_
+#define _WARHEAD_SHARED_MUTEX_H_
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace Warhead
+{
+    // std::shared_mutex on glibc prefers readers, so a steady stream of shared owners can keep
+    // an exclusive owner waiting forever. Here every owner passes a gate first and an exclusive
+    // owner keeps the gate closed until it got the lock, new shared owners queue up behind it.
+    // Satisfies the SharedMutex requirements, use it with std::shared_lock / std::unique_lock.
+    class WriterPreferringSharedMutex
+    {
+    public:
+        WriterPreferringSharedMutex() = default;
+
+        void lock()
+        {
+            std::lock_guard<std::mutex> gate(_gate);
+            _mutex.lock();
+        }
+
+        bool try_lock() { return _mutex.try_lock(); }
+        void unlock() { _mutex.unlock(); }
+
+        void lock_shared()
+        {
+            std::lock_guard<std::mutex> gate(_gate);
+            _mutex.lock_shared();
+        }
+
+        bool try_lock_shared() { return _mutex.try_lock_shared(); }
+        void unlock_shared() { _mutex.unlock_shared(); }
+
+    private:
+        std::mutex _gate;
+        std::shared_mutex _mutex;
+
+        WriterPreferringSharedMutex(WriterPreferringSharedMutex const&) = delete;
+        WriterPreferringSharedMutex& operator=(WriterPreferringSharedMutex const&) = delete;
+    };
+}
+
+#endif
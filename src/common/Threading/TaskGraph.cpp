@@ -0,0 +1,103 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "TaskGraph.h"
+#include "Errors.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+Warhead::TaskGraph::TaskId Warhead::TaskGraph::Add(std::string_view name, std::function<void()> task, std::initializer_list<TaskId> dependencies /*= {}*/)
+{
+    TaskId id = _tasks.size();
+
+    for (TaskId dependency : dependencies)
+    {
+        ASSERT(dependency < id, "Task '{}' depends on a task added after it", name);
+        _tasks[dependency].Dependents.emplace_back(id);
+    }
+
+    Task& newTask = _tasks.emplace_back();
+    newTask.Name = name;
+    newTask.Function = std::move(task);
+    newTask.DependencyCount = dependencies.size();
+    return id;
+}
+
+void Warhead::TaskGraph::Run(std::size_t numThreads)
+{
+    // Insertion order is always a valid order
+    if (numThreads <= 1 || _tasks.size() <= 1)
+    {
+        for (Task& task : _tasks)
+            task.Function();
+
+        return;
+    }
+
+    auto pendingDependencies = std::make_unique<std::atomic<std::size_t>[]>(_tasks.size());
+    for (std::size_t i = 0; i < _tasks.size(); ++i)
+        pendingDependencies[i].store(_tasks[i].DependencyCount, std::memory_order_relaxed);
+
+    ThreadPool pool(numThreads);
+    std::exception_ptr error;
+    std::mutex errorLock;
+    std::atomic<bool> failed{ false };
+
+    std::function<void(TaskId)> schedule = [&](TaskId id)
+    {
+        pool.PostWork([&, id]()
+        {
+            // Don't start anything new once a task failed, the caller gets the first error
+            if (failed.load(std::memory_order_acquire))
+                return;
+
+            try
+            {
+                _tasks[id].Function();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!error)
+                    error = std::current_exception();
+
+                failed.store(true, std::memory_order_release);
+                return;
+            }
+
+            // The last finished dependency starts the dependent task
+            for (TaskId dependent : _tasks[id].Dependents)
+                if (pendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    schedule(dependent);
+        });
+    };
+
+    for (TaskId id = 0; id < _tasks.size(); ++id)
+        if (!_tasks[id].DependencyCount)
+            schedule(id);
+
+    pool.Wait();
+
+    if (error)
+        std::rethrow_exception(error);
+}
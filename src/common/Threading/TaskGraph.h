@@ -0,0 +1,59 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WARHEAD_TASK_GRAPH_H_
+#define _WARHEAD_TASK_GRAPH_H_
+
+#include "Define.h"
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Warhead
+{
+    // Set of tasks with explicit ordering constraints. A task is started once all of its
+    // dependencies are finished, independent tasks run at the same time on a thread pool.
+    // Dependencies must be added before the tasks depending on them, so the graph can't have cycles
+    class WH_COMMON_API TaskGraph
+    {
+    public:
+        using TaskId = std::size_t;
+
+        TaskId Add(std::string_view name, std::function<void()> task, std::initializer_list<TaskId> dependencies = {});
+
+        // Runs every task once and returns when all of them are done.
+        // With a single thread the tasks are executed in the order they were added
+        void Run(std::size_t numThreads);
+
+        std::size_t GetSize() const { return _tasks.size(); }
+
+    private:
+        struct Task
+        {
+            std::string Name;
+            std::function<void()> Function;
+            std::vector<TaskId> Dependents;
+            std::size_t DependencyCount{};
+        };
+
+        std::vector<Task> _tasks;
+    };
+}
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "EventMap.h"
 #include "Random.h"
+#include <algorithm>
 
 void EventMap::Reset()
 {
@@ -68,7 +69,7 @@ void EventMap::ScheduleEvent(uint32 eventId, uint32 time, uint32 group /*= 0*/,
         eventId |= (1 << (phase + 23));
     }
 
-    _eventMap.emplace(_time + time, eventId);
+    InsertEvent(_time + time, eventId);
 }
 
 void EventMap::ScheduleEvent(uint32 eventId, Milliseconds time, uint32 group /*= 0*/, uint8 phase /* = 0*/)
@@ -101,7 +102,7 @@ void EventMap::RescheduleEvent(uint32 eventId, Milliseconds minTime, Millisecond
 
 void EventMap::RepeatEvent(uint32 time)
 {
-    _eventMap.emplace(_time + time, _lastEvent);
+    InsertEvent(_time + time, _lastEvent);
 }
 
 void EventMap::Repeat(Milliseconds time)
@@ -118,22 +119,19 @@ uint32 EventMap::ExecuteEvent()
 {
     while (!Empty())
     {
-        auto const& itr = _eventMap.begin();
+        EventEntry const next = _eventMap.back();
 
-        if (itr->first > _time)
+        if (next.first > _time)
         {
             return 0;
         }
-        else if (_phase && (itr->second & 0xFF000000) && !((itr->second >> 24) & _phase))
-        {
-            _eventMap.erase(itr);
-        }
-        else
+
+        _eventMap.pop_back();
+
+        if (!_phase || !(next.second & 0xFF000000) || ((next.second >> 24) & _phase))
         {
-            uint32 eventId = (itr->second & 0x0000FFFF);
-            _lastEvent = itr->second;
-            _eventMap.erase(itr);
-            return eventId;
+            _lastEvent = next.second;
+            return (next.second & 0x0000FFFF);
         }
     }
 
@@ -150,19 +148,55 @@ void EventMap::DelayEvents(Milliseconds delay)
     DelayEvents(delay.count());
 }
 
+void EventMap::DelayEvents(uint32 delay, uint32 group)
+{
+    if (group > 8 || Empty())
+    {
+        return;
+    }
+
+    // in execution order, so the delayed events keep their order
+    EventStore delayed;
+    for (auto itr = _eventMap.rbegin(); itr != _eventMap.rend(); ++itr)
+    {
+        if (!group || (itr->second & (1 << (group + 15))))
+        {
+            delayed.emplace_back(itr->first + delay, itr->second);
+        }
+    }
+
+    _eventMap.erase(std::remove_if(_eventMap.begin(), _eventMap.end(), [group](EventEntry const& event)
+    {
+        return !group || (event.second & (1 << (group + 15)));
+    }), _eventMap.end());
+
+    for (EventEntry const& event : delayed)
+    {
+        InsertEvent(event.first, event.second);
+    }
+}
+
 void EventMap::DelayEventsToMax(uint32 delay, uint32 group)
 {
-    for (auto itr = _eventMap.begin(); itr != _eventMap.end();)
+    auto delayedToMax = [this, delay, group](EventEntry const& event)
     {
-        if (itr->first < _time + delay && (group == 0 || ((1 << (group + 15)) & itr->second)))
+        return event.first < _time + delay && (group == 0 || ((1 << (group + 15)) & event.second));
+    };
+
+    EventStore delayed;
+    for (auto itr = _eventMap.rbegin(); itr != _eventMap.rend(); ++itr)
+    {
+        if (delayedToMax(*itr))
         {
-            ScheduleEvent(itr->second, delay);
-            _eventMap.erase(itr);
-            itr = _eventMap.begin();
-            continue;
+            delayed.push_back(*itr);
         }
+    }
+
+    _eventMap.erase(std::remove_if(_eventMap.begin(), _eventMap.end(), delayedToMax), _eventMap.end());
 
-        ++itr;
+    for (EventEntry const& event : delayed)
+    {
+        ScheduleEvent(event.second, delay);
     }
 }
 
@@ -173,16 +207,10 @@ void EventMap::CancelEvent(uint32 eventId)
         return;
     }
 
-    for (auto itr = _eventMap.begin(); itr != _eventMap.end();)
+    _eventMap.erase(std::remove_if(_eventMap.begin(), _eventMap.end(), [eventId](EventEntry const& event)
     {
-        if (eventId == (itr->second & 0x0000FFFF))
-        {
-            itr = _eventMap.erase(itr);
-            continue;
-        }
-
-        ++itr;
-    }
+        return eventId == (event.second & 0x0000FFFF);
+    }), _eventMap.end());
 }
 
 void EventMap::CancelEventGroup(uint32 group)
@@ -193,17 +221,10 @@ void EventMap::CancelEventGroup(uint32 group)
     }
 
     uint32 groupMask = (1 << (group + 15));
-    for (EventStore::iterator itr = _eventMap.begin(); itr != _eventMap.end();)
+    _eventMap.erase(std::remove_if(_eventMap.begin(), _eventMap.end(), [groupMask](EventEntry const& event)
     {
-        if (itr->second & groupMask)
-        {
-            _eventMap.erase(itr);
-            itr = _eventMap.begin();
-            continue;
-        }
-
-        ++itr;
-    }
+        return (event.second & groupMask) != 0;
+    }), _eventMap.end());
 }
 
 uint32 EventMap::GetNextEventTime(uint32 eventId) const
@@ -213,11 +234,11 @@ uint32 EventMap::GetNextEventTime(uint32 eventId) const
         return 0;
     }
 
-    for (auto const& itr : _eventMap)
+    for (auto itr = _eventMap.rbegin(); itr != _eventMap.rend(); ++itr)
     {
-        if (eventId == (itr.second & 0x0000FFFF))
+        if (eventId == (itr->second & 0x0000FFFF))
         {
-            return itr.first;
+            return itr->first;
         }
     }
 
@@ -226,7 +247,7 @@ uint32 EventMap::GetNextEventTime(uint32 eventId) const
 
 uint32 EventMap::GetNextEventTime() const
 {
-    return Empty() ? 0 : _eventMap.begin()->first;
+    return Empty() ? 0 : _eventMap.back().first;
 }
 
 bool EventMap::IsInPhase(uint8 phase)
@@ -236,9 +257,20 @@ bool EventMap::IsInPhase(uint8 phase)
 
 Milliseconds EventMap::GetTimeUntilEvent(uint32 eventId) const
 {
-    for (std::pair<uint32 const, uint32> const& itr : _eventMap)
-        if (eventId == (itr.second & 0x0000FFFF))
-            return std::chrono::duration_cast<Milliseconds>(Milliseconds(itr.first) - Milliseconds(_time));
+    for (auto itr = _eventMap.rbegin(); itr != _eventMap.rend(); ++itr)
+        if (eventId == (itr->second & 0x0000FFFF))
+            return std::chrono::duration_cast<Milliseconds>(Milliseconds(itr->first) - Milliseconds(_time));
 
     return Milliseconds::max();
 }
+
+void EventMap::InsertEvent(uint32 time, uint32 data)
+{
+    // first event not later than the new one, everything from there on executes before it
+    auto itr = std::lower_bound(_eventMap.begin(), _eventMap.end(), time, [](EventEntry const& event, uint32 eventTime)
+    {
+        return event.first > eventTime;
+    });
+
+    _eventMap.emplace(itr, time, data);
+}
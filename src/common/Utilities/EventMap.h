@@ -20,22 +20,27 @@
 
 #include "Define.h"
 #include "Duration.h"
-#include <map>
+#include <boost/container/small_vector.hpp>
 
 class WH_COMMON_API EventMap
 {
     /**
     * Internal storage type.
-    * Key: Time as TimePoint when the event should occur.
-    * Value: The event data as uint32.
+    * First: Time as TimePoint when the event should occur.
+    * Second: The event data as uint32.
     *
     * Structure of event data:
     * - Bit  0 - 15: Event Id.
     * - Bit 16 - 23: Group
     * - Bit 24 - 31: Phase
     * - Pattern: 0xPPGGEEEE
+    *
+    * Sorted by descending time, the next event is at the back.
+    * Events of the same time keep their scheduling order.
+    * Most scripts have only a few events, they fit the inline buffer without any allocation.
     */
-    typedef std::multimap<uint32, uint32> EventStore;
+    typedef std::pair<uint32, uint32> EventEntry;
+    typedef boost::container::small_vector<EventEntry, 8> EventStore;
 
 public:
     EventMap() { }
@@ -231,29 +236,7 @@ public:
     * @param delay Amount of delay.
     * @param group Group of the events.
     */
-    void DelayEvents(uint32 delay, uint32 group)
-    {
-        if (group > 8 || Empty())
-        {
-            return;
-        }
-
-        EventStore delayed;
-
-        for (EventStore::iterator itr = _eventMap.begin(); itr != _eventMap.end();)
-        {
-            if (!group || (itr->second & (1 << (group + 15))))
-            {
-                delayed.insert(EventStore::value_type(itr->first + delay, itr->second));
-                itr = _eventMap.erase(itr);
-                continue;
-            }
-
-            ++itr;
-        }
-
-        _eventMap.insert(delayed.begin(), delayed.end());
-    }
+    void DelayEvents(uint32 delay, uint32 group);
 
     // DelayEventsToMax
     void DelayEventsToMax(uint32 delay, uint32 group);
@@ -303,6 +286,14 @@ public:
     Milliseconds GetTimeUntilEvent(uint32 eventId) const;
 
 private:
+    /**
+    * @name InsertEvent
+    * @brief Inserts the event after all events scheduled for the same time.
+    * @param time Time of the event.
+    * @param data Event data, see EventStore.
+    */
+    void InsertEvent(uint32 time, uint32 data);
+
     /**
     * @name _time
     * @brief Internal timer.
@@ -20,6 +20,7 @@
 
 #include "EventProcessor.h"
 #include "Errors.h"
+#include <algorithm>
 
 void BasicEvent::ScheduleAbort()
 {
@@ -46,12 +47,11 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_events.empty() && m_events.back().first <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* event = i->second;
-        m_events.erase(i);
+        BasicEvent* event = m_events.back().second;
+        m_events.pop_back();
 
         if (event->IsRunning())
         {
@@ -84,34 +84,32 @@ void EventProcessor::Update(uint32 p_time)
 
 void EventProcessor::KillAllEvents(bool force)
 {
+    // Abort handlers may add events, don't iterate the container they are added to
+    EventList events;
+    events.swap(m_events);
+
     // first, abort all existing events
-    for (auto itr = m_events.begin(); itr != m_events.end();)
+    for (auto itr = events.rbegin(); itr != events.rend(); ++itr)
     {
+        BasicEvent* event = itr->second;
+
         // Abort events which weren't aborted already
-        if (!itr->second->IsAborted())
+        if (!event->IsAborted())
         {
-            itr->second->SetAborted();
-            itr->second->Abort(m_time);
+            event->SetAborted();
+            event->Abort(m_time);
         }
 
-        // Skip non-deletable events when we are
+        // Keep non-deletable events when we are
         // not forcing the event cancellation.
-        if (!force && !itr->second->IsDeletable())
+        if (!force && !event->IsDeletable())
         {
-            ++itr;
+            InsertEvent(itr->first, event);
             continue;
         }
 
-        delete itr->second;
-
-        if (force)
-            ++itr; // Clear the whole container when forcing
-        else
-            itr = m_events.erase(itr);
+        delete event;
     }
-
-    if (force)
-        m_events.clear();
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -119,21 +117,33 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
     if (set_addtime)
         Event->m_addTime = m_time;
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    InsertEvent(e_time, Event);
 }
 
 void EventProcessor::ModifyEventTime(BasicEvent* event, Milliseconds newTime)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
+    auto itr = std::find_if(m_events.begin(), m_events.end(), [event](EventList::value_type const& scheduled)
     {
-        if (itr->second != event)
-            continue;
+        return scheduled.second == event;
+    });
 
-        event->m_execTime = newTime.count();
-        m_events.erase(itr);
-        m_events.insert(std::pair<uint64, BasicEvent*>(newTime.count(), event));
-        break;
-    }
+    if (itr == m_events.end())
+        return;
+
+    event->m_execTime = newTime.count();
+    m_events.erase(itr);
+    InsertEvent(newTime.count(), event);
+}
+
+void EventProcessor::InsertEvent(uint64 e_time, BasicEvent* event)
+{
+    // first event not later than the new one, everything from there on executes before it
+    auto itr = std::lower_bound(m_events.begin(), m_events.end(), e_time, [](EventList::value_type const& scheduled, uint64 time)
+    {
+        return scheduled.first > time;
+    });
+
+    m_events.emplace(itr, e_time, event);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
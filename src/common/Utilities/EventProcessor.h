@@ -19,8 +19,8 @@
 #define __EVENTPROCESSOR_H
 
 #include "Random.h"
-#include <map>
 #include <type_traits>
+#include <vector>
 
 class EventProcessor;
 
@@ -85,7 +85,9 @@ private:
 template<typename T>
 using is_lambda_event = std::enable_if_t<!std::is_base_of_v<BasicEvent, std::remove_pointer_t<std::remove_cvref_t<T>>>>;
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+// Sorted by descending execution time, the next event is at the back. Events of the same time keep their order.
+// The vector keeps its capacity, adding and executing events doesn't allocate once it has grown to the usual event count.
+typedef std::vector<std::pair<uint64, BasicEvent*>> EventList;
 
 class WH_COMMON_API EventProcessor
 {
@@ -111,6 +113,8 @@ public:
     [[nodiscard]] uint64 CalculateQueueTime(uint64 delay) const;
 
 protected:
+    void InsertEvent(uint64 e_time, BasicEvent* event);
+
     uint64 m_time{0};
     EventList m_events;
     bool m_aborting;
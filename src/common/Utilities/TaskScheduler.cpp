@@ -20,6 +20,7 @@
 
 #include "TaskScheduler.h"
 #include "Errors.h"
+#include <algorithm>
 
 TaskScheduler& TaskScheduler::ClearValidator()
 {
@@ -124,19 +125,19 @@ void TaskScheduler::Dispatch(success_t const& callback)
 
 void TaskScheduler::TaskQueue::Push(TaskContainer&& task)
 {
-    container.insert(task);
+    Insert(std::move(task));
 }
 
 auto TaskScheduler::TaskQueue::Pop() -> TaskContainer
 {
-    TaskContainer result = *container.begin();
-    container.erase(container.begin());
+    TaskContainer result = std::move(container.back());
+    container.pop_back();
     return result;
 }
 
 auto TaskScheduler::TaskQueue::First() const -> TaskContainer const&
 {
-    return *container.begin();
+    return container.back();
 }
 
 void TaskScheduler::TaskQueue::Clear()
@@ -146,32 +147,23 @@ void TaskScheduler::TaskQueue::Clear()
 
 void TaskScheduler::TaskQueue::RemoveIf(std::function<bool(TaskContainer const&)> const& filter)
 {
-    for (auto itr = container.begin(); itr != container.end();)
-        if (filter(*itr))
-        {
-            itr = container.erase(itr);
-        }
-        else
-        {
-            ++itr;
-        }
+    container.erase(std::remove_if(container.begin(), container.end(), filter), container.end());
 }
 
 void TaskScheduler::TaskQueue::ModifyIf(std::function<bool(TaskContainer const&)> const& filter)
 {
+    // in execution order, so the modified tasks keep their order
     std::vector<TaskContainer> cache;
-    for (auto itr = container.begin(); itr != container.end();)
+    for (auto itr = container.rbegin(); itr != container.rend(); ++itr)
         if (filter(*itr))
         {
-            cache.push_back(*itr);
-            itr = container.erase(itr);
-        }
-        else
-        {
-            ++itr;
+            cache.push_back(std::move(*itr));
         }
 
-    container.insert(cache.begin(), cache.end());
+    container.erase(std::remove(container.begin(), container.end(), nullptr), container.end());
+
+    for (TaskContainer& task : cache)
+        Insert(std::move(task));
 }
 
 bool TaskScheduler::TaskQueue::IsEmpty() const
@@ -179,14 +171,15 @@ bool TaskScheduler::TaskQueue::IsEmpty() const
     return container.empty();
 }
 
-TaskContext& TaskContext::Dispatch(std::function<TaskScheduler&(TaskScheduler&)> const& apply)
+void TaskScheduler::TaskQueue::Insert(TaskContainer&& task)
 {
-    if (auto const owner = _owner.lock())
+    // first task not ending later than the new one, everything from there on is executed before it
+    auto itr = std::lower_bound(container.begin(), container.end(), task->_end, [](TaskContainer const& scheduled, timepoint_t const& end)
     {
-        apply(*owner);
-    }
+        return scheduled->_end > end;
+    });
 
-    return *this;
+    container.insert(itr, std::move(task));
 }
 
 bool TaskContext::IsExpired() const
@@ -240,7 +233,7 @@ void TaskContext::AssertOnConsumed() const
 {
     // This was adapted to TC to prevent static analysis tools from complaining.
     // If you encounter this assertion check if you repeat a TaskContext more then 1 time!
-    ASSERT(!(*_consumed) && "Bad task logic, task context was consumed already!");
+    ASSERT(_task && _dispatchId == _task->_dispatchId && !_task->_consumed && "Bad task logic, task context was consumed already!");
 }
 
 void TaskContext::Invoke()
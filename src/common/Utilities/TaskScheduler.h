@@ -24,7 +24,6 @@
 #include <memory>
 #include <optional>
 #include <queue>
-#include <set>
 #include <utility>
 #include <vector>
 
@@ -74,15 +73,19 @@ class WH_COMMON_API TaskScheduler
         repeated_t _repeated;
         task_handler_t _task;
 
+        // Invocation the TaskContext's of the task were created for and whether one of them repeated it already
+        uint32 _dispatchId;
+        bool _consumed;
+
     public:
         // All Argument construct
         Task(timepoint_t const& end, duration_t const& duration, std::optional<group_t> const& group,
              repeated_t const repeated, task_handler_t const& task)
-            : _end(end), _duration(duration), _group(group), _repeated(repeated), _task(task) { }
+            : _end(end), _duration(duration), _group(group), _repeated(repeated), _task(task), _dispatchId(0), _consumed(true) { }
 
         // Minimal Argument construct
         Task(timepoint_t const& end, duration_t const& duration, task_handler_t const& task)
-            : _end(end), _duration(duration), _group(std::nullopt), _repeated(0), _task(task) { }
+            : _end(end), _duration(duration), _group(std::nullopt), _repeated(0), _task(task), _dispatchId(0), _consumed(true) { }
 
         // Copy construct
         Task(Task const&) = delete;
@@ -119,18 +122,85 @@ class WH_COMMON_API TaskScheduler
 
     typedef std::shared_ptr<Task> TaskContainer;
 
-    /// Container which provides Task order, insert and reschedule operations.
-    struct Compare
+    /// Keeps the memory of finished tasks (and their shared_ptr control block) of the thread for the next scheduled task.
+    template<typename T>
+    class TaskAllocator
     {
-        bool operator() (TaskContainer const& left, TaskContainer const& right) const
+        // Blocks exceeding it are freed, schedulers of a map thread rarely hold more tasks at once
+        static constexpr std::size_t MAX_FREE_BLOCKS = 1024;
+
+        struct FreeBlocks
         {
-            return (*left.get()) < (*right.get());
+            std::vector<T*> blocks;
+
+            ~FreeBlocks()
+            {
+                for (T* block : blocks)
+                    std::allocator<T>().deallocate(block, 1);
+
+                blocks.clear();
+                Destroyed = true;
+            }
         };
+
+        // Static singletons own schedulers and outlive the thread_local objects of the main thread,
+        // tasks they release afterwards bypass the free blocks. Trivially destructible, so still readable then.
+        static inline thread_local bool Destroyed = false;
+
+        static FreeBlocks* GetFreeBlocks()
+        {
+            if (Destroyed)
+                return nullptr;
+
+            thread_local FreeBlocks freeBlocks;
+            return &freeBlocks;
+        }
+
+    public:
+        typedef T value_type;
+
+        TaskAllocator() = default;
+
+        template<typename U>
+        TaskAllocator(TaskAllocator<U> const&) { }
+
+        T* allocate(std::size_t n)
+        {
+            FreeBlocks* freeBlocks = GetFreeBlocks();
+            if (n == 1 && freeBlocks && !freeBlocks->blocks.empty())
+            {
+                T* block = freeBlocks->blocks.back();
+                freeBlocks->blocks.pop_back();
+                return block;
+            }
+
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* block, std::size_t n)
+        {
+            FreeBlocks* freeBlocks = GetFreeBlocks();
+            if (n == 1 && freeBlocks && freeBlocks->blocks.size() < MAX_FREE_BLOCKS)
+            {
+                freeBlocks->blocks.push_back(block);
+                return;
+            }
+
+            std::allocator<T>().deallocate(block, n);
+        }
+
+        template<typename U>
+        bool operator== (TaskAllocator<U> const&) const { return true; }
     };
 
+    /// Container which provides Task order, insert and reschedule operations.
+    /// Sorted by descending end, the next task is at the back. Tasks with the same end keep their insertion order.
     class WH_COMMON_API TaskQueue
     {
-        std::multiset<TaskContainer, Compare> container;
+        std::vector<TaskContainer> container;
+
+        /// Inserts the task after all tasks ending at the same time
+        void Insert(TaskContainer&& task);
 
     public:
         // Pushes the task in the container
@@ -377,7 +447,7 @@ private:
     TaskScheduler& ScheduleAt(timepoint_t const& end,
                               std::chrono::duration<_Rep, _Period> const& time, task_handler_t const& task)
     {
-        return InsertTask(TaskContainer(new Task(end + time, time, task)));
+        return InsertTask(std::allocate_shared<Task>(TaskAllocator<Task>(), end + time, time, task));
     }
 
     /// Schedule an event with a fixed rate.
@@ -388,7 +458,7 @@ private:
                               group_t const group, task_handler_t const& task)
     {
         static repeated_t const DEFAULT_REPEATED = 0;
-        return InsertTask(TaskContainer(new Task(end + time, time, group, DEFAULT_REPEATED, task)));
+        return InsertTask(std::allocate_shared<Task>(TaskAllocator<Task>(), end + time, time, group, DEFAULT_REPEATED, task));
     }
 
     // Returns a random duration between min and max
@@ -417,35 +487,48 @@ class WH_COMMON_API TaskContext
     /// Owner
     std::weak_ptr<TaskScheduler> _owner;
 
-    /// Marks the task as consumed
-    std::shared_ptr<bool> _consumed;
+    /// Invocation of the task this context was created for, the context is consumed once the task is repeated
+    /// or invoked again
+    uint32 _dispatchId;
 
     /// Dispatches an action safe on the TaskScheduler
-    TaskContext& Dispatch(std::function<TaskScheduler&(TaskScheduler&)> const& apply);
+    template<typename Apply>
+    TaskContext& Dispatch(Apply&& apply)
+    {
+        if (auto const owner = _owner.lock())
+        {
+            apply(*owner);
+        }
+
+        return *this;
+    }
 
 public:
     // Empty constructor
     TaskContext()
-        : _task(), _owner(), _consumed(std::make_shared<bool>(true)) { }
+        : _task(), _owner(), _dispatchId(0) { }
 
-    // Construct from task and owner
+    // Construct from task and owner, starts a new invocation of the task
     explicit TaskContext(TaskScheduler::TaskContainer&& task, std::weak_ptr<TaskScheduler>&& owner)
-        : _task(task), _owner(owner), _consumed(std::make_shared<bool>(false)) { }
+        : _task(std::move(task)), _owner(std::move(owner)), _dispatchId(++_task->_dispatchId)
+    {
+        _task->_consumed = false;
+    }
 
     // Copy construct
     TaskContext(TaskContext const& right)
-        : _task(right._task), _owner(right._owner), _consumed(right._consumed) { }
+        : _task(right._task), _owner(right._owner), _dispatchId(right._dispatchId) { }
 
     // Move construct
     TaskContext(TaskContext&& right)
-        : _task(std::move(right._task)), _owner(std::move(right._owner)), _consumed(std::move(right._consumed)) { }
+        : _task(std::move(right._task)), _owner(std::move(right._owner)), _dispatchId(right._dispatchId) { }
 
     // Copy assign
     TaskContext& operator= (TaskContext const& right)
     {
         _task = right._task;
         _owner = right._owner;
-        _consumed = right._consumed;
+        _dispatchId = right._dispatchId;
         return *this;
     }
 
@@ -454,7 +537,7 @@ public:
     {
         _task = std::move(right._task);
         _owner = std::move(right._owner);
-        _consumed = std::move(right._consumed);
+        _dispatchId = right._dispatchId;
         return *this;
     }
 
@@ -486,8 +569,11 @@ public:
         _task->_duration = duration;
         _task->_end += duration;
         _task->_repeated += 1;
-        (*_consumed) = true;
-        return Dispatch(std::bind(&TaskScheduler::InsertTask, std::placeholders::_1, _task));
+        _task->_consumed = true;
+        return Dispatch([this](TaskScheduler& scheduler) -> TaskScheduler&
+        {
+            return scheduler.InsertTask(_task);
+        });
     }
 
     /// Repeats the event with the same duration.
@@ -283,6 +283,15 @@ int main(int argc, char** argv)
         METRIC_VALUE("db_queue_login", uint64(AuthDatabase.GetQueueSize()));
         METRIC_VALUE("db_queue_character", uint64(CharacterDatabase.GetQueueSize()));
         METRIC_VALUE("db_queue_world", uint64(WorldDatabase.GetQueueSize()));
+
+        if (sLog->IsAsync())
+        {
+            METRIC_VALUE("log_queue", uint64(sLog->GetAsyncQueueSize()));
+            METRIC_VALUE("log_dropped", sLog->GetDroppedMessages());
+        }
+
+        for (auto const& [channelName, messages] : sLog->GetChannelsWrittenMessages())
+            METRIC_VALUE("log_channel_messages", messages, METRIC_TAG("channel", channelName));
     });
 
     METRIC_EVENT("events", "Worldserver started", "");
@@ -22,6 +22,8 @@
 #include "Errors.h"
 #include "Log.h"
 #include "MySQLHacks.h"
+#include <cstring>
+#include <limits>
 
 namespace
 {
@@ -181,6 +183,21 @@ ResultSet::ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, u
     }
 }
 
+ResultSet::ResultSet(std::vector<QueryResultFieldMetadata> fieldMetadata, uint64 rowCount, std::string_view rows, std::shared_ptr<void const> storage) :
+    _fieldMetadata(std::move(fieldMetadata)),
+    _rowCount(rowCount),
+    _fieldCount(uint32(_fieldMetadata.size())),
+    _result(nullptr),
+    _fields(nullptr),
+    _storedRows(rows),
+    _storage(std::move(storage))
+{
+    _currRow = std::make_unique<Field[]>(_fieldCount);
+
+    for (uint32 i = 0; i < _fieldCount; i++)
+        _currRow[i].SetMetadata(&_fieldMetadata[i]);
+}
+
 ResultSet::~ResultSet()
 {
     CleanUp();
@@ -188,6 +205,9 @@ ResultSet::~ResultSet()
 
 bool ResultSet::NextRow()
 {
+    if (_storage)
+        return NextStoredRow();
+
     if (!_result)
         return false;
 
@@ -212,10 +232,56 @@ bool ResultSet::NextRow()
     return true;
 }
 
+bool ResultSet::NextStoredRow()
+{
+    if (_storedRows.empty())
+    {
+        _storage.reset();
+        return false;
+    }
+
+    for (uint32 i = 0; i < _fieldCount; i++)
+    {
+        uint32 length;
+        ASSERT(_storedRows.size() >= sizeof(length), "Stored result of {} is truncated", _fieldMetadata[i].TableName);
+        memcpy(&length, _storedRows.data(), sizeof(length));
+        _storedRows.remove_prefix(sizeof(length));
+
+        if (length == std::numeric_limits<uint32>::max())
+        {
+            _currRow[i].SetStructuredValue(nullptr, 0);
+            continue;
+        }
+
+        ASSERT(_storedRows.size() > length, "Stored result of {} is truncated", _fieldMetadata[i].TableName);
+        _currRow[i].SetStructuredValue(_storedRows.data(), length);
+        _storedRows.remove_prefix(length + 1);
+    }
+
+    return true;
+}
+
+void ResultSet::WriteStoredRow(std::string& buffer) const
+{
+    for (uint32 i = 0; i < _fieldCount; i++)
+    {
+        Field const& field = _currRow[i];
+        uint32 length = field.IsNull() ? std::numeric_limits<uint32>::max() : field.data.length;
+
+        buffer.append(reinterpret_cast<char const*>(&length), sizeof(length));
+
+        if (!field.IsNull())
+        {
+            buffer.append(field.data.value, field.data.length);
+            buffer.push_back('\0');
+        }
+    }
+}
+
 std::string ResultSet::GetFieldName(uint32 index) const
 {
     ASSERT(index < _fieldCount);
-    return _fields[index].name;
+    return _fieldMetadata[index].Alias;
 }
 
 void ResultSet::CleanUp()
@@ -20,6 +20,8 @@
 
 #include "DatabaseEnvFwd.h"
 #include "Field.h"
+#include <memory>
+#include <string_view>
 #include <unordered_map>
 
 template<typename T>
@@ -47,12 +49,21 @@ class WH_DATABASE_API ResultSet
 {
 public:
     ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, uint32 fieldCount);
+
+    // Rows kept in memory instead of a mysql result, see WriteStoredRow for the format.
+    // storage owns the memory rows points to
+    ResultSet(std::vector<QueryResultFieldMetadata> fieldMetadata, uint64 rowCount, std::string_view rows, std::shared_ptr<void const> storage);
     ~ResultSet();
 
+    // Appends the current row to buffer. Every value is stored as uint32 length
+    // (0xFFFFFFFF for NULL) followed by the value and a terminating zero
+    void WriteStoredRow(std::string& buffer) const;
+
     bool NextRow();
     [[nodiscard]] uint64 GetRowCount() const { return _rowCount; }
     [[nodiscard]] uint32 GetFieldCount() const { return _fieldCount; }
     [[nodiscard]] std::string GetFieldName(uint32 index) const;
+    [[nodiscard]] std::vector<QueryResultFieldMetadata> const& GetFieldMetadata() const { return _fieldMetadata; }
 
     [[nodiscard]] auto* Fetch() const { return _currRow.get(); }
     Field const& operator[](std::size_t index) const;
@@ -85,10 +96,14 @@ protected:
 private:
     void CleanUp();
     void AssertRows(std::size_t sizeRows) const;
+    bool NextStoredRow();
 
     MySQLResult* _result;
     MySQLField* _fields;
 
+    std::string_view _storedRows;
+    std::shared_ptr<void const> _storage;
+
     ResultSet(ResultSet const& right) = delete;
     ResultSet& operator=(ResultSet const& right) = delete;
 };
@@ -37,6 +37,7 @@
 #include "SmartAI.h"
 #include "SpellMgr.h"
 #include "Vehicle.h"
+#include <algorithm>
 
 SmartScript::SmartScript()
 {
@@ -84,6 +85,7 @@ void SmartScript::OnReset()
             (*i).runOnce = false;
         }
     }
+    BuildEventIndex();
     ProcessEventsFor(SMART_EVENT_RESET);
     mLastInvoker.Clear();
     mCounterList.clear();
@@ -95,19 +97,23 @@ void SmartScript::OnReset()
 
 void SmartScript::ProcessEventsFor(SMART_EVENT e, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
 {
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
+    if (e == SMART_EVENT_LINK)//special handling
+        return;
+
+    // positions instead of iterators, actions may rebuild the index
+    std::size_t pos = std::lower_bound(mEventIndex.begin(), mEventIndex.end(), std::make_pair(e, uint32(0))) - mEventIndex.begin();
+    for (; pos < mEventIndex.size() && mEventIndex[pos].first == e; ++pos)
     {
-        SMART_EVENT eventType = SMART_EVENT((*i).GetEventType());
-        if (eventType == SMART_EVENT_LINK)//special handling
-            continue;
+        uint32 index = mEventIndex[pos].second;
+        SmartScriptHolder& holder = mEvents[index];
 
-        if (eventType == e)
-        {
-            ConditionList conds = sConditionMgr->GetConditionsForSmartEvent((*i).entryOrGuid, (*i).event_id, (*i).source_type);
-            ConditionSourceInfo info = ConditionSourceInfo(unit, GetBaseObject(), me ? me->GetVictim() : nullptr);
+        ConditionList conds = sConditionMgr->GetConditionsForSmartEvent(holder.entryOrGuid, holder.event_id, holder.source_type);
+        ConditionSourceInfo info = ConditionSourceInfo(unit, GetBaseObject(), me ? me->GetVictim() : nullptr);
 
-            if (sConditionMgr->IsObjectMeetToConditions(info, conds))
-                ProcessEvent(*i, unit, var0, var1, bvar, spell, gob);
+        if (sConditionMgr->IsObjectMeetToConditions(info, conds))
+        {
+            ProcessEvent(holder, unit, var0, var1, bvar, spell, gob);
+            AddCoolingEvent(index);
         }
     }
 }
@@ -4099,45 +4105,22 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
         }
 
         e.active = true;//activate events with cooldown
-        switch (e.GetEventType())//process ONLY timed events
-        {
-            case SMART_EVENT_NEAR_PLAYERS:
-            case SMART_EVENT_NEAR_PLAYERS_NEGATION:
-            case SMART_EVENT_UPDATE:
-            case SMART_EVENT_UPDATE_OOC:
-            case SMART_EVENT_UPDATE_IC:
-            case SMART_EVENT_HEALTH_PCT:
-            case SMART_EVENT_TARGET_HEALTH_PCT:
-            case SMART_EVENT_MANA_PCT:
-            case SMART_EVENT_TARGET_MANA_PCT:
-            case SMART_EVENT_RANGE:
-            case SMART_EVENT_VICTIM_CASTING:
-            case SMART_EVENT_FRIENDLY_HEALTH:
-            case SMART_EVENT_FRIENDLY_IS_CC:
-            case SMART_EVENT_FRIENDLY_MISSING_BUFF:
-            case SMART_EVENT_HAS_AURA:
-            case SMART_EVENT_TARGET_BUFFED:
-            case SMART_EVENT_IS_BEHIND_TARGET:
-            case SMART_EVENT_FRIENDLY_HEALTH_PCT:
-            case SMART_EVENT_DISTANCE_CREATURE:
-            case SMART_EVENT_DISTANCE_GAMEOBJECT:
+        if (IsTimedEvent(e.GetEventType()))//process ONLY timed events
+        {
+            ProcessEvent(e);
+            if (e.GetScriptType() == SMART_SCRIPT_TYPE_TIMED_ACTIONLIST)
+            {
+                e.enableTimed = false;//disable event if it is in an ActionList and was processed once
+                for (SmartAIEventList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
                 {
-                    ProcessEvent(e);
-                    if (e.GetScriptType() == SMART_SCRIPT_TYPE_TIMED_ACTIONLIST)
+                    //find the first event which is not the current one and enable it
+                    if (i->event_id > e.event_id)
                     {
-                        e.enableTimed = false;//disable event if it is in an ActionList and was processed once
-                        for (SmartAIEventList::iterator i = mTimedActionList.begin(); i != mTimedActionList.end(); ++i)
-                        {
-                            //find the first event which is not the current one and enable it
-                            if (i->event_id > e.event_id)
-                            {
-                                i->enableTimed = true;
-                                break;
-                            }
-                        }
+                        i->enableTimed = true;
+                        break;
                     }
-                    break;
                 }
+            }
         }
     }
     else
@@ -4149,6 +4132,70 @@ bool SmartScript::CheckTimer(SmartScriptHolder const& e) const
     return e.active;
 }
 
+bool SmartScript::IsTimedEvent(uint32 eventType)
+{
+    switch (eventType)
+    {
+        case SMART_EVENT_NEAR_PLAYERS:
+        case SMART_EVENT_NEAR_PLAYERS_NEGATION:
+        case SMART_EVENT_UPDATE:
+        case SMART_EVENT_UPDATE_OOC:
+        case SMART_EVENT_UPDATE_IC:
+        case SMART_EVENT_HEALTH_PCT:
+        case SMART_EVENT_TARGET_HEALTH_PCT:
+        case SMART_EVENT_MANA_PCT:
+        case SMART_EVENT_TARGET_MANA_PCT:
+        case SMART_EVENT_RANGE:
+        case SMART_EVENT_VICTIM_CASTING:
+        case SMART_EVENT_FRIENDLY_HEALTH:
+        case SMART_EVENT_FRIENDLY_IS_CC:
+        case SMART_EVENT_FRIENDLY_MISSING_BUFF:
+        case SMART_EVENT_HAS_AURA:
+        case SMART_EVENT_TARGET_BUFFED:
+        case SMART_EVENT_IS_BEHIND_TARGET:
+        case SMART_EVENT_FRIENDLY_HEALTH_PCT:
+        case SMART_EVENT_DISTANCE_CREATURE:
+        case SMART_EVENT_DISTANCE_GAMEOBJECT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void SmartScript::BuildEventIndex()
+{
+    mEventIndex.clear();
+    mTimedEvents.clear();
+    mCoolingEvents.clear();
+
+    for (uint32 i = 0; i < mEvents.size(); ++i)
+    {
+        SMART_EVENT eventType = SMART_EVENT(mEvents[i].GetEventType());
+        mEventIndex.emplace_back(eventType, i);
+
+        if (IsTimedEvent(eventType))
+            mTimedEvents.push_back(i);
+        else
+            AddCoolingEvent(i);
+    }
+
+    std::sort(mEventIndex.begin(), mEventIndex.end());
+}
+
+void SmartScript::AddCoolingEvent(uint32 index)
+{
+    if (index >= mEvents.size())
+        return;
+
+    // timed events are updated anyway, links are processed on copies and active events don't wait for anything
+    SmartScriptHolder const& e = mEvents[index];
+    if (e.active || e.GetEventType() == SMART_EVENT_LINK || IsTimedEvent(e.GetEventType()))
+        return;
+
+    if (std::find(mCoolingEvents.begin(), mCoolingEvents.end(), index) == mCoolingEvents.end())
+        mCoolingEvents.push_back(index);
+}
+
 void SmartScript::InstallEvents()
 {
     if (!mInstallEvents.empty())
@@ -4157,6 +4204,7 @@ void SmartScript::InstallEvents()
             mEvents.push_back(*i);//must be before UpdateTimers
 
         mInstallEvents.clear();
+        BuildEventIndex();
     }
 }
 
@@ -4167,8 +4215,24 @@ void SmartScript::OnUpdate(uint32 const diff)
 
     InstallEvents();//before UpdateTimers
 
-    for (SmartAIEventList::iterator i = mEvents.begin(); i != mEvents.end(); ++i)
-        UpdateTimer(*i, diff);
+    // positions instead of iterators, actions may rebuild the index
+    for (std::size_t i = 0; i < mTimedEvents.size(); ++i)
+        UpdateTimer(mEvents[mTimedEvents[i]], diff);
+
+    // only the cooldown of the other events needs updating, UpdateTimer doesn't process them
+    for (std::size_t i = 0; i < mCoolingEvents.size();)
+    {
+        SmartScriptHolder& e = mEvents[mCoolingEvents[i]];
+        UpdateTimer(e, diff);
+
+        if (e.active)
+        {
+            mCoolingEvents[i] = mCoolingEvents.back();
+            mCoolingEvents.pop_back();
+        }
+        else
+            ++i;
+    }
 
     if (!mStoredEvents.empty())
     {
@@ -4255,6 +4319,8 @@ void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTrigger c
         }
         mEvents.push_back((*i));//NOTE: 'world(0)' events still get processed in ANY instance mode
     }
+
+    BuildEventIndex();
 }
 
 void SmartScript::GetScript()
@@ -4348,6 +4414,8 @@ void SmartScript::OnInitialize(WorldObject* obj, AreaTrigger const* at)
     if (maxDisableDist > 0 && minEnableDist >= maxDisableDist)
         mMaxCombatDist = uint32(maxDisableDist + ((minEnableDist - maxDisableDist) / 2));
 
+    BuildEventIndex();
+
     ProcessEventsFor(SMART_EVENT_AI_INIT);
     InstallEvents();
     ProcessEventsFor(SMART_EVENT_JUST_CREATED);
@@ -4625,6 +4693,7 @@ void SmartScript::ResetBaseObject()
 
 Creature *SmartScript::FindCreatureNear(WorldObject *searchObject, ObjectGuid::LowType guid) const
 {
+    auto guard = searchObject->GetMap()->LockForRegionUpdate();
     auto bounds = searchObject->GetMap()->GetCreatureBySpawnIdStore().equal_range(guid);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -4639,6 +4708,7 @@ Creature *SmartScript::FindCreatureNear(WorldObject *searchObject, ObjectGuid::L
 
 GameObject *SmartScript::FindGameObjectNear(WorldObject *searchObject, ObjectGuid::LowType guid) const
 {
+    auto guard = searchObject->GetMap()->LockForRegionUpdate();
     auto bounds = searchObject->GetMap()->GetGameObjectBySpawnIdStore().equal_range(guid);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -177,6 +177,22 @@ private:
     SMARTAI_TEMPLATE mTemplate;
     void InstallEvents();
 
+    // Events processed by UpdateTimer once their timer expires, the timer of the others is only a cooldown
+    static bool IsTimedEvent(uint32 eventType);
+
+    // Rebuilds the mEvents indices below, after mEvents changed or its timers were reset
+    void BuildEventIndex();
+
+    // Queues an mEvents entry that just got a cooldown for UpdateTimer
+    void AddCoolingEvent(uint32 index);
+
+    // mEvents indices sorted by event type, ProcessEventsFor only visits the events of the processed type
+    std::vector<std::pair<SMART_EVENT, uint32>> mEventIndex;
+    // mEvents indices of the timed events, updated every OnUpdate
+    std::vector<uint32> mTimedEvents;
+    // mEvents indices of the other events with a running cooldown, dropped once it expires
+    std::vector<uint32> mCoolingEvents;
+
     void RemoveStoredEvent(uint32 id)
     {
         if (!mStoredEvents.empty())
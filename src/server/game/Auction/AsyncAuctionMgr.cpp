@@ -16,10 +16,14 @@
  */
 
 #include "AsyncAuctionMgr.h"
-#include "AuctionHouseBot.h"
 #include "AsyncAuctionOperation.h"
+#include "AuctionHouseBot.h"
+#include "AuctionHouseMgr.h"
+#include "Creature.h"
+#include "GameConfig.h"
 #include "GameTime.h"
 #include "Log.h"
+#include "ObjectAccessor.h"
 #include "PCQueue.h"
 #include "Player.h"
 #include "StopWatch.h"
@@ -28,6 +32,26 @@
 constexpr Milliseconds LIST_OWNER_ITEMS_DELAY = 100ms;
 constexpr Milliseconds LIST_ITEMS_DELAY = 500ms;
 
+namespace
+{
+    std::string_view GetOperationTypeName(AuctionOperationType type)
+    {
+        switch (type)
+        {
+            case AuctionOperationType::SellItem: return "sell_item";
+            case AuctionOperationType::PlaceBid: return "place_bid";
+            case AuctionOperationType::ListBidderItems: return "list_bidder_items";
+            case AuctionOperationType::ListOwnerItems: return "list_owner_items";
+            case AuctionOperationType::ListItems: return "list_items";
+            case AuctionOperationType::AhBot: return "ahbot";
+            default:
+                break;
+        }
+
+        return "unknown";
+    }
+}
+
 bool AuctionListItems::IsNoFilter() const
 {
     return ItemClass == 0xffffffff &&
@@ -44,11 +68,19 @@ AsyncAuctionMgr::~AsyncAuctionMgr()
     if (_scheduler)
         _scheduler->CancelAll();
 
-    if (_queue)
-        _queue->Cancel();
+    for (auto& partition : _partitions)
+        partition.Queue->Cancel();
+
+    if (_sharedQueue)
+        _sharedQueue->Cancel();
+
+    for (auto& partition : _partitions)
+        if (partition.Thread->joinable())
+            partition.Thread->join();
 
-    if (_thread && _thread->joinable())
-        _thread->join();
+    for (auto& thread : _sharedThreads)
+        if (thread.joinable())
+            thread.join();
 }
 
 /*static*/ AsyncAuctionMgr* AsyncAuctionMgr::instance()
@@ -63,39 +95,68 @@ void AsyncAuctionMgr::Initialize()
 
     LOG_INFO("server.loading", "Initialize async auction...");
 
-    _queue = std::make_unique<ProducerConsumerQueue<AsyncAuctionOperation*>>();
-    _thread = std::make_unique<std::thread>([this](){ ExecuteAsyncQueue(); });
+    // With AllowTwoSide.Interaction.Auction all ids resolve to the neutral house
+    for (uint8 houseId : { AUCTIONHOUSE_ALLIANCE, AUCTIONHOUSE_HORDE, AUCTIONHOUSE_NEUTRAL })
+    {
+        AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMapByHouseId(houseId);
+        if (std::find_if(_partitions.begin(), _partitions.end(), [auctionHouse](Partition const& partition) { return partition.AuctionHouse == auctionHouse; }) != _partitions.end())
+            continue;
+
+        Partition& partition = _partitions.emplace_back();
+        partition.AuctionHouse = auctionHouse;
+        partition.Queue = std::make_unique<OperationQueue>();
+        partition.Thread = std::make_unique<std::thread>([this, queue = partition.Queue.get()](){ ExecuteAsyncQueue(queue); });
+    }
+
+    auto listThreads{ std::max<int32>(1, CONF_GET_INT("AuctionHouse.ListThreads")) };
+
+    _sharedQueue = std::make_unique<OperationQueue>();
+    for (int32 i = 0; i < listThreads; ++i)
+        _sharedThreads.emplace_back([this](){ ExecuteAsyncQueue(_sharedQueue.get()); });
+
     _scheduler = std::make_unique<TaskScheduler>();
 
-    LOG_INFO("server.loading", ">> Async auction initialized in {}", sw);
+    for (std::size_t i = 0; i < OPERATION_TYPES; ++i)
+    {
+        std::string typeName{ GetOperationTypeName(static_cast<AuctionOperationType>(i)) };
+        _queueMetrics[i] = MetricGauge("auction_queue_size", { METRIC_TAG("type", typeName) });
+        _waitTimeMetrics[i] = MetricHistogram("auction_operation_wait", { METRIC_TAG("type", typeName) });
+        _executeTimeMetrics[i] = MetricHistogram("auction_operation_time", { METRIC_TAG("type", typeName) });
+    }
+
+    LOG_INFO("server.loading", ">> Async auction initialized with {} house queues and {} list threads in {}", _partitions.size(), listThreads, sw);
     LOG_INFO("server.loading", "");
 }
 
 void AsyncAuctionMgr::Update(Milliseconds diff)
 {
     _scheduler->Update(diff);
+
+    for (std::size_t i = 0; i < OPERATION_TYPES; ++i)
+        _queueMetrics[i].Set(_queued[i]);
 }
 
 void AsyncAuctionMgr::SellItem(ObjectGuid playerGuid, std::shared_ptr<AuctionSellItem> packet)
 {
-    Enqueue(new SellItemTask(playerGuid, std::move(packet)));
+    AuctionHouseObject* auctionHouse = GetAuctionHouse(playerGuid, packet->Auctioneer);
+    Enqueue(new SellItemTask(playerGuid, std::move(packet)), auctionHouse);
 }
 
 void AsyncAuctionMgr::PlaceBid(ObjectGuid playerGuid, ObjectGuid auctioneer, uint32 auctionID, uint32 price)
 {
-    Enqueue(new PlaceBidTask(playerGuid, auctioneer, auctionID, price));
+    Enqueue(new PlaceBidTask(playerGuid, auctioneer, auctionID, price), GetAuctionHouse(playerGuid, auctioneer));
 }
 
 void AsyncAuctionMgr::ListBidderItems(ObjectGuid playerGuid, ObjectGuid auctioneer, uint32 listFrom, uint32 outbiddedCount, std::vector<uint32>& outbiddedAuctionIds)
 {
-    Enqueue(new ListBidderItemsTask(playerGuid, auctioneer, listFrom, outbiddedCount, outbiddedAuctionIds));
+    Enqueue(new ListBidderItemsTask(playerGuid, auctioneer, listFrom, outbiddedCount, outbiddedAuctionIds), GetAuctionHouse(playerGuid, auctioneer));
 }
 
 void AsyncAuctionMgr::ListOwnerItems(ObjectGuid playerGuid, ObjectGuid creatureGuid)
 {
     _scheduler->Schedule(LIST_OWNER_ITEMS_DELAY, [this, playerGuid, creatureGuid](TaskContext)
     {
-        Enqueue(new ListOwnerTask(playerGuid, creatureGuid));
+        Enqueue(new ListOwnerTask(playerGuid, creatureGuid), GetAuctionHouse(playerGuid, creatureGuid));
     });
 }
 
@@ -103,38 +164,93 @@ void AsyncAuctionMgr::ListItems(ObjectGuid playerGuid, std::shared_ptr<AuctionLi
 {
     _scheduler->Schedule(LIST_ITEMS_DELAY, [this, playerGuid, listItems = std::move(listItems)](TaskContext)
     {
-        Enqueue(new ListItemsTask(playerGuid, listItems));
+        Enqueue(new ListItemsTask(playerGuid, listItems), GetAuctionHouse(playerGuid, listItems->CreatureGuid));
     });
 }
 
 void AsyncAuctionMgr::UpdateBotAgents()
 {
-    Enqueue(new AhBotTask());
+    Enqueue(new AhBotTask(), nullptr);
 }
 
-void AsyncAuctionMgr::Enqueue(AsyncAuctionOperation* operation)
+AuctionHouseObject* AsyncAuctionMgr::GetAuctionHouse(ObjectGuid playerGuid, ObjectGuid auctioneer)
 {
-    _queue->Push(operation);
+    if (Player* player = ObjectAccessor::FindPlayer(playerGuid))
+        if (Creature* creature = player->GetNPCIfCanInteractWith(auctioneer, UNIT_NPC_FLAG_AUCTIONEER))
+            return sAuctionMgr->GetAuctionsMap(creature->GetFaction());
+
+    // The operation fails and reports the error by itself, any house will do
+    return sAuctionMgr->GetAuctionsMapByHouseId(AUCTIONHOUSE_NEUTRAL);
 }
 
-void AsyncAuctionMgr::ExecuteAsyncQueue()
+void AsyncAuctionMgr::Enqueue(AsyncAuctionOperation* operation, AuctionHouseObject* auctionHouse)
 {
-    if (!_queue)
-        return;
+    operation->SetAuctionHouse(auctionHouse);
+    operation->SetEnqueueTime(std::chrono::steady_clock::now());
+    ++_queued[static_cast<std::size_t>(operation->GetType())];
 
+    if (auctionHouse && !operation->IsReadOnly())
+    {
+        for (auto& partition : _partitions)
+        {
+            if (partition.AuctionHouse == auctionHouse)
+            {
+                partition.Queue->Push(operation);
+                return;
+            }
+        }
+    }
+
+    _sharedQueue->Push(operation);
+}
+
+void AsyncAuctionMgr::ExecuteAsyncQueue(OperationQueue* queue)
+{
     for (;;)
     {
         AsyncAuctionOperation* task{ nullptr };
-        _queue->WaitAndPop(task);
+        queue->WaitAndPop(task);
 
         if (!task)
             break;
 
+        Execute(task);
+    }
+}
+
+void AsyncAuctionMgr::Execute(AsyncAuctionOperation* operation)
+{
+    auto const typeIndex = static_cast<std::size_t>(operation->GetType());
+    --_queued[typeIndex];
+
+    auto const startTime = std::chrono::steady_clock::now();
+    _waitTimeMetrics[typeIndex].Record(startTime - operation->GetEnqueueTime());
+
+    if (AuctionHouseObject* auctionHouse = operation->GetAuctionHouse())
+    {
+        std::shared_lock<SharedMutex> globalGuard(_mutex);
+
+        if (operation->IsReadOnly())
         {
-            std::lock_guard<std::mutex> guard(_mutex);
-            task->Execute();
+            std::shared_lock<SharedMutex> houseGuard(auctionHouse->GetLock());
+            operation->Execute();
         }
+        else
+        {
+            std::unique_lock<SharedMutex> houseGuard(auctionHouse->GetLock());
 
-        delete task;
+            // the same player may sell or bid in another house at the same time
+            std::lock_guard<std::mutex> playerGuard(_playerLocks[operation->GetPlayerGUID().GetCounter() % PLAYER_LOCKS]);
+            operation->Execute();
+        }
+    }
+    else
+    {
+        std::unique_lock<SharedMutex> globalGuard(_mutex);
+        operation->Execute();
     }
+
+    _executeTimeMetrics[typeIndex].Record(std::chrono::steady_clock::now() - startTime);
+
+    delete operation;
 }
@@ -19,20 +19,37 @@
 #define WARHEAD_ASYNC_AUCTION_MGR_H_
 
 #include "AuctionFwd.h"
+#include "Metric.h"
+#include "SharedMutex.h"
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 template <typename T>
 class ProducerConsumerQueue;
 
 class AsyncAuctionOperation;
+class AuctionHouseObject;
 class Player;
 class TaskScheduler;
 
+/*
+ * Auction operations are partitioned by auction house.
+ * Every house has its own queue and thread, so operations changing a house (sell, bid)
+ * are executed in order and exclusively for that house only.
+ * List operations and the AHBot agents go to a shared pool of AuctionHouse.ListThreads
+ * threads. List operations only take a shared lock of their house and run concurrently,
+ * the AHBot agents touch every house and take the global lock exclusively.
+ * Sell and bid change the player too, they are serialized per player across the houses.
+ */
 class WH_GAME_API AsyncAuctionMgr
 {
 public:
+    using SharedMutex = Warhead::WriterPreferringSharedMutex;
+
     static AsyncAuctionMgr* instance();
 
     void Initialize();
@@ -45,16 +62,41 @@ public:
     void ListItems(ObjectGuid playerGuid, std::shared_ptr<AuctionListItems> listItems);
     void UpdateBotAgents();
 
-    inline std::mutex& GetLock() { return _mutex; }
+    // Held exclusively by the world update (expired auctions, thread unsafe session handlers)
+    // and the AHBot agents, operations on a single house take it shared before the lock of the house
+    inline SharedMutex& GetLock() { return _mutex; }
+
+    [[nodiscard]] uint32 GetQueueSize(AuctionOperationType type) const { return _queued[static_cast<std::size_t>(type)]; }
 
 private:
-    void ExecuteAsyncQueue();
-    void Enqueue(AsyncAuctionOperation* operation);
+    using OperationQueue = ProducerConsumerQueue<AsyncAuctionOperation*>;
 
-    std::unique_ptr<ProducerConsumerQueue<AsyncAuctionOperation*>> _queue;
-    std::unique_ptr<std::thread> _thread;
+    struct Partition
+    {
+        AuctionHouseObject* AuctionHouse{ nullptr };
+        std::unique_ptr<OperationQueue> Queue;
+        std::unique_ptr<std::thread> Thread;
+    };
+
+    void ExecuteAsyncQueue(OperationQueue* queue);
+    void Execute(AsyncAuctionOperation* operation);
+    void Enqueue(AsyncAuctionOperation* operation, AuctionHouseObject* auctionHouse);
+    static AuctionHouseObject* GetAuctionHouse(ObjectGuid playerGuid, ObjectGuid auctioneer);
+
+    static constexpr std::size_t OPERATION_TYPES = static_cast<std::size_t>(AuctionOperationType::Max);
+    static constexpr std::size_t PLAYER_LOCKS = 64;
+
+    std::vector<Partition> _partitions;
+    std::unique_ptr<OperationQueue> _sharedQueue;
+    std::vector<std::thread> _sharedThreads;
     std::unique_ptr<TaskScheduler> _scheduler;
-    std::mutex _mutex;
+    SharedMutex _mutex;
+    std::array<std::mutex, PLAYER_LOCKS> _playerLocks; // striped by player guid
+
+    std::array<std::atomic<uint32>, OPERATION_TYPES> _queued{};
+    std::array<MetricGauge, OPERATION_TYPES> _queueMetrics;
+    std::array<MetricHistogram, OPERATION_TYPES> _waitTimeMetrics;
+    std::array<MetricHistogram, OPERATION_TYPES> _executeTimeMetrics;
 
     AsyncAuctionMgr() = default;
     ~AsyncAuctionMgr();
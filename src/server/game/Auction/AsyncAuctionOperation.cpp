@@ -27,6 +27,19 @@
 #include "Player.h"
 #include "ScriptMgr.h"
 
+bool AsyncAuctionOperation::IsReadOnly() const
+{
+    switch (GetType())
+    {
+        case AuctionOperationType::ListBidderItems:
+        case AuctionOperationType::ListOwnerItems:
+        case AuctionOperationType::ListItems:
+            return true;
+        default:
+            return false;
+    }
+}
+
 Player* AsyncAuctionOperation::GetPlayer() const
 {
     return ObjectAccessor::FindPlayer(_playerGuid);
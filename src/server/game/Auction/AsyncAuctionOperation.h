@@ -18,10 +18,13 @@
 #ifndef WARHEAD_ASYNC_AUCTION_OPERATION_H_
 #define WARHEAD_ASYNC_AUCTION_OPERATION_H_
 
+#include "AuctionFwd.h"
+#include "Duration.h"
 #include "ObjectGuid.h"
 #include <memory>
 #include <utility>
 
+class AuctionHouseObject;
 class Player;
 
 struct AuctionListItems;
@@ -36,12 +39,25 @@ public:
     virtual ~AsyncAuctionOperation() = default;
 
     virtual void Execute() = 0;
+    [[nodiscard]] virtual AuctionOperationType GetType() const = 0;
+
+    // List operations only read the auction house and may run concurrently
+    [[nodiscard]] bool IsReadOnly() const;
 
     [[nodiscard]] ObjectGuid GetPlayerGUID() const { return _playerGuid; }
     [[nodiscard]] Player* GetPlayer() const;
 
+    // House the operation works on, nullptr for operations touching all houses
+    [[nodiscard]] AuctionHouseObject* GetAuctionHouse() const { return _auctionHouse; }
+    void SetAuctionHouse(AuctionHouseObject* auctionHouse) { _auctionHouse = auctionHouse; }
+
+    [[nodiscard]] TimePoint GetEnqueueTime() const { return _enqueueTime; }
+    void SetEnqueueTime(TimePoint enqueueTime) { _enqueueTime = enqueueTime; }
+
 private:
     ObjectGuid _playerGuid;
+    AuctionHouseObject* _auctionHouse{ nullptr };
+    TimePoint _enqueueTime;
 
     AsyncAuctionOperation(AsyncAuctionOperation const& right) = delete;
     AsyncAuctionOperation& operator=(AsyncAuctionOperation const& right) = delete;
@@ -56,6 +72,7 @@ public:
     ~SellItemTask() override = default;
 
     void Execute() override;
+    [[nodiscard]] AuctionOperationType GetType() const override { return AuctionOperationType::SellItem; }
 
 private:
     std::shared_ptr<AuctionSellItem> _packet;
@@ -70,6 +87,7 @@ public:
     ~PlaceBidTask() override = default;
 
     void Execute() override;
+    [[nodiscard]] AuctionOperationType GetType() const override { return AuctionOperationType::PlaceBid; }
 
 private:
     ObjectGuid _auctioneer;
@@ -90,6 +108,7 @@ public:
     ~ListBidderItemsTask() override = default;
 
     void Execute() override;
+    [[nodiscard]] AuctionOperationType GetType() const override { return AuctionOperationType::ListBidderItems; }
 
 private:
     ObjectGuid _auctioneer;
@@ -107,6 +126,7 @@ public:
     ~ListOwnerTask() override = default;
 
     void Execute() override;
+    [[nodiscard]] AuctionOperationType GetType() const override { return AuctionOperationType::ListOwnerItems; }
 
 private:
     ObjectGuid _creatureGuid;
@@ -121,6 +141,7 @@ public:
     ~ListItemsTask() override = default;
 
     void Execute() override;
+    [[nodiscard]] AuctionOperationType GetType() const override { return AuctionOperationType::ListItems; }
 
 private:
     std::shared_ptr<AuctionListItems> _packet;
@@ -133,6 +154,7 @@ public:
     ~AhBotTask() override = default;
 
     void Execute() override;
+    [[nodiscard]] AuctionOperationType GetType() const override { return AuctionOperationType::AhBot; }
 };
 
 #endif
@@ -87,6 +87,18 @@ enum AuctionHouses
     AUCTIONHOUSE_NEUTRAL        = 7
 };
 
+enum class AuctionOperationType : uint8
+{
+    SellItem,
+    PlaceBid,
+    ListBidderItems,
+    ListOwnerItems,
+    ListItems,
+    AhBot,
+
+    Max
+};
+
 struct WH_GAME_API AuctionListItems
 {
     ObjectGuid CreatureGuid;
@@ -229,12 +229,14 @@ void AuctionHouseObject::AddAuction(std::unique_ptr<AuctionEntry>&& auction)
     ASSERT(auction);
 
     auto const [itr, isEmplace] = _auctions.emplace(auction->Id, std::move(auction));
+    _searchIndex.AddAuction(itr->second.get(), sAuctionMgr->GetAuctionItem(itr->second->ItemGuid));
     sScriptMgr->OnAuctionAdd(this, itr->second.get());
 }
 
 bool AuctionHouseObject::RemoveAuction(AuctionEntry* auction)
 {
     sScriptMgr->OnAuctionRemove(this, auction);
+    _searchIndex.RemoveAuction(auction);
     return _auctions.erase(auction->Id) > 0;
 }
 
@@ -246,18 +248,25 @@ void AuctionHouseObject::Update()
     if (_auctions.empty())
         return;
 
-    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+    // Collect first, RemoveAuction erases from _auctions
+    std::vector<AuctionEntry*> expiredAuctions;
 
     for (auto const& [auctionID, auction] : _auctions)
-    {
-        if (auction->ExpireTime > checkTime)
-            continue;
+        if (auction->ExpireTime <= checkTime)
+            expiredAuctions.emplace_back(auction.get());
+
+    if (expiredAuctions.empty())
+        return;
+
+    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
 
+    for (AuctionEntry* auction : expiredAuctions)
+    {
         ///- Either cancel the auction if there was no bidder
         if (!auction->Bidder)
         {
-            sAuctionMgr->SendAuctionExpiredMail(auction.get(), trans);
-            sScriptMgr->OnAuctionExpire(this, auction.get());
+            sAuctionMgr->SendAuctionExpiredMail(auction, trans);
+            sScriptMgr->OnAuctionExpire(this, auction);
         }
         ///- Or perform the transaction
         else
@@ -265,16 +274,16 @@ void AuctionHouseObject::Update()
             //we should send an "item sold" message if the seller is online
             //we send the item to the winner
             //we send the money to the seller
-            sAuctionMgr->SendAuctionSuccessfulMail(auction.get(), trans);
-            sAuctionMgr->SendAuctionWonMail(auction.get(), trans);
-            sScriptMgr->OnAuctionSuccessful(this, auction.get());
+            sAuctionMgr->SendAuctionSuccessfulMail(auction, trans);
+            sAuctionMgr->SendAuctionWonMail(auction, trans);
+            sScriptMgr->OnAuctionSuccessful(this, auction);
         }
 
         ///- In any case clear the auction
         auction->DeleteFromDB(trans);
 
         sAuctionMgr->RemoveAItem(auction->ItemGuid);
-        RemoveAuction(auction.get());
+        RemoveAuction(auction);
     }
 
     CharacterDatabase.CommitTransaction(trans);
@@ -294,108 +303,8 @@ bool AuctionHouseObject::BuildListAuctionItems(WorldPackets::AuctionHouse::ListR
     }
     else
     {
-        auto curTime = GameTime::GetGameTime();
-        int loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
-        int locdbc_idx = player->GetSession()->GetSessionDbcLocale();
-
         wstrToLower(packet.WSearchedName);
-
-        for (auto const& [auctionID, auction] : GetAuctions())
-        {
-            // Skip expired auctions
-            if (auction->ExpireTime < curTime)
-                continue;
-
-            Item* item = sAuctionMgr->GetAuctionItem(auction->ItemGuid);
-            if (!item)
-                continue;
-
-            ItemTemplate const* proto = item->GetTemplate();
-            if (listItems->ItemClass != 0xffffffff && proto->Class != listItems->ItemClass)
-                continue;
-
-            if (listItems->ItemSubClass != 0xffffffff && proto->SubClass != listItems->ItemSubClass)
-                continue;
-
-            if (listItems->InventoryType != 0xffffffff && proto->InventoryType != listItems->InventoryType)
-            {
-                // xinef: exception, robes are counted as chests
-                if (listItems->InventoryType != INVTYPE_CHEST || proto->InventoryType != INVTYPE_ROBE)
-                    continue;
-            }
-
-            if (listItems->Quality != 0xffffffff && proto->Quality < listItems->Quality)
-                continue;
-
-            if (listItems->LevelMin != 0x00 && (proto->RequiredLevel < listItems->LevelMin ||
-                (listItems->LevelMax != 0x00 && proto->RequiredLevel > listItems->LevelMax)))
-                continue;
-
-            if (listItems->Usable != 0x00)
-            {
-                if (player->CanUseItem(item) != EQUIP_ERR_OK)
-                    continue;
-
-                // xinef: check already learded recipes and pets
-                if (proto->Spells[1].SpellTrigger == ITEM_SPELLTRIGGER_LEARN_SPELL_ID && player->HasSpell(proto->Spells[1].SpellId))
-                    continue;
-            }
-
-            // Allow search by suffix (ie: of the Monkey) or partial name (ie: Monkey)
-            // No need to do any of this if no search term was entered
-            if (!packet.WSearchedName.empty())
-            {
-                std::string name = proto->Name1;
-                if (name.empty())
-                    continue;
-
-                // local name
-                if (loc_idx > 0)
-                    if (ItemLocale const* il = sGameLocale->GetItemLocale(proto->ItemId))
-                        GameLocale::GetLocaleString(il->Name, loc_idx, name);
-
-                // DO NOT use GetItemEnchantMod(proto->RandomProperty) as it may return a result
-                //  that matches the search, but it may not equal item->GetItemRandomPropertyId()
-                //  used in BuildAuctionInfo() which then causes wrong items to be listed
-                int32 propRefID = item->GetItemRandomPropertyId();
-
-                if (propRefID)
-                {
-                    // Append the suffix to the name (ie: of the Monkey) if one exists
-                    // These are found in ItemRandomSuffix.dbc and ItemRandomProperties.dbc
-                    // even though the DBC name seems misleading
-                    std::array<char const*, 16> const* suffix = nullptr;
-
-                    if (propRefID < 0)
-                    {
-                        ItemRandomSuffixEntry const* itemRandEntry = sItemRandomSuffixStore.LookupEntry(-item->GetItemRandomPropertyId());
-                        if (itemRandEntry)
-                            suffix = &itemRandEntry->Name;
-                    }
-                    else
-                    {
-                        ItemRandomPropertiesEntry const* itemRandEntry = sItemRandomPropertiesStore.LookupEntry(item->GetItemRandomPropertyId());
-                        if (itemRandEntry)
-                            suffix = &itemRandEntry->Name;
-                    }
-
-                    // dbc local name
-                    if (suffix)
-                    {
-                        // Append the suffix (ie: of the Monkey) to the name using localization
-                        // or default enUS if localization is invalid
-                        name += ' ';
-                        name += (*suffix)[locdbc_idx >= 0 ? locdbc_idx : LOCALE_enUS];
-                    }
-                }
-
-                // Perform the search (with or without suffix)
-                if (!Utf8FitTo(name, packet.WSearchedName))
-                    continue;
-            }
-
-            packet.AuctionShortlist.emplace_back(auction.get());
-        }
+        _searchIndex.Search(*listItems, packet.WSearchedName, player, packet.AuctionShortlist);
     }
 
     if (packet.AuctionShortlist.empty())
@@ -407,13 +316,16 @@ bool AuctionHouseObject::BuildListAuctionItems(WorldPackets::AuctionHouse::ListR
         AuctionSortInfo const& sortInfo = *listItems->SortOrder.begin();
         if (sortInfo.SortOrder >= AuctionSortOrder::MinLevel && sortInfo.SortOrder < AuctionSortOrder::Max && sortInfo.SortOrder != AuctionSortOrder::Unk4)
         {
-            // Partial sort to improve performance a bit, but the last pages will burn
-            if (listItems->ListFrom + 50 <= packet.AuctionShortlist.size())
-                std::partial_sort(packet.AuctionShortlist.begin(), packet.AuctionShortlist.begin() + listItems->ListFrom + 50, packet.AuctionShortlist.end(),
-                    std::bind(SortAuction, std::placeholders::_1, std::placeholders::_2, listItems->SortOrder, player, sortInfo.SortOrder == AuctionSortOrder::Bid));
-            else
-                std::sort(packet.AuctionShortlist.begin(), packet.AuctionShortlist.end(), std::bind(SortAuction, std::placeholders::_1, std::placeholders::_2, listItems->SortOrder,
-                    player, sortInfo.SortOrder == AuctionSortOrder::Bid));
+            // Only the requested page is sent, so sort just that window:
+            // select everything before it, then order the page itself
+            auto comparator = std::bind(SortAuction, std::placeholders::_1, std::placeholders::_2, listItems->SortOrder, player, sortInfo.SortOrder == AuctionSortOrder::Bid);
+            auto pageBegin = packet.AuctionShortlist.begin() + std::min<std::size_t>(listItems->ListFrom, packet.AuctionShortlist.size());
+            auto pageEnd = packet.AuctionShortlist.begin() + std::min<std::size_t>(listItems->ListFrom + 50, packet.AuctionShortlist.size());
+
+            if (pageBegin != packet.AuctionShortlist.begin() && pageBegin != packet.AuctionShortlist.end())
+                std::nth_element(packet.AuctionShortlist.begin(), pageBegin, packet.AuctionShortlist.end(), comparator);
+
+            std::partial_sort(pageBegin, pageEnd, packet.AuctionShortlist.end(), comparator);
         }
     }
 
@@ -456,6 +368,7 @@ uint32 AuctionHouseMgr::GetAuctionDeposit(AuctionHouseEntry const* entry, Minute
 
 Item* AuctionHouseMgr::GetAuctionItem(ObjectGuid itemGuid)
 {
+    std::shared_lock<std::shared_mutex> lock(_itemsLock);
     return Warhead::Containers::MapGetValuePtr(_items, itemGuid);
 }
 
@@ -744,6 +657,8 @@ void AuctionHouseMgr::AddAuctionItem(Item* item)
     auto itemGuid{ item->GetGUID() };
 
     ASSERT(item);
+
+    std::unique_lock<std::shared_mutex> lock(_itemsLock);
     ASSERT(!_items.contains(itemGuid));
 
     _items.emplace(itemGuid, item);
@@ -751,6 +666,8 @@ void AuctionHouseMgr::AddAuctionItem(Item* item)
 
 bool AuctionHouseMgr::RemoveAItem(ObjectGuid itemGuid, bool deleteFromDB, CharacterDatabaseTransaction trans /*= nullptr*/)
 {
+    std::unique_lock<std::shared_mutex> lock(_itemsLock);
+
     auto const& itr = _items.find(itemGuid);
     if (itr == _items.end())
         return false;
@@ -19,10 +19,13 @@
 #define WARHEAD_AUCTION_HOUSE_MGR_H_
 
 #include "AuctionFwd.h"
+#include "AuctionSearchIndex.h"
 #include "DBCStructure.h"
 #include "DatabaseEnvFwd.h"
 #include "EventProcessor.h"
 #include "ObjectGuid.h"
+#include "SharedMutex.h"
+#include <shared_mutex>
 #include <unordered_map>
 
 class Item;
@@ -84,8 +87,13 @@ public:
 
     bool BuildListAuctionItems(WorldPackets::AuctionHouse::ListResult& packet, Player* player, std::shared_ptr<AuctionListItems> listItems);
 
+    // Shared by list operations, exclusive for anything changing the house. See AsyncAuctionMgr
+    Warhead::WriterPreferringSharedMutex& GetLock() { return _lock; }
+
 private:
     std::unordered_map<uint32, std::unique_ptr<AuctionEntry>> _auctions;
+    AuctionSearchIndex _searchIndex;
+    Warhead::WriterPreferringSharedMutex _lock;
 };
 
 class WH_GAME_API AuctionHouseMgr
@@ -131,6 +139,7 @@ private:
     AuctionHouseObject mNeutralAuctions;
 
     std::unordered_map<ObjectGuid, Item*> _items;
+    std::shared_mutex _itemsLock; // houses are updated in parallel
 };
 
 #define sAuctionMgr AuctionHouseMgr::instance()
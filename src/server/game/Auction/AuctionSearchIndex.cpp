@@ -0,0 +1,344 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "AuctionSearchIndex.h"
+#include "AuctionHouseMgr.h"
+#include "DBCStores.h"
+#include "GameLocale.h"
+#include "GameTime.h"
+#include "Item.h"
+#include "ItemTemplate.h"
+#include "Player.h"
+#include "Util.h"
+#include <array>
+
+namespace
+{
+    constexpr uint32 ANY_FILTER = 0xffffffff;
+    constexpr std::size_t TRIGRAM_LENGTH = 3;
+}
+
+uint64 AuctionSearchIndex::MakeTrigram(wchar_t a, wchar_t b, wchar_t c)
+{
+    // 21 bits are enough for any unicode code point
+    return (uint64(uint32(a) & 0x1FFFFF) << 42) | (uint64(uint32(b) & 0x1FFFFF) << 21) | uint64(uint32(c) & 0x1FFFFF);
+}
+
+void AuctionSearchIndex::AddAuction(AuctionEntry* auction, Item* item)
+{
+    if (!auction || !item || _slots.contains(auction->Id))
+        return;
+
+    uint32 slot;
+    if (!_freeSlots.empty())
+    {
+        slot = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32>(_entries.size());
+        _entries.emplace_back();
+    }
+
+    IndexedAuction& entry = _entries[slot];
+    entry.Auction = auction;
+    entry.Proto = item->GetTemplate();
+    entry.RandomPropertyId = item->GetItemRandomPropertyId();
+
+    _slots.emplace(auction->Id, slot);
+    _byClass[entry.Proto->Class].insert(slot);
+    _bySubClass[MakeSubClassKey(entry.Proto->Class, entry.Proto->SubClass)].insert(slot);
+    _byInventoryType[entry.Proto->InventoryType].insert(slot);
+
+    for (auto& [key, nameIndex] : _names)
+        AddName(nameIndex, slot);
+}
+
+void AuctionSearchIndex::RemoveAuction(AuctionEntry* auction)
+{
+    if (!auction)
+        return;
+
+    auto itr = _slots.find(auction->Id);
+    if (itr == _slots.end())
+        return;
+
+    uint32 slot = itr->second;
+    _slots.erase(itr);
+
+    IndexedAuction& entry = _entries[slot];
+
+    auto eraseFrom = [slot](auto& index, auto key)
+    {
+        auto setItr = index.find(key);
+        if (setItr == index.end())
+            return;
+
+        setItr->second.erase(slot);
+        if (setItr->second.empty())
+            index.erase(setItr);
+    };
+
+    eraseFrom(_byClass, entry.Proto->Class);
+    eraseFrom(_bySubClass, MakeSubClassKey(entry.Proto->Class, entry.Proto->SubClass));
+    eraseFrom(_byInventoryType, entry.Proto->InventoryType);
+
+    for (auto& [key, nameIndex] : _names)
+        RemoveName(nameIndex, slot);
+
+    entry = IndexedAuction();
+    _freeSlots.emplace_back(slot);
+}
+
+void AuctionSearchIndex::Search(AuctionListItems const& filter, std::wstring const& searchedName, Player* player, std::vector<AuctionEntry*>& result)
+{
+    NameIndex* nameIndex = nullptr;
+    if (!searchedName.empty())
+        nameIndex = &GetNameIndex(player->GetSession()->GetSessionDbLocaleIndex(), player->GetSession()->GetSessionDbcLocale());
+
+    // Pick the smallest set of candidates, everything else is checked per entry
+    std::vector<SlotSet const*> candidates;
+    std::size_t candidatesCount = 0;
+    bool hasCandidates = false;
+
+    auto offerCandidates = [&](std::vector<SlotSet const*> const& sets)
+    {
+        std::size_t count = 0;
+        for (SlotSet const* set : sets)
+            count += set->size();
+
+        if (hasCandidates && count >= candidatesCount)
+            return;
+
+        candidates = sets;
+        candidatesCount = count;
+        hasCandidates = true;
+    };
+
+    static SlotSet const emptySet;
+
+    auto findSet = [](auto const& index, auto key) -> SlotSet const*
+    {
+        auto itr = index.find(key);
+        return itr != index.end() ? &itr->second : &emptySet;
+    };
+
+    if (filter.ItemClass != ANY_FILTER)
+    {
+        if (filter.ItemSubClass != ANY_FILTER)
+            offerCandidates({ findSet(_bySubClass, MakeSubClassKey(filter.ItemClass, filter.ItemSubClass)) });
+        else
+            offerCandidates({ findSet(_byClass, filter.ItemClass) });
+    }
+
+    if (filter.InventoryType != ANY_FILTER)
+    {
+        // xinef: exception, robes are counted as chests
+        if (filter.InventoryType == INVTYPE_CHEST)
+            offerCandidates({ findSet(_byInventoryType, uint32(INVTYPE_CHEST)), findSet(_byInventoryType, uint32(INVTYPE_ROBE)) });
+        else
+            offerCandidates({ findSet(_byInventoryType, filter.InventoryType) });
+    }
+
+    if (nameIndex && searchedName.size() >= TRIGRAM_LENGTH)
+    {
+        for (std::size_t i = 0; i + TRIGRAM_LENGTH <= searchedName.size(); ++i)
+            offerCandidates({ findSet(nameIndex->Trigrams, MakeTrigram(searchedName[i], searchedName[i + 1], searchedName[i + 2])) });
+    }
+
+    auto curTime = GameTime::GetGameTime();
+
+    auto checkEntry = [&](uint32 slot)
+    {
+        IndexedAuction const& entry = _entries[slot];
+        if (!entry.Auction)
+            return;
+
+        // Skip expired auctions
+        if (entry.Auction->ExpireTime < curTime)
+            return;
+
+        ItemTemplate const* proto = entry.Proto;
+        if (filter.ItemClass != ANY_FILTER && proto->Class != filter.ItemClass)
+            return;
+
+        if (filter.ItemSubClass != ANY_FILTER && proto->SubClass != filter.ItemSubClass)
+            return;
+
+        if (filter.InventoryType != ANY_FILTER && proto->InventoryType != filter.InventoryType)
+        {
+            // xinef: exception, robes are counted as chests
+            if (filter.InventoryType != INVTYPE_CHEST || proto->InventoryType != INVTYPE_ROBE)
+                return;
+        }
+
+        if (filter.Quality != ANY_FILTER && proto->Quality < filter.Quality)
+            return;
+
+        if (filter.LevelMin != 0x00 && (proto->RequiredLevel < filter.LevelMin ||
+            (filter.LevelMax != 0x00 && proto->RequiredLevel > filter.LevelMax)))
+            return;
+
+        // Allow search by suffix (ie: of the Monkey) or partial name (ie: Monkey)
+        if (nameIndex)
+        {
+            std::wstring const& name = nameIndex->Names[slot];
+            if (name.empty() || name.find(searchedName) == std::wstring::npos)
+                return;
+        }
+
+        if (filter.Usable != 0x00)
+        {
+            Item* item = sAuctionMgr->GetAuctionItem(entry.Auction->ItemGuid);
+            if (!item || player->CanUseItem(item) != EQUIP_ERR_OK)
+                return;
+
+            // xinef: check already learded recipes and pets
+            if (proto->Spells[1].SpellTrigger == ITEM_SPELLTRIGGER_LEARN_SPELL_ID && player->HasSpell(proto->Spells[1].SpellId))
+                return;
+        }
+
+        result.emplace_back(entry.Auction);
+    };
+
+    if (hasCandidates)
+    {
+        result.reserve(result.size() + candidatesCount);
+
+        for (SlotSet const* set : candidates)
+            for (uint32 slot : *set)
+                checkEntry(slot);
+    }
+    else
+    {
+        result.reserve(result.size() + _slots.size());
+
+        for (uint32 slot = 0; slot < _entries.size(); ++slot)
+            checkEntry(slot);
+    }
+}
+
+AuctionSearchIndex::NameIndex& AuctionSearchIndex::GetNameIndex(LocaleConstant dbLocale, LocaleConstant dbcLocale)
+{
+    uint32 key = (uint32(dbLocale) << 8) | uint32(dbcLocale);
+
+    {
+        std::lock_guard<std::mutex> guard(_namesLock);
+
+        auto itr = _names.find(key);
+        if (itr != _names.end())
+            return itr->second;
+    }
+
+    // Build outside of the lock, searches in other locales don't have to wait
+    NameIndex index;
+    index.DbLocale = dbLocale;
+    index.DbcLocale = dbcLocale;
+
+    for (auto const& [auctionId, slot] : _slots)
+        AddName(index, slot);
+
+    std::lock_guard<std::mutex> guard(_namesLock);
+    return _names.try_emplace(key, std::move(index)).first->second;
+}
+
+void AuctionSearchIndex::AddName(NameIndex& index, uint32 slot)
+{
+    if (index.Names.size() < _entries.size())
+        index.Names.resize(_entries.size());
+
+    std::wstring& name = index.Names[slot];
+    name = BuildName(_entries[slot], index.DbLocale, index.DbcLocale);
+
+    for (std::size_t i = 0; i + TRIGRAM_LENGTH <= name.size(); ++i)
+        index.Trigrams[MakeTrigram(name[i], name[i + 1], name[i + 2])].insert(slot);
+}
+
+void AuctionSearchIndex::RemoveName(NameIndex& index, uint32 slot)
+{
+    if (slot >= index.Names.size())
+        return;
+
+    std::wstring& name = index.Names[slot];
+
+    for (std::size_t i = 0; i + TRIGRAM_LENGTH <= name.size(); ++i)
+    {
+        auto itr = index.Trigrams.find(MakeTrigram(name[i], name[i + 1], name[i + 2]));
+        if (itr == index.Trigrams.end())
+            continue;
+
+        itr->second.erase(slot);
+        if (itr->second.empty())
+            index.Trigrams.erase(itr);
+    }
+
+    name.clear();
+}
+
+std::wstring AuctionSearchIndex::BuildName(IndexedAuction const& entry, LocaleConstant dbLocale, LocaleConstant dbcLocale) const
+{
+    ItemTemplate const* proto = entry.Proto;
+
+    std::string name = proto->Name1;
+    if (name.empty())
+        return {};
+
+    // local name
+    if (dbLocale > LOCALE_enUS)
+        if (ItemLocale const* il = sGameLocale->GetItemLocale(proto->ItemId))
+            GameLocale::GetLocaleString(il->Name, dbLocale, name);
+
+    // DO NOT use GetItemEnchantMod(proto->RandomProperty) as it may return a result
+    //  that matches the search, but it may not equal item->GetItemRandomPropertyId()
+    //  used in BuildAuctionInfo() which then causes wrong items to be listed
+    if (int32 propRefID = entry.RandomPropertyId)
+    {
+        // Append the suffix to the name (ie: of the Monkey) if one exists
+        // These are found in ItemRandomSuffix.dbc and ItemRandomProperties.dbc
+        // even though the DBC name seems misleading
+        std::array<char const*, 16> const* suffix = nullptr;
+
+        if (propRefID < 0)
+        {
+            if (ItemRandomSuffixEntry const* itemRandEntry = sItemRandomSuffixStore.LookupEntry(-propRefID))
+                suffix = &itemRandEntry->Name;
+        }
+        else
+        {
+            if (ItemRandomPropertiesEntry const* itemRandEntry = sItemRandomPropertiesStore.LookupEntry(propRefID))
+                suffix = &itemRandEntry->Name;
+        }
+
+        // dbc local name
+        if (suffix)
+        {
+            name += ' ';
+            name += (*suffix)[dbcLocale];
+        }
+    }
+
+    std::wstring wname;
+    if (!Utf8toWStr(name, wname))
+        return {};
+
+    wstrToLower(wname);
+    return wname;
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WARHEAD_AUCTION_SEARCH_INDEX_H_
+#define WARHEAD_AUCTION_SEARCH_INDEX_H_
+
+#include "Common.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Item;
+class Player;
+struct AuctionEntry;
+struct AuctionListItems;
+struct ItemTemplate;
+
+/*
+ * Secondary index over the auctions of one auction house.
+ *
+ * Entries are kept in slots so the attribute indexes (class, class + subclass,
+ * inventory type) and the per-locale name indexes only store slot numbers.
+ * Name indexes are created the first time a locale searches the house and are
+ * kept up to date on every add/remove afterwards. Names are indexed by trigram,
+ * shorter search strings fall back to the cached lowercased names.
+ * AddAuction/RemoveAuction need the house locked exclusively, Search only shared.
+ */
+class WH_GAME_API AuctionSearchIndex
+{
+public:
+    AuctionSearchIndex() = default;
+    ~AuctionSearchIndex() = default;
+
+    void AddAuction(AuctionEntry* auction, Item* item);
+    void RemoveAuction(AuctionEntry* auction);
+
+    // Appends all auctions matching the filter, searchedName must already be lowercased
+    void Search(AuctionListItems const& filter, std::wstring const& searchedName, Player* player, std::vector<AuctionEntry*>& result);
+
+    [[nodiscard]] std::size_t GetSize() const { return _slots.size(); }
+
+private:
+    struct IndexedAuction
+    {
+        AuctionEntry* Auction{ nullptr };
+        ItemTemplate const* Proto{ nullptr };
+        int32 RandomPropertyId{};
+    };
+
+    struct NameIndex
+    {
+        LocaleConstant DbLocale{ LOCALE_enUS };
+        LocaleConstant DbcLocale{ LOCALE_enUS };
+        std::vector<std::wstring> Names;
+        std::unordered_map<uint64, std::unordered_set<uint32>> Trigrams;
+    };
+
+    using SlotSet = std::unordered_set<uint32>;
+
+    NameIndex& GetNameIndex(LocaleConstant dbLocale, LocaleConstant dbcLocale);
+    void AddName(NameIndex& index, uint32 slot);
+    void RemoveName(NameIndex& index, uint32 slot);
+    std::wstring BuildName(IndexedAuction const& entry, LocaleConstant dbLocale, LocaleConstant dbcLocale) const;
+
+    static uint64 MakeTrigram(wchar_t a, wchar_t b, wchar_t c);
+    static uint64 MakeSubClassKey(uint32 itemClass, uint32 itemSubClass) { return (uint64(itemClass) << 32) | itemSubClass; }
+
+    std::vector<IndexedAuction> _entries;
+    std::vector<uint32> _freeSlots;
+    std::unordered_map<uint32 /*auctionId*/, uint32 /*slot*/> _slots;
+
+    std::unordered_map<uint32, SlotSet> _byClass;
+    std::unordered_map<uint64, SlotSet> _bySubClass;
+    std::unordered_map<uint32, SlotSet> _byInventoryType;
+    std::unordered_map<uint32 /*dbLocale << 8 | dbcLocale*/, NameIndex> _names;
+    std::mutex _namesLock; // searches run concurrently and create missing name indexes
+};
+
+#endif
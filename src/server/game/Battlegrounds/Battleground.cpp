@@ -607,15 +607,17 @@ Position const* Battleground::GetTeamStartPosition(TeamId teamId) const
 
 void Battleground::SendPacketToAll(WorldPacket const* packet)
 {
+    SharedWorldPacket sharedPacket = std::make_shared<WorldPacket const>(*packet);
     for (BattlegroundPlayerMap::const_iterator itr = m_Players.begin(); itr != m_Players.end(); ++itr)
-        itr->second->GetSession()->SendPacket(packet);
+        itr->second->GetSession()->SendPacket(sharedPacket);
 }
 
 void Battleground::SendPacketToTeam(TeamId teamId, WorldPacket const* packet, Player* sender, bool self)
 {
+    SharedWorldPacket sharedPacket = std::make_shared<WorldPacket const>(*packet);
     for (BattlegroundPlayerMap::const_iterator itr = m_Players.begin(); itr != m_Players.end(); ++itr)
         if (itr->second->GetBgTeamId() == teamId && (self || sender != itr->second))
-            itr->second->GetSession()->SendPacket(packet);
+            itr->second->GetSession()->SendPacket(sharedPacket);
 }
 
 void Battleground::SendChatMessage(Creature* source, uint8 textId, WorldObject* target /*= nullptr*/)
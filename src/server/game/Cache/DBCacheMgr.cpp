@@ -16,11 +16,91 @@
  */
 
 #include "DBCacheMgr.h"
+#include "CryptoHash.h"
 #include "DatabaseEnv.h"
 #include "GameConfig.h"
 #include "Log.h"
 #include "StopWatch.h"
 #include "Util.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace
+{
+    constexpr uint32 SNAPSHOT_MAGIC = 0x43424457; // 'WDBC'
+    constexpr uint32 SNAPSHOT_VERSION = 1;
+
+    class SnapshotReader
+    {
+    public:
+        explicit SnapshotReader(std::string_view data) : _data(data) { }
+
+        template<typename T>
+        bool Read(T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            if (_data.size() < sizeof(T))
+                return false;
+
+            memcpy(&value, _data.data(), sizeof(T));
+            _data.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        bool Read(std::string& value)
+        {
+            std::string_view view;
+            if (!Read(view))
+                return false;
+
+            value = view;
+            return true;
+        }
+
+        bool Read(std::string_view& value)
+        {
+            uint64 size{};
+            if (!Read(size) || _data.size() < size)
+                return false;
+
+            value = _data.substr(0, size);
+            _data.remove_prefix(size);
+            return true;
+        }
+
+    private:
+        std::string_view _data;
+    };
+
+    class SnapshotWriter
+    {
+    public:
+        explicit SnapshotWriter(std::ostream& stream) : _stream(stream) { }
+
+        template<typename T>
+        void Write(T const& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            _stream.write(reinterpret_cast<char const*>(&value), sizeof(T));
+        }
+
+        void Write(std::string_view value)
+        {
+            Write(uint64(value.size()));
+            _stream.write(value.data(), value.size());
+        }
+
+        void Write(std::string const& value) { Write(std::string_view(value)); }
+
+    private:
+        std::ostream& _stream;
+    };
+}
 
 /*static*/ DBCacheMgr* DBCacheMgr::instance()
 {
@@ -38,7 +118,18 @@ void DBCacheMgr::Initialize()
     _isEnableWaitAtAdd = CONF_GET_BOOL("DBCache.WaitAtAdd.Enable");
 
     InitializeDefines();
-    InitializeQuery();
+
+    if (CONF_GET_BOOL("DBCache.Snapshot.Enable"))
+    {
+        _snapshotFile = CONF_GET_STR("DBCache.Snapshot.File");
+        _snapshotChecksum = CalculateSnapshotChecksum();
+        _isSnapshotLoaded = LoadSnapshot();
+        _isSnapshotRecording = !_isSnapshotLoaded;
+    }
+
+    // Everything comes from the snapshot, no need to query the database
+    if (!_isSnapshotLoaded)
+        InitializeQuery();
 
     LOG_INFO("server.loading", ">> Initialized database cache in {}", sw);
     LOG_INFO("server.loading", "");
@@ -73,6 +164,31 @@ void DBCacheMgr::AddQuery(DBCacheTable index)
 }
 
 QueryResult DBCacheMgr::GetResult(DBCacheTable index)
+{
+    if (_isSnapshotLoaded)
+    {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+
+            auto const& itr = _snapshot.find(index);
+            if (itr != _snapshot.end())
+                return GetSnapshotResult(itr->second);
+        }
+
+        // Not requested during the startup the snapshot was made at
+        auto sql{ GetStringQuery(index) };
+        return sql.empty() ? nullptr : WorldDatabase.Query(sql);
+    }
+
+    auto result{ GetDatabaseResult(index) };
+
+    if (_isSnapshotRecording)
+        return StoreSnapshotResult(index, std::move(result));
+
+    return result;
+}
+
+QueryResult DBCacheMgr::GetDatabaseResult(DBCacheTable index)
 {
     if (!_isEnableAsyncLoad)
     {
@@ -86,8 +202,21 @@ QueryResult DBCacheMgr::GetResult(DBCacheTable index)
         return WorldDatabase.Query(sql);
     }
 
-    auto const& itr = _queryList.find(index);
-    if (itr == _queryList.end())
+    // Loaders may run in parallel, only take the future under the lock and wait without it
+    QueryResultFuture future;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+
+        auto itr = _queryList.find(index);
+        if (itr != _queryList.end())
+        {
+            future = std::move(itr->second);
+            _queryList.erase(itr);
+        }
+    }
+
+    if (!future.valid())
     {
         LOG_ERROR("db.async", "Not found query with index {}", AsUnderlyingType(index));
 
@@ -101,12 +230,242 @@ QueryResult DBCacheMgr::GetResult(DBCacheTable index)
         return WorldDatabase.Query(sql);
     }
 
-    itr->second.wait();
-    auto result{ itr->second.get() };
-    _queryList.erase(index);
+    future.wait();
+    return future.get();
+}
+
+void DBCacheMgr::FinishLoading()
+{
+    if (_isSnapshotRecording)
+        SaveSnapshot();
+
+    _isSnapshotLoaded = false;
+    _isSnapshotRecording = false;
+    _snapshot.clear();
+}
+
+DBCacheMgr::SnapshotChecksum DBCacheMgr::CalculateSnapshotChecksum()
+{
+    Warhead::Crypto::SHA1 hash;
+
+    auto updateHash = [&hash](QueryResult result)
+    {
+        if (!result)
+            return;
+
+        do
+        {
+            for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+            {
+                hash.UpdateData((*result)[i].Get<std::string_view>());
+                hash.UpdateData("\t");
+            }
+        } while (result->NextRow());
+    };
+
+    // Changed queries change the layout of the results
+    for (std::size_t i = 0; i < AsUnderlyingType(DBCacheTable::Max); ++i)
+        hash.UpdateData(GetStringQuery(static_cast<DBCacheTable>(i)));
+
+    // Applied updates of the db updater
+    updateHash(WorldDatabase.Query("SELECT `name`, `hash` FROM `updates` ORDER BY `name`"));
+
+    // Manual changes don't show up in the updates table, only checksumming the tables notices them reliably
+    if (!sGameConfig->GetOption<bool>("DBCache.Snapshot.ChecksumTables", true))
+    {
+        // UPDATE_TIME is cached for information_schema_stats_expiry and lost on a mysql server restart, best effort only
+        updateHash(WorldDatabase.Query("SELECT `TABLE_NAME`, `UPDATE_TIME` FROM `information_schema`.`TABLES` WHERE `TABLE_SCHEMA` = DATABASE() ORDER BY `TABLE_NAME`"));
+    }
+    else
+    {
+        std::string tables;
+
+        if (QueryResult result = WorldDatabase.Query("SELECT `TABLE_NAME` FROM `information_schema`.`TABLES` WHERE `TABLE_SCHEMA` = DATABASE() AND `TABLE_TYPE` = 'BASE TABLE' ORDER BY `TABLE_NAME`"))
+        {
+            do
+            {
+                if (!tables.empty())
+                    tables += ", ";
+
+                tables += Warhead::StringFormat("`{}`", (*result)[0].Get<std::string_view>());
+            } while (result->NextRow());
+        }
+
+        if (!tables.empty())
+            updateHash(WorldDatabase.Query("CHECKSUM TABLE " + tables));
+    }
+
+    hash.Finalize();
+    return hash.GetDigest();
+}
+
+bool DBCacheMgr::LoadSnapshot()
+{
+    std::error_code error;
+    if (!std::filesystem::exists(_snapshotFile, error))
+    {
+        LOG_INFO("server.loading", ">> Database snapshot '{}' not found, it will be created", _snapshotFile);
+        return false;
+    }
+
+    std::shared_ptr<boost::interprocess::mapped_region> region;
+
+    try
+    {
+        boost::interprocess::file_mapping file(_snapshotFile.c_str(), boost::interprocess::read_only);
+        region = std::make_shared<boost::interprocess::mapped_region>(file, boost::interprocess::read_only);
+    }
+    catch (boost::interprocess::interprocess_exception const& e)
+    {
+        LOG_ERROR("server.loading", "Unable to map database snapshot '{}': {}", _snapshotFile, e.what());
+        return false;
+    }
+
+    SnapshotReader reader({ static_cast<char const*>(region->get_address()), region->get_size() });
+
+    uint32 magic{}, version{}, tableCount{};
+    SnapshotChecksum checksum{};
+
+    if (!reader.Read(magic) || magic != SNAPSHOT_MAGIC || !reader.Read(version) || version != SNAPSHOT_VERSION)
+    {
+        LOG_INFO("server.loading", ">> Database snapshot '{}' has another format, it will be rebuilt", _snapshotFile);
+        return false;
+    }
+
+    if (!reader.Read(checksum) || checksum != _snapshotChecksum)
+    {
+        LOG_INFO("server.loading", ">> World database changed since database snapshot '{}' was made, it will be rebuilt", _snapshotFile);
+        return false;
+    }
+
+    if (!reader.Read(tableCount))
+        return false;
+
+    for (uint32 i = 0; i < tableCount; ++i)
+    {
+        uint32 index{}, fieldCount{};
+        SnapshotTable table;
+
+        bool isCorrect = reader.Read(index) && index < AsUnderlyingType(DBCacheTable::Max) && reader.Read(table.RowCount) && reader.Read(fieldCount);
+
+        for (uint32 field = 0; isCorrect && field < fieldCount; ++field)
+        {
+            QueryResultFieldMetadata& meta = table.FieldMetadata.emplace_back();
+            meta.Index = field;
+            isCorrect = reader.Read(meta.Type) && reader.Read(meta.TableName) && reader.Read(meta.TableAlias) &&
+                reader.Read(meta.Name) && reader.Read(meta.Alias) && reader.Read(meta.TypeName);
+        }
+
+        if (!isCorrect || !reader.Read(table.Rows))
+        {
+            LOG_ERROR("server.loading", "Database snapshot '{}' is corrupted, it will be rebuilt", _snapshotFile);
+            _snapshot.clear();
+            return false;
+        }
+
+        table.Storage = region;
+        _snapshot.emplace(static_cast<DBCacheTable>(index), std::move(table));
+    }
+
+    LOG_INFO("server.loading", ">> Loaded {} tables from database snapshot '{}'", _snapshot.size(), _snapshotFile);
+    return true;
+}
+
+void DBCacheMgr::SaveSnapshot()
+{
+    StopWatch sw;
+
+    std::string const tempFile = _snapshotFile + ".tmp";
+
+    {
+        std::ofstream stream(tempFile, std::ios::binary | std::ios::trunc);
+        if (!stream)
+        {
+            LOG_ERROR("server.loading", "Unable to create database snapshot '{}'", tempFile);
+            return;
+        }
+
+        SnapshotWriter writer(stream);
+        writer.Write(SNAPSHOT_MAGIC);
+        writer.Write(SNAPSHOT_VERSION);
+        writer.Write(_snapshotChecksum);
+        writer.Write(uint32(_snapshot.size()));
+
+        for (auto const& [index, table] : _snapshot)
+        {
+            writer.Write(uint32(AsUnderlyingType(index)));
+            writer.Write(table.RowCount);
+            writer.Write(uint32(table.FieldMetadata.size()));
+
+            for (auto const& meta : table.FieldMetadata)
+            {
+                writer.Write(meta.Type);
+                writer.Write(meta.TableName);
+                writer.Write(meta.TableAlias);
+                writer.Write(meta.Name);
+                writer.Write(meta.Alias);
+                writer.Write(meta.TypeName);
+            }
+
+            writer.Write(table.Rows);
+        }
+
+        if (!stream)
+        {
+            LOG_ERROR("server.loading", "Unable to write database snapshot '{}'", tempFile);
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFile, _snapshotFile, error);
+    if (error)
+    {
+        LOG_ERROR("server.loading", "Unable to replace database snapshot '{}': {}", _snapshotFile, error.message());
+        return;
+    }
+
+    LOG_INFO("server.loading", ">> Saved {} tables to database snapshot '{}' in {}", _snapshot.size(), _snapshotFile, sw);
+}
+
+QueryResult DBCacheMgr::GetSnapshotResult(SnapshotTable const& table)
+{
+    if (!table.RowCount)
+        return nullptr;
+
+    auto result = std::make_shared<ResultSet>(table.FieldMetadata, table.RowCount, table.Rows, table.Storage);
+    result->NextRow();
     return result;
 }
 
+QueryResult DBCacheMgr::StoreSnapshotResult(DBCacheTable index, QueryResult result)
+{
+    auto rows = std::make_shared<std::string>();
+
+    SnapshotTable table;
+
+    if (result)
+    {
+        table.FieldMetadata = result->GetFieldMetadata();
+        table.RowCount = result->GetRowCount();
+
+        do
+        {
+            result->WriteStoredRow(*rows);
+        } while (result->NextRow());
+    }
+
+    table.Rows = *rows;
+    table.Storage = std::move(rows);
+
+    // The mysql result is consumed, hand out a copy of the stored rows
+    auto snapshotResult{ GetSnapshotResult(table) };
+
+    std::lock_guard<std::mutex> guard(_lock);
+    _snapshot.insert_or_assign(index, std::move(table));
+    return snapshotResult;
+}
+
 std::string_view DBCacheMgr::GetStringQuery(DBCacheTable index)
 {
     auto const& itr = _queryStrings.find(index);
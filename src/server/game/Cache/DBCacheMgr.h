@@ -20,9 +20,14 @@
 
 #include "DBCacheStrings.h"
 #include "DatabaseEnvFwd.h"
+#include "Field.h"
+#include <array>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 class WH_GAME_API DBCacheMgr
 {
@@ -35,9 +40,32 @@ public:
     void Initialize();
 
     void AddQuery(DBCacheTable index);
-    QueryResult GetResult(DBCacheTable index);
+    QueryResult GetResult(DBCacheTable index); // Thread safe
+
+    // Called once the world is loaded. Writes the snapshot if it was rebuilt during this startup,
+    // later results (reload commands) always come from the database
+    void FinishLoading();
 
 private:
+    // Binary copy of the startup results, valid as long as the world database checksum matches
+    struct SnapshotTable
+    {
+        std::vector<QueryResultFieldMetadata> FieldMetadata;
+        uint64 RowCount{};
+        std::string_view Rows;
+        std::shared_ptr<void const> Storage;
+    };
+
+    using SnapshotChecksum = std::array<uint8, 20>; // SHA1 digest
+
+    QueryResult GetDatabaseResult(DBCacheTable index);
+
+    SnapshotChecksum CalculateSnapshotChecksum();
+    bool LoadSnapshot();
+    void SaveSnapshot();
+    QueryResult GetSnapshotResult(SnapshotTable const& table);
+    QueryResult StoreSnapshotResult(DBCacheTable index, QueryResult result);
+
     void InitializeDefines();
     void InitializeQuery();
 
@@ -56,11 +84,19 @@ private:
 
     std::string_view GetStringQuery(DBCacheTable index);
 
+    // Guards the pending queries and the snapshot tables, results are requested by parallel loaders
+    std::mutex _lock;
     std::unordered_map<DBCacheTable, QueryResultFuture> _queryList;
     std::unordered_map<DBCacheTable, std::string> _queryStrings;
     bool _isEnableAsyncLoad{};
     bool _isEnableWaitAtAdd{};
 
+    std::unordered_map<DBCacheTable, SnapshotTable> _snapshot;
+    std::string _snapshotFile;
+    SnapshotChecksum _snapshotChecksum{};
+    bool _isSnapshotLoaded{};
+    bool _isSnapshotRecording{};
+
     DBCacheMgr(DBCacheMgr const&) = delete;
     DBCacheMgr(DBCacheMgr&&) = delete;
     DBCacheMgr& operator=(DBCacheMgr const&) = delete;
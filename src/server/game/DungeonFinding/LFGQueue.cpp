@@ -35,6 +35,57 @@ namespace lfg
     LfgQueueData::LfgQueueData() :
         joinTime(time_t(GameTime::GetGameTime().count())), lastRefreshTime(joinTime) { }
 
+    LfgQueueData::LfgQueueData(time_t _joinTime, LfgDungeonSet _dungeons, LfgRolesMap _roles) :
+        joinTime(_joinTime), lastRefreshTime(_joinTime), tanks(LFG_TANKS_NEEDED), healers(LFG_HEALERS_NEEDED),
+        dps(LFG_DPS_NEEDED), dungeons(std::move(_dungeons)), roles(std::move(_roles))
+    {
+        roleMask = BuildRoleMask(roles);
+        dungeonMask = BuildDungeonMask(dungeons);
+    }
+
+    uint32 LfgQueueData::BuildRoleMask(LfgRolesMap const& roles)
+    {
+        uint32 mask = 0;
+        for (auto const& [guid, role] : roles)
+        {
+            switch (role & ~PLAYER_ROLE_LEADER)
+            {
+                case PLAYER_ROLE_NONE:
+                    mask += 1 << ROLE_MASK_NONE_SHIFT;
+                    break;
+                case PLAYER_ROLE_TANK:
+                    mask += 1 << ROLE_MASK_TANK_SHIFT;
+                    break;
+                case PLAYER_ROLE_HEALER:
+                    mask += 1 << ROLE_MASK_HEALER_SHIFT;
+                    break;
+                case PLAYER_ROLE_DAMAGE:
+                    mask += 1 << ROLE_MASK_DPS_SHIFT;
+                    break;
+                default: // more than one role selected, decided by LFGMgr::CheckGroupRoles
+                    break;
+            }
+        }
+        return mask;
+    }
+
+    uint64 LfgQueueData::BuildDungeonMask(LfgDungeonSet const& dungeons)
+    {
+        uint64 mask = 0;
+        for (uint32 dungeon : dungeons)
+            mask |= uint64(1) << (dungeon % 64);
+        return mask;
+    }
+
+    bool LfgQueueData::CanFitRoles(uint32 roleMask)
+    {
+        // a sum of at most MAXGROUPSIZE players never overflows a 4 bit field
+        return ((roleMask >> ROLE_MASK_NONE_SHIFT) & 0xF) == 0
+            && ((roleMask >> ROLE_MASK_TANK_SHIFT) & 0xF) <= LFG_TANKS_NEEDED
+            && ((roleMask >> ROLE_MASK_HEALER_SHIFT) & 0xF) <= LFG_HEALERS_NEEDED
+            && ((roleMask >> ROLE_MASK_DPS_SHIFT) & 0xF) <= LFG_DPS_NEEDED;
+    }
+
     void LFGQueue::AddToQueue(ObjectGuid guid, bool failedProposal)
     {
         LOG_DEBUG("lfg", "ADD AddToQueue: {}, failed proposal: {}", guid.ToString(), failedProposal ? 1 : 0);
@@ -266,6 +317,9 @@ namespace lfg
         uint8 numLfgGroups = 0;
         ObjectGuid guid;
         uint64 addToFoundMask = 0;
+        uint32 roleMask = 0;
+        uint64 dungeonMask = ~uint64(0);
+        std::array<LfgQueueData*, 5> queueData = { };
 
         for (uint8 i = 0; i < 5 && !(guid = check.guids[i]).IsEmpty() && numLfgGroups < 2 && numPlayers <= MAXGROUPSIZE; ++i)
         {
@@ -277,6 +331,10 @@ namespace lfg
                 return LFG_COMPATIBILITY_PENDING;
             }
 
+            queueData[i] = &itQueue->second;
+            roleMask += itQueue->second.roleMask;
+            dungeonMask &= itQueue->second.dungeonMask;
+
             // Store group so we don't need to call Mgr to get it later (if it's player group will be 0 otherwise would have joined as group)
             for (LfgRolesMap::const_iterator it2 = itQueue->second.roles.begin(); it2 != itQueue->second.roles.end(); ++it2)
                 proposalGroups[it2->first] = itQueue->first.IsGroup() ? itQueue->first : ObjectGuid::Empty;
@@ -315,9 +373,16 @@ namespace lfg
         // If it's single group no need to check for duplicate players, ignores, bad roles or bad dungeons as it's been checked before joining
         if (check.size() > 1)
         {
+            // cheap rejections first, the masks can only tell for sure that there is no valid combination
+            if (!LfgQueueData::CanFitRoles(roleMask))
+                return LFG_INCOMPATIBLES_NO_ROLES;
+
+            if (!dungeonMask)
+                return LFG_INCOMPATIBLES_NO_DUNGEONS;
+
             for (uint8 i = 0; i < 5 && check.guids[i]; ++i)
             {
-                const LfgRolesMap& roles = QueueDataStore[check.guids[i]].roles;
+                const LfgRolesMap& roles = queueData[i]->roles;
                 for (LfgRolesMap::const_iterator itRoles = roles.begin(); itRoles != roles.end(); ++itRoles)
                 {
                     LfgRolesMap::const_iterator itPlayer;
@@ -370,11 +435,11 @@ namespace lfg
             else
                 addToFoundMask |= (((uint64)1) << (roleCheckResult - 1));
 
-            proposalDungeons = QueueDataStore[check.front()].dungeons;
+            proposalDungeons = queueData[0]->dungeons;
             for (uint8 i = 1; i < 5 && check.guids[i]; ++i)
             {
                 LfgDungeonSet temporal;
-                LfgDungeonSet& dungeons = QueueDataStore[check.guids[i]].dungeons;
+                LfgDungeonSet& dungeons = queueData[i]->dungeons;
                 std::set_intersection(proposalDungeons.begin(), proposalDungeons.end(), dungeons.begin(), dungeons.end(), std::inserter(temporal, temporal.begin()));
                 proposalDungeons = temporal;
             }
@@ -384,8 +449,7 @@ namespace lfg
         }
         else
         {
-            ObjectGuid gguid = check.front();
-            const LfgQueueData& queue = QueueDataStore[gguid];
+            const LfgQueueData& queue = *queueData[0];
             proposalDungeons = queue.dungeons;
             proposalRoles = queue.roles;
             LFGMgr::CheckGroupRoles(proposalRoles);          // assing new roles
@@ -41,9 +41,18 @@ namespace lfg
     {
         LfgQueueData();
 
-        LfgQueueData(time_t _joinTime, LfgDungeonSet  _dungeons, LfgRolesMap  _roles):
-            joinTime(_joinTime), lastRefreshTime(_joinTime), tanks(LFG_TANKS_NEEDED), healers(LFG_HEALERS_NEEDED),
-            dps(LFG_DPS_NEEDED), dungeons(std::move(_dungeons)), roles(std::move(_roles)) { }
+        LfgQueueData(time_t _joinTime, LfgDungeonSet  _dungeons, LfgRolesMap  _roles);
+
+        // Packs the number of players that selected only one role into 4 bit fields (tank, healer, dps, none),
+        // so the masks of up to 5 queued entries can be summed and checked without any role permutation
+        static constexpr uint32 ROLE_MASK_TANK_SHIFT = 0;
+        static constexpr uint32 ROLE_MASK_HEALER_SHIFT = 4;
+        static constexpr uint32 ROLE_MASK_DPS_SHIFT = 8;
+        static constexpr uint32 ROLE_MASK_NONE_SHIFT = 12;
+
+        static uint32 BuildRoleMask(LfgRolesMap const& roles);
+        static uint64 BuildDungeonMask(LfgDungeonSet const& dungeons);
+        static bool CanFitRoles(uint32 roleMask);
 
         time_t joinTime;                                       // Player queue join time (to calculate wait times)
         time_t lastRefreshTime;                                // pussywizard
@@ -53,6 +62,8 @@ namespace lfg
         LfgDungeonSet dungeons;                                // Selected Player/Group Dungeon/s
         LfgRolesMap roles;                                     // Selected Player Role/s
         Lfg5Guids bestCompatible;                              // Best compatible combination of people queued
+        uint32 roleMask{0};                                    // Players with a single selected role, see BuildRoleMask
+        uint64 dungeonMask{0};                                 // One bit per (dungeon id % 64), disjoint masks = no common dungeon
     };
 
     struct LfgWaitTime
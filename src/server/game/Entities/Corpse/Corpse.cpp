@@ -48,7 +48,10 @@ void Corpse::AddToWorld()
 {
     ///- Register the corpse for guid lookup
     if (!IsInWorld())
+    {
+        auto guard = GetMap()->LockForRegionUpdate();
         GetMap()->GetObjectsStore().Insert<Corpse>(GetGUID(), this);
+    }
 
     Object::AddToWorld();
 }
@@ -57,7 +60,10 @@ void Corpse::RemoveFromWorld()
 {
     ///- Remove the corpse from the accessor
     if (IsInWorld())
+    {
+        auto guard = GetMap()->LockForRegionUpdate();
         GetMap()->GetObjectsStore().Remove<Corpse>(GetGUID());
+    }
 
     WorldObject::RemoveFromWorld();
 }
@@ -213,7 +219,8 @@ void Corpse::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* targe
     uint32* flags = nullptr;
     uint32 visibleFlag = GetUpdateFieldData(target, flags);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    UpdateMask fields = GetValuesUpdateFields(updateType, flags);
+    for (uint32 index = fields.GetNextBit(0); index < m_valuesCount; index = fields.GetNextBit(index + 1))
     {
         if (_fieldNotifyFlags & flags[index] || ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)))
         {
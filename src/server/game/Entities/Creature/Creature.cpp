@@ -270,10 +270,13 @@ void Creature::AddToWorld()
         // it's also initialized in AIM_Initialize(), few lines below, but it's not a problem
         Motion_Initialize();
 
-        GetMap()->GetObjectsStore().Insert<Creature>(GetGUID(), this);
-        if (m_spawnId)
         {
-            GetMap()->GetCreatureBySpawnIdStore().insert(std::make_pair(m_spawnId, this));
+            auto guard = GetMap()->LockForRegionUpdate();
+            GetMap()->GetObjectsStore().Insert<Creature>(GetGUID(), this);
+            if (m_spawnId)
+            {
+                GetMap()->GetCreatureBySpawnIdStore().insert(std::make_pair(m_spawnId, this));
+            }
         }
         Unit::AddToWorld();
 
@@ -314,6 +317,7 @@ void Creature::RemoveFromWorld()
 
         Unit::RemoveFromWorld();
 
+        auto guard = GetMap()->LockForRegionUpdate();
         if (m_spawnId)
             Warhead::Containers::MultimapErasePair(GetMap()->GetCreatureBySpawnIdStore(), m_spawnId, this);
 
@@ -1681,6 +1685,7 @@ bool Creature::LoadCreatureFromDB(ObjectGuid::LowType spawnId, Map* map, bool ad
     {
         // If an alive instance of this spawnId is already found, skip creation
         // If only dead instance(s) exist, despawn them and spawn a new (maybe also dead) version
+        auto guard = map->LockForRegionUpdate();
         const auto creatureBounds = map->GetCreatureBySpawnIdStore().equal_range(spawnId);
         std::vector <Creature*> despawnList;
 
@@ -65,7 +65,10 @@ void DynamicObject::AddToWorld()
     ///- Register the dynamicObject for guid lookup and for caster
     if (!IsInWorld())
     {
-        GetMap()->GetObjectsStore().Insert<DynamicObject>(GetGUID(), this);
+        {
+            auto guard = GetMap()->LockForRegionUpdate();
+            GetMap()->GetObjectsStore().Insert<DynamicObject>(GetGUID(), this);
+        }
 
         WorldObject::AddToWorld();
 
@@ -95,6 +98,7 @@ void DynamicObject::RemoveFromWorld()
 
         WorldObject::RemoveFromWorld();
 
+        auto guard = GetMap()->LockForRegionUpdate();
         GetMap()->GetObjectsStore().Remove<DynamicObject>(GetGUID());
     }
 }
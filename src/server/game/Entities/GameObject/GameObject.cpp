@@ -161,9 +161,12 @@ void GameObject::AddToWorld()
         if (m_zoneScript)
             m_zoneScript->OnGameObjectCreate(this);
 
-        GetMap()->GetObjectsStore().Insert<GameObject>(GetGUID(), this);
-        if (m_spawnId)
-            GetMap()->GetGameObjectBySpawnIdStore().insert(std::make_pair(m_spawnId, this));
+        {
+            auto guard = GetMap()->LockForRegionUpdate();
+            GetMap()->GetObjectsStore().Insert<GameObject>(GetGUID(), this);
+            if (m_spawnId)
+                GetMap()->GetGameObjectBySpawnIdStore().insert(std::make_pair(m_spawnId, this));
+        }
 
         if (m_model)
         {
@@ -208,6 +211,7 @@ void GameObject::RemoveFromWorld()
 
         WorldObject::RemoveFromWorld();
 
+        auto guard = GetMap()->LockForRegionUpdate();
         if (m_spawnId)
             Warhead::Containers::MultimapErasePair(GetMap()->GetGameObjectBySpawnIdStore(), m_spawnId, this);
         GetMap()->GetObjectsStore().Remove<GameObject>(GetGUID());
@@ -2682,6 +2686,9 @@ void GameObject::EnableCollision(bool enable)
         phaseMask = GetPhaseMask();
 
     m_model->enable(phaseMask);
+
+    if (IsInWorld())
+        GetMap()->NotifyGameObjectModelChanged();
 }
 
 void GameObject::UpdateModel()
@@ -2825,7 +2832,11 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* t
     if (GetOwnerGUID() == target->GetGUID())
         visibleFlag |= UF_FLAG_OWNER;
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    UpdateMask fields = GetValuesUpdateFields(updateType, flags);
+    if (forcedFlags)
+        fields.SetBit(GAMEOBJECT_FLAGS);
+
+    for (uint32 index = fields.GetNextBit(0); index < m_valuesCount; index = fields.GetNextBit(index + 1))
     {
         if (_fieldNotifyFlags & flags[index] ||
                 ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
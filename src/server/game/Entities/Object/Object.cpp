@@ -259,8 +259,19 @@ void Object::SendUpdateToPlayer(Player* player)
     player->GetSession()->SendPacket(&packet);
 }
 
-void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateCache* cache) const
 {
+    ValuesUpdateClass updateClass;
+    bool shared = cache && GetValuesUpdateClass(target, updateClass);
+    if (shared)
+    {
+        if (ByteBuffer const* block = cache->Find(updateClass))
+        {
+            data->AddUpdateBlock(*block);
+            return;
+        }
+    }
+
     ByteBuffer buf(500);
 
     buf << (uint8) UPDATETYPE_VALUES;
@@ -269,6 +280,9 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
     BuildValuesUpdate(UPDATETYPE_VALUES, &buf, target);
 
     data->AddUpdateBlock(buf);
+
+    if (shared)
+        cache->Add(updateClass, buf);
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
@@ -511,7 +525,8 @@ void Object::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* targe
     uint32* flags = nullptr;
     uint32 visibleFlag = GetUpdateFieldData(target, flags);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+    UpdateMask fields = GetValuesUpdateFields(updateType, flags);
+    for (uint32 index = fields.GetNextBit(0); index < m_valuesCount; index = fields.GetNextBit(index + 1))
     {
         if (_fieldNotifyFlags & flags[index] ||
                 ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)))
@@ -526,6 +541,30 @@ void Object::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* targe
     data->append(fieldBuffer);
 }
 
+UpdateMask Object::GetValuesUpdateFields(uint8 updateType, uint32 const* flags) const
+{
+    UpdateMask fields;
+
+    // Create blocks contain every non-zero field
+    if (updateType != UPDATETYPE_VALUES)
+    {
+        fields.SetCount(m_valuesCount);
+        fields.SetAll();
+        return fields;
+    }
+
+    // Values blocks only the changed ones and the ones always sent because of _fieldNotifyFlags
+    if (_fieldNotifyFlags)
+    {
+        fields = GetUpdateFieldsWithFlags(flags, _fieldNotifyFlags);
+        fields |= _changesMask;
+    }
+    else
+        fields = _changesMask;
+
+    return fields;
+}
+
 void Object::AddToObjectUpdateIfNeeded()
 {
     if (m_inWorld && !m_objectUpdated)
@@ -547,7 +586,7 @@ void Object::ClearUpdateMask(bool remove)
     }
 }
 
-void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
+void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map, ValuesUpdateCache* cache) const
 {
     UpdateDataMapType::iterator iter = data_map.find(player);
 
@@ -558,7 +597,7 @@ void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) cons
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first, cache);
 }
 
 uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
@@ -2926,6 +2965,7 @@ struct WorldObjectChangeAccumulator
     UpdateDataMapType& i_updateDatas;
     UpdatePlayerSet& i_playerSet;
     WorldObject& i_object;
+    ValuesUpdateCache i_valuesCache; // blocks built for this object during this pass, one per observer class
     WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d, UpdatePlayerSet& p) : i_updateDatas(d), i_playerSet(p), i_object(obj)
     {
         i_playerSet.clear();
@@ -2986,7 +3026,7 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (i_playerSet.find(player->GetGUID()) == i_playerSet.end() && player->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(player, i_updateDatas);
+            i_object.BuildFieldsUpdate(player, i_updateDatas, &i_valuesCache);
             i_playerSet.insert(player->GetGUID());
         }
     }
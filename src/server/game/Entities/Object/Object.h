@@ -123,7 +123,7 @@ public:
     virtual void BuildCreateUpdateBlockForPlayer(UpdateData* data, Player* target) const;
     void SendUpdateToPlayer(Player* player);
 
-    void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+    void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateCache* cache = nullptr) const;
     void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
     void BuildMovementUpdateBlock(UpdateData* data, uint32 flags = 0) const;
 
@@ -182,7 +182,7 @@ public:
     [[nodiscard]] virtual bool hasQuest(uint32 /* quest_id */) const { return false; }
     [[nodiscard]] virtual bool hasInvolvedQuest(uint32 /* quest_id */) const { return false; }
     virtual void BuildUpdate(UpdateDataMapType&, UpdatePlayerSet&) {}
-    void BuildFieldsUpdate(Player*, UpdateDataMapType&) const;
+    void BuildFieldsUpdate(Player*, UpdateDataMapType&, ValuesUpdateCache* cache = nullptr) const;
 
     void SetFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags |= flag; }
     void RemoveFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags &= ~flag; }
@@ -220,9 +220,12 @@ protected:
     bool _LoadIntoDataField(std::string const& data, uint32 startOffset, uint32 count);
 
     uint32 GetUpdateFieldData(Player const* target, uint32*& flags) const;
+    UpdateMask GetValuesUpdateFields(uint8 updateType, uint32 const* flags) const; // fields worth visiting in BuildValuesUpdate
 
     void BuildMovementUpdate(ByteBuffer* data, uint16 flags) const;
     virtual void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const;
+    // false when the values update block of this object can't be shared with other observers
+    [[nodiscard]] virtual bool GetValuesUpdateClass(Player* /*target*/, ValuesUpdateClass& /*updateClass*/) const { return false; }
 
     uint16 m_objectType;
 
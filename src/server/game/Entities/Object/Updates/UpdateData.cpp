@@ -156,3 +156,18 @@ void UpdateData::Clear()
     m_outOfRangeGUIDs.clear();
     m_blockCount = 0;
 }
+
+ByteBuffer const* ValuesUpdateCache::Find(ValuesUpdateClass const& updateClass) const
+{
+    // only a handful of classes exist per object (self, owner, group, everyone else)
+    for (auto const& [blockClass, block] : _blocks)
+        if (blockClass == updateClass)
+            return &block;
+
+    return nullptr;
+}
+
+void ValuesUpdateCache::Add(ValuesUpdateClass const& updateClass, ByteBuffer const& block)
+{
+    _blocks.emplace_back(updateClass, block);
+}
@@ -20,6 +20,8 @@
 
 #include "ByteBuffer.h"
 #include "ObjectGuid.h"
+#include <array>
+#include <vector>
 
 class WorldPacket;
 
@@ -67,4 +69,27 @@ protected:
 
     void Compress(void* dst, uint32* dst_size, void* src, int src_size);
 };
+
+// Observers with equal classes receive byte identical values update blocks for an object:
+// same visibility flags and same value for every field that is rewritten per target
+struct ValuesUpdateClass
+{
+    static constexpr std::size_t MAX_TARGET_VALUES = 8;
+
+    uint32 VisibleFlag = 0;
+    std::array<uint32, MAX_TARGET_VALUES> TargetValues = { };
+
+    bool operator==(ValuesUpdateClass const& right) const = default;
+};
+
+// Values update blocks of a single object built during one update pass, reused for every observer of the same class
+class WH_GAME_API ValuesUpdateCache
+{
+public:
+    [[nodiscard]] ByteBuffer const* Find(ValuesUpdateClass const& updateClass) const;
+    void Add(ValuesUpdateClass const& updateClass, ByteBuffer const& block);
+
+private:
+    std::vector<std::pair<ValuesUpdateClass, ByteBuffer>> _blocks;
+};
 #endif
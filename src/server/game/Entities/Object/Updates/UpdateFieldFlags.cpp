@@ -19,6 +19,7 @@
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 
 #include "UpdateFieldFlags.h"
+#include <bit>
 
 uint32 ItemUpdateFieldFlags[CONTAINER_END] =
 {
@@ -1569,3 +1570,65 @@ uint32 CorpseUpdateFieldFlags[CORPSE_END] =
     UF_FLAG_DYNAMIC,                                        // CORPSE_FIELD_DYNAMIC_FLAGS
     UF_FLAG_NONE,                                           // CORPSE_FIELD_PAD
 };
+
+namespace
+{
+    constexpr uint32 UPDATE_FIELD_FLAG_COUNT = std::bit_width(uint32(UF_FLAG_DYNAMIC));
+
+    class UpdateFieldFlagMasks
+    {
+    public:
+        UpdateFieldFlagMasks(uint32 const* flags, uint32 count)
+        {
+            for (uint32 bit = 0; bit < UPDATE_FIELD_FLAG_COUNT; ++bit)
+            {
+                _masks[bit].SetCount(count);
+
+                for (uint32 index = 0; index < count; ++index)
+                    if (flags[index] & (1 << bit))
+                        _masks[bit].SetBit(index);
+            }
+        }
+
+        UpdateMask Get(uint32 flag) const
+        {
+            // Usually a single flag (UF_FLAG_DYNAMIC), no need to combine anything
+            if (std::has_single_bit(flag))
+                return _masks[std::countr_zero(flag)];
+
+            UpdateMask mask;
+            mask.SetCount(_masks[0].GetCount());
+
+            for (uint32 bit = 0; bit < UPDATE_FIELD_FLAG_COUNT; ++bit)
+                if (flag & (1 << bit))
+                    mask |= _masks[bit];
+
+            return mask;
+        }
+
+    private:
+        std::array<UpdateMask, UPDATE_FIELD_FLAG_COUNT> _masks;
+    };
+}
+
+UpdateMask GetUpdateFieldsWithFlags(uint32 const* flags, uint32 flag)
+{
+    static UpdateFieldFlagMasks const itemMasks(ItemUpdateFieldFlags, CONTAINER_END);
+    static UpdateFieldFlagMasks const unitMasks(UnitUpdateFieldFlags, PLAYER_END);
+    static UpdateFieldFlagMasks const gameObjectMasks(GameObjectUpdateFieldFlags, GAMEOBJECT_END);
+    static UpdateFieldFlagMasks const dynamicObjectMasks(DynamicObjectUpdateFieldFlags, DYNAMICOBJECT_END);
+    static UpdateFieldFlagMasks const corpseMasks(CorpseUpdateFieldFlags, CORPSE_END);
+
+    if (flags == ItemUpdateFieldFlags)
+        return itemMasks.Get(flag);
+    if (flags == UnitUpdateFieldFlags)
+        return unitMasks.Get(flag);
+    if (flags == GameObjectUpdateFieldFlags)
+        return gameObjectMasks.Get(flag);
+    if (flags == DynamicObjectUpdateFieldFlags)
+        return dynamicObjectMasks.Get(flag);
+    if (flags == CorpseUpdateFieldFlags)
+        return corpseMasks.Get(flag);
+
+    ABORT("Unknown update field flags table");
+}
@@ -20,6 +20,7 @@
 
 #include "Define.h"
 #include "UpdateFields.h"
+#include "UpdateMask.h"
 
 enum UpdatefieldFlags
 {
@@ -41,4 +42,8 @@ WH_GAME_API extern uint32 GameObjectUpdateFieldFlags[GAMEOBJECT_END];
 WH_GAME_API extern uint32 DynamicObjectUpdateFieldFlags[DYNAMICOBJECT_END];
 WH_GAME_API extern uint32 CorpseUpdateFieldFlags[CORPSE_END];
 
+/// Fields of one of the tables above having any of the given flags.
+/// The mask covers the whole table, e.g. all player fields for UnitUpdateFieldFlags
+WH_GAME_API UpdateMask GetUpdateFieldsWithFlags(uint32 const* flags, uint32 flag);
+
 #endif // _UPDATEFIELDFLAGS_H
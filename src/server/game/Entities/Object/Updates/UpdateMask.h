@@ -20,7 +20,13 @@
 
 #include "ByteBuffer.h"
 #include "Errors.h"
+#include "UpdateFields.h"
+#include <algorithm>
+#include <array>
+#include <bit>
 
+/// Bitset of update fields, stored in the blocks the client reads.
+/// Storage is inline and sized for the largest object (player), so copies never allocate.
 class WH_GAME_API UpdateMask
 {
 public:
@@ -30,33 +36,53 @@ public:
     enum UpdateMaskCount
     {
         CLIENT_UPDATE_MASK_BITS = sizeof(ClientUpdateMaskType) * 8,
+        MAX_BLOCK_COUNT         = (PLAYER_END + CLIENT_UPDATE_MASK_BITS - 1) / CLIENT_UPDATE_MASK_BITS,
     };
 
-    UpdateMask()  = default;
+    UpdateMask() = default;
 
-    UpdateMask(UpdateMask const& right)
+    void SetBit(uint32 index) { _blocks[index / CLIENT_UPDATE_MASK_BITS] |= ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS); }
+    void UnsetBit(uint32 index) { _blocks[index / CLIENT_UPDATE_MASK_BITS] &= ~(ClientUpdateMaskType(1) << (index % CLIENT_UPDATE_MASK_BITS)); }
+    [[nodiscard]] bool GetBit(uint32 index) const { return (_blocks[index / CLIENT_UPDATE_MASK_BITS] >> (index % CLIENT_UPDATE_MASK_BITS)) & 1; }
+
+    /// Index of the first set bit at or after index, GetCount() if there is none
+    [[nodiscard]] uint32 GetNextBit(uint32 index) const
     {
-        SetCount(right.GetCount());
-        memcpy(_bits, right._bits, sizeof(uint8) * _blockCount * 32);
+        if (index >= _fieldCount)
+            return _fieldCount;
+
+        uint32 block = index / CLIENT_UPDATE_MASK_BITS;
+        ClientUpdateMaskType bits = _blocks[block] & (~ClientUpdateMaskType(0) << (index % CLIENT_UPDATE_MASK_BITS));
+
+        while (!bits)
+        {
+            if (++block >= _blockCount)
+                return _fieldCount;
+
+            bits = _blocks[block];
+        }
+
+        return std::min<uint32>(block * CLIENT_UPDATE_MASK_BITS + std::countr_zero(bits), _fieldCount);
     }
 
-    ~UpdateMask() { delete[] _bits; }
+    [[nodiscard]] uint32 GetSetBitCount() const
+    {
+        uint32 count = 0;
+        for (uint32 i = 0; i < _blockCount; ++i)
+            count += std::popcount(_blocks[i]);
 
-    void SetBit(uint32 index) { _bits[index] = 1; }
-    void UnsetBit(uint32 index) { _bits[index] = 0; }
-    [[nodiscard]] bool GetBit(uint32 index) const { return _bits[index] != 0; }
+        return count;
+    }
 
-    void AppendToPacket(ByteBuffer* data)
+    [[nodiscard]] bool IsEmpty() const
     {
-        for (uint32 i = 0; i < GetBlockCount(); ++i)
-        {
-            ClientUpdateMaskType maskPart = 0;
-            for (uint32 j = 0; j < CLIENT_UPDATE_MASK_BITS; ++j)
-                if (_bits[CLIENT_UPDATE_MASK_BITS * i + j])
-                    maskPart |= 1 << j;
+        return std::all_of(_blocks.begin(), _blocks.begin() + _blockCount, [](ClientUpdateMaskType block) { return !block; });
+    }
 
-            *data << maskPart;
-        }
+    void AppendToPacket(ByteBuffer* data) const
+    {
+        for (uint32 i = 0; i < _blockCount; ++i)
+            *data << _blocks[i];
     }
 
     [[nodiscard]] uint32 GetBlockCount() const { return _blockCount; }
@@ -64,36 +90,32 @@ public:
 
     void SetCount(uint32 valuesCount)
     {
-        delete[] _bits;
+        ASSERT(valuesCount <= MAX_BLOCK_COUNT * CLIENT_UPDATE_MASK_BITS);
 
         _fieldCount = valuesCount;
         _blockCount = (valuesCount + CLIENT_UPDATE_MASK_BITS - 1) / CLIENT_UPDATE_MASK_BITS;
-
-        _bits = new uint8[_blockCount * CLIENT_UPDATE_MASK_BITS];
-        memset(_bits, 0, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+        _blocks.fill(0);
     }
 
-    void Clear()
+    /// Sets every bit below GetCount()
+    void SetAll()
     {
-        if (_bits)
-            memset(_bits, 0, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
+        std::fill_n(_blocks.begin(), _blockCount, ~ClientUpdateMaskType(0));
+
+        if (uint32 tail = _fieldCount % CLIENT_UPDATE_MASK_BITS)
+            _blocks[_blockCount - 1] = (ClientUpdateMaskType(1) << tail) - 1;
     }
 
-    UpdateMask& operator=(UpdateMask const& right)
+    void Clear()
     {
-        if (this == &right)
-            return *this;
-
-        SetCount(right.GetCount());
-        memcpy(_bits, right._bits, sizeof(uint8) * _blockCount * CLIENT_UPDATE_MASK_BITS);
-        return *this;
+        std::fill_n(_blocks.begin(), _blockCount, 0);
     }
 
     UpdateMask& operator&=(UpdateMask const& right)
     {
         ASSERT(right.GetCount() <= GetCount());
-        for (uint32 i = 0; i < _fieldCount; ++i)
-            _bits[i] &= right._bits[i];
+        for (uint32 i = 0; i < _blockCount; ++i)
+            _blocks[i] &= right._blocks[i]; // unused blocks are always 0
 
         return *this;
     }
@@ -101,8 +123,8 @@ public:
     UpdateMask& operator|=(UpdateMask const& right)
     {
         ASSERT(right.GetCount() <= GetCount());
-        for (uint32 i = 0; i < _fieldCount; ++i)
-            _bits[i] |= right._bits[i];
+        for (uint32 i = 0; i < right._blockCount; ++i)
+            _blocks[i] |= right._blocks[i];
 
         return *this;
     }
@@ -117,7 +139,7 @@ public:
 private:
     uint32 _fieldCount{0};
     uint32 _blockCount{0};
-    uint8* _bits{nullptr};
+    std::array<ClientUpdateMaskType, MAX_BLOCK_COUNT> _blocks{};
 };
 
 #endif
@@ -4596,6 +4596,7 @@ void Player::SpawnCorpseBones(bool triggerSave /*= true*/)
             trans->Append(stmt);
 
             _SaveAuras(trans, false);
+            m_saveSectionHashes[PLAYER_SAVE_SECTION_AURAS] = 0;
 
             CharacterDatabase.CommitTransaction(trans);
         }
@@ -985,6 +985,18 @@ enum AdditionalSaving
     ADDITIONAL_SAVING_QUEST_STATUS              = 0x02,
 };
 
+// Parts of the player save rewritten as a whole (DELETE + INSERT), skipped when nothing changed since the last save
+enum PlayerSaveSection : uint8
+{
+    PLAYER_SAVE_SECTION_ENTRY_POINT,
+    PLAYER_SAVE_SECTION_SPELL_COOLDOWNS,
+    PLAYER_SAVE_SECTION_AURAS,
+    PLAYER_SAVE_SECTION_INSTANCE_TIMES,
+    PLAYER_SAVE_SECTION_STATS,
+
+    MAX_PLAYER_SAVE_SECTIONS
+};
+
 enum PlayerCommandStates
 {
     CHEAT_NONE = 0x00,
@@ -1539,7 +1551,10 @@ public:
     /*********************************************************/
 
     void SaveToDB(bool create, bool logout);
+    // writes every save section, the commit of trans is up to the caller
     void SaveToDB(CharacterDatabaseTransaction trans, bool create, bool logout);
+    // the database may not hold the last saved sections (failed commit), the next save writes all of them
+    void ResetSaveSections() { m_saveSectionHashes.fill(0); }
     void SaveInventoryAndGoldToDB(CharacterDatabaseTransaction trans);                    // fast save function for item/money cheating preventing
     void SaveGoldToDB(CharacterDatabaseTransaction trans);
 
@@ -2681,6 +2696,9 @@ public:
     void _SaveStats(CharacterDatabaseTransaction trans);
     void _SaveCharacter(bool create, CharacterDatabaseTransaction trans);
     void _SaveInstanceTimeRestrictions(CharacterDatabaseTransaction trans);
+    // skipUnchangedSections: only when a failed commit of trans resets the section hashes, see SaveToDB(bool, bool)
+    void _SaveToDB(CharacterDatabaseTransaction trans, bool create, bool logout, bool skipUnchangedSections);
+    void AppendSaveSection(CharacterDatabaseTransaction trans, PlayerSaveSection section, CharacterDatabaseTransaction sectionTrans, bool skipUnchanged);
 
     /*********************************************************/
     /***              ENVIRONMENTAL SYSTEM                 ***/
@@ -2703,6 +2721,7 @@ public:
     uint32 m_nextSave; // pussywizard
     uint16 m_additionalSaveTimer; // pussywizard
     uint8 m_additionalSaveMask; // pussywizard
+    std::array<uint64, MAX_PLAYER_SAVE_SECTIONS> m_saveSectionHashes = { }; // statements of the last save, 0 - unknown
     uint16 m_hostileReferenceCheckTimer; // pussywizard
     std::array<ChatFloodThrottle, ChatFloodThrottle::MAX> m_chatFloodData;
     Difficulty m_dungeonDifficulty;
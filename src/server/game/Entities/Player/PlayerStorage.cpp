@@ -54,6 +54,7 @@
 #include "Log.h"
 #include "LootItemStorage.h"
 #include "MapMgr.h"
+#include "Metric.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
 #include "Opcodes.h"
@@ -88,6 +89,72 @@
 //  see: https://github.com/azerothcore/azerothcore-wotlk/issues/9766
 #include "GridNotifiersImpl.h"
 
+namespace
+{
+    // FNV-1a over every statement and its bound values, never 0 (unknown state)
+    uint64 HashSaveStatements(std::vector<SQLElementData> const& queries)
+    {
+        uint64 hash = 14695981039346656037ULL;
+        auto hashBytes = [&hash](void const* data, std::size_t size)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+                hash = (hash ^ static_cast<uint8 const*>(data)[i]) * 1099511628211ULL;
+        };
+
+        for (SQLElementData const& query : queries)
+        {
+            if (query.type != SQL_ELEMENT_PREPARED)
+            {
+                std::string const& sql = std::get<std::string>(query.element);
+                hashBytes(sql.data(), sql.size());
+                continue;
+            }
+
+            PreparedStatement const& stmt = std::get<PreparedStatement>(query.element);
+            uint32 const index = stmt->GetIndex();
+            hashBytes(&index, sizeof(index));
+
+            for (PreparedStatementData const& parameter : stmt->GetParameters())
+            {
+                std::size_t const type = parameter.data.index();
+                hashBytes(&type, sizeof(type));
+
+                std::visit([&hashBytes](auto const& value)
+                {
+                    using T = std::decay_t<decltype(value)>;
+                    if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::vector<uint8>>)
+                        hashBytes(value.data(), value.size());
+                    else if constexpr (std::is_arithmetic_v<T>)
+                        hashBytes(&value, sizeof(value));
+                }, parameter.data);
+            }
+        }
+
+        return hash ? hash : 1;
+    }
+
+    std::size_t GetSaveStatementSize(SQLElementData const& query)
+    {
+        if (query.type != SQL_ELEMENT_PREPARED)
+            return std::get<std::string>(query.element).size();
+
+        std::size_t size = 0;
+        for (PreparedStatementData const& parameter : std::get<PreparedStatement>(query.element)->GetParameters())
+        {
+            std::visit([&size](auto const& value)
+            {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::vector<uint8>>)
+                    size += value.size();
+                else if constexpr (std::is_arithmetic_v<T>)
+                    size += sizeof(value);
+            }, parameter.data);
+        }
+
+        return size;
+    }
+}
+
 /*********************************************************/
 /***                    STORAGE SYSTEM                 ***/
 /*********************************************************/
@@ -7082,12 +7149,25 @@ void Player::SaveToDB(bool create, bool logout)
 {
     CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
 
-    SaveToDB(trans, create, logout);
+    _SaveToDB(trans, create, logout, true);
 
-    CharacterDatabase.CommitTransaction(trans);
+    GetSession()->AddTransactionCallback(CharacterDatabase.AsyncCommitTransaction(trans)).AfterComplete([guid = GetGUID()](bool success)
+    {
+        if (success)
+            return;
+
+        if (Player* player = ObjectAccessor::FindConnectedPlayer(guid))
+            player->ResetSaveSections();
+    });
 }
 
 void Player::SaveToDB(CharacterDatabaseTransaction trans, bool create, bool logout)
+{
+    // the caller commits trans and has no way to reset the section hashes when that fails
+    _SaveToDB(trans, create, logout, false);
+}
+
+void Player::_SaveToDB(CharacterDatabaseTransaction trans, bool create, bool logout, bool skipUnchangedSections)
 {
     // delay auto save at any saves (manual, in code, or autosave)
     m_nextSave = CONF_GET_INT("PlayerSaveInterval");
@@ -7112,12 +7192,17 @@ void Player::SaveToDB(CharacterDatabaseTransaction trans, bool create, bool logo
     if (!create)
         sScriptMgr->OnPlayerSave(this);
 
+    std::size_t const firstStatement = trans->GetSize();
+
     _SaveCharacter(create, trans);
 
     if (m_mailsUpdated)                                     //save mails only when needed
         _SaveMail(trans);
 
-    _SaveEntryPoint(trans);
+    CharacterDatabaseTransaction sectionTrans = CharacterDatabase.BeginTransaction();
+    _SaveEntryPoint(sectionTrans);
+    AppendSaveSection(trans, PLAYER_SAVE_SECTION_ENTRY_POINT, sectionTrans, skipUnchangedSections);
+
     _SaveInventory(trans);
     _SaveQuestStatus(trans);
     _SaveDailyQuestStatus(trans);
@@ -7126,27 +7211,76 @@ void Player::SaveToDB(CharacterDatabaseTransaction trans, bool create, bool logo
     _SaveMonthlyQuestStatus(trans);
     _SaveTalents(trans);
     _SaveSpells(trans);
-    _SaveSpellCooldowns(trans, logout);
+    sectionTrans = CharacterDatabase.BeginTransaction();
+    _SaveSpellCooldowns(sectionTrans, logout);
+    AppendSaveSection(trans, PLAYER_SAVE_SECTION_SPELL_COOLDOWNS, sectionTrans, skipUnchangedSections);
+
     _SaveActions(trans);
-    _SaveAuras(trans, logout);
+
+    sectionTrans = CharacterDatabase.BeginTransaction();
+    _SaveAuras(sectionTrans, logout);
+    AppendSaveSection(trans, PLAYER_SAVE_SECTION_AURAS, sectionTrans, skipUnchangedSections);
+
     _SaveSkills(trans);
     m_achievementMgr->SaveToDB(trans);
     m_reputationMgr->SaveToDB(trans);
     _SaveEquipmentSets(trans);
     GetSession()->SaveTutorialsData(trans);                 // changed only while character in game
     _SaveGlyphs(trans);
-    _SaveInstanceTimeRestrictions(trans);
+
+    sectionTrans = CharacterDatabase.BeginTransaction();
+    _SaveInstanceTimeRestrictions(sectionTrans);
+    AppendSaveSection(trans, PLAYER_SAVE_SECTION_INSTANCE_TIMES, sectionTrans, skipUnchangedSections);
 
     // check if stats should only be saved on logout
     // save stats can be out of transaction
     if (m_session->isLogingOut() || !CONF_GET_BOOL("PlayerSave.Stats.SaveOnlyOnLogout"))
-        _SaveStats(trans);
+    {
+        sectionTrans = CharacterDatabase.BeginTransaction();
+        _SaveStats(sectionTrans);
+        AppendSaveSection(trans, PLAYER_SAVE_SECTION_STATS, sectionTrans, skipUnchangedSections);
+    }
+
+    static MetricHistogram const statementsMetric("player_save_statements");
+    static MetricHistogram const bytesMetric("player_save_bytes");
+
+    auto& queries = *trans->GetQueries();
+    std::size_t bytes = 0;
+    for (std::size_t i = firstStatement; i < queries.size(); ++i)
+        bytes += GetSaveStatementSize(queries[i]);
+
+    statementsMetric.Record(queries.size() - firstStatement);
+    bytesMetric.Record(bytes);
 
     // save pet (hunter pet level and experience and all type pets health/mana).
     if (Pet* pet = GetPet())
         pet->SavePetToDB(PET_SAVE_AS_CURRENT);
 }
 
+void Player::AppendSaveSection(CharacterDatabaseTransaction trans, PlayerSaveSection section, CharacterDatabaseTransaction sectionTrans, bool skipUnchanged)
+{
+    auto& queries = *sectionTrans->GetQueries();
+
+    if (skipUnchanged)
+    {
+        uint64 hash = HashSaveStatements(queries);
+        if (hash == m_saveSectionHashes[section])
+            return;
+
+        m_saveSectionHashes[section] = hash;
+    }
+    else
+        m_saveSectionHashes[section] = 0; // written, but not known to be committed
+
+    for (SQLElementData& query : queries)
+    {
+        if (query.type == SQL_ELEMENT_PREPARED)
+            trans->Append(std::get<PreparedStatement>(query.element));
+        else
+            trans->Append(std::get<std::string>(query.element));
+    }
+}
+
 // fast save function for item/money cheating preventing - save only inventory and money state
 void Player::SaveInventoryAndGoldToDB(CharacterDatabaseTransaction trans)
 {
@@ -76,6 +76,7 @@
 #include "Vehicle.h"
 #include "World.h"
 #include "WorldPacket.h"
+#include <array>
 #include <cmath>
 #include <sstream>
 
@@ -433,7 +434,7 @@ void Unit::Update(uint32 p_time)
             {
                 m_delayed_unit_relocation_timer = 0;
                 //ExecuteDelayedUnitRelocationEvent();
-                FindMap()->i_objectsForDelayedVisibility.insert(this);
+                FindMap()->AddObjectForDelayedVisibility(this);
             }
             else
                 m_delayed_unit_relocation_timer -= p_time;
@@ -4623,10 +4624,28 @@ void Unit::_RemoveNoStackAurasDueToAura(Aura* aura)
 
 void Unit::_RegisterAuraEffect(AuraEffect* aurEff, bool apply)
 {
+    AuraType auraType = aurEff->GetAuraType();
     if (apply)
-        m_modAuras[aurEff->GetAuraType()].push_back(aurEff);
+    {
+        m_modAuras[auraType].push_back(aurEff);
+        m_modAuraEffects.insert(m_modAuraEffects.begin() + m_modAuraOffsets[auraType + 1], aurEff);
+        for (uint32 i = auraType + 1; i < m_modAuraOffsets.size(); ++i)
+            ++m_modAuraOffsets[i];
+    }
     else
-        m_modAuras[aurEff->GetAuraType()].remove(aurEff);
+    {
+        m_modAuras[auraType].remove(aurEff);
+        auto first = m_modAuraEffects.begin() + m_modAuraOffsets[auraType];
+        auto last = m_modAuraEffects.begin() + m_modAuraOffsets[auraType + 1];
+        auto newLast = std::remove(first, last, aurEff);
+        uint16 removed = uint16(std::distance(newLast, last));
+        if (!removed)
+            return;
+
+        m_modAuraEffects.erase(newLast, last);
+        for (uint32 i = auraType + 1; i < m_modAuraOffsets.size(); ++i)
+            m_modAuraOffsets[i] -= removed;
+    }
 }
 
 // All aura base removes should go threw this function!
@@ -5800,8 +5819,8 @@ int32 Unit::GetTotalAuraModifierAreaExclusive(AuraType auratype) const
     int32 modifier = 0;
     int32 areaModifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if ((*i)->GetSpellInfo()->HasAreaAuraEffect())
         {
@@ -5817,13 +5836,13 @@ int32 Unit::GetTotalAuraModifierAreaExclusive(AuraType auratype) const
 
 int32 Unit::GetTotalAuraModifier(AuraType auratype) const
 {
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
     if (mTotalAuraList.empty())
         return 0;
 
     int32 modifier = 0;
 
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         modifier += (*i)->GetAmount();
 
     return modifier;
@@ -5833,8 +5852,8 @@ float Unit::GetTotalAuraMultiplier(AuraType auratype) const
 {
     float multiplier = 1.0f;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         AddPct(multiplier, (*i)->GetAmount());
 
     return multiplier;
@@ -5844,8 +5863,8 @@ int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype)
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if ((*i)->GetAmount() > modifier)
             modifier = (*i)->GetAmount();
@@ -5858,8 +5877,8 @@ int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype) const
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         if ((*i)->GetAmount() < modifier)
             modifier = (*i)->GetAmount();
 
@@ -5870,8 +5889,8 @@ int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask)
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if ((*i)->GetMiscValue()& misc_mask)
             modifier += (*i)->GetAmount();
@@ -5883,8 +5902,8 @@ float Unit::GetTotalAuraMultiplierByMiscMask(AuraType auratype, uint32 misc_mask
 {
     float multiplier = 1.0f;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         if (((*i)->GetMiscValue() & misc_mask))
             AddPct(multiplier, (*i)->GetAmount());
 
@@ -5895,8 +5914,8 @@ int32 Unit::GetMaxPositiveAuraModifierByMiscMask(AuraType auratype, uint32 misc_
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if (except != (*i) && (*i)->GetMiscValue()& misc_mask && (*i)->GetAmount() > modifier)
             modifier = (*i)->GetAmount();
@@ -5909,8 +5928,8 @@ int32 Unit::GetMaxNegativeAuraModifierByMiscMask(AuraType auratype, uint32 misc_
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if ((*i)->GetMiscValue()& misc_mask && (*i)->GetAmount() < modifier)
             modifier = (*i)->GetAmount();
@@ -5923,8 +5942,8 @@ int32 Unit::GetTotalAuraModifierByMiscValue(AuraType auratype, int32 misc_value)
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         if ((*i)->GetMiscValue() == misc_value)
             modifier += (*i)->GetAmount();
 
@@ -5935,8 +5954,8 @@ float Unit::GetTotalAuraMultiplierByMiscValue(AuraType auratype, int32 misc_valu
 {
     float multiplier = 1.0f;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         if ((*i)->GetMiscValue() == misc_value)
             AddPct(multiplier, (*i)->GetAmount());
 
@@ -5947,8 +5966,8 @@ int32 Unit::GetMaxPositiveAuraModifierByMiscValue(AuraType auratype, int32 misc_
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if ((*i)->GetMiscValue() == misc_value && (*i)->GetAmount() > modifier)
             modifier = (*i)->GetAmount();
@@ -5961,8 +5980,8 @@ int32 Unit::GetMaxNegativeAuraModifierByMiscValue(AuraType auratype, int32 misc_
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if ((*i)->GetMiscValue() == misc_value && (*i)->GetAmount() < modifier)
             modifier = (*i)->GetAmount();
@@ -5975,8 +5994,8 @@ int32 Unit::GetTotalAuraModifierByAffectMask(AuraType auratype, SpellInfo const*
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         if ((*i)->IsAffectedOnSpell(affectedSpell))
             modifier += (*i)->GetAmount();
 
@@ -5987,8 +6006,8 @@ float Unit::GetTotalAuraMultiplierByAffectMask(AuraType auratype, SpellInfo cons
 {
     float multiplier = 1.0f;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
         if ((*i)->IsAffectedOnSpell(affectedSpell))
             AddPct(multiplier, (*i)->GetAmount());
 
@@ -5999,8 +6018,8 @@ int32 Unit::GetMaxPositiveAuraModifierByAffectMask(AuraType auratype, SpellInfo
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if ((*i)->IsAffectedOnSpell(affectedSpell) && (*i)->GetAmount() > modifier)
             modifier = (*i)->GetAmount();
@@ -6013,8 +6032,8 @@ int32 Unit::GetMaxNegativeAuraModifierByAffectMask(AuraType auratype, SpellInfo
 {
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraEffectSpan mTotalAuraList = GetAuraEffectSpanByType(auratype);
+    for (auto i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         if ((*i)->IsAffectedOnSpell(affectedSpell) && (*i)->GetAmount() < modifier)
             modifier = (*i)->GetAmount();
@@ -20851,17 +20870,8 @@ void Unit::SendMovementHover(Player* sendTo)
     sendTo->SendDirectMessage(&data);
 }
 
-void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target) const
+uint32 Unit::GetValuesUpdateVisibleFlag(Player const* target) const
 {
-    if (!target)
-        return;
-
-    ByteBuffer fieldBuffer;
-
-    UpdateMask updateMask;
-    updateMask.SetCount(m_valuesCount);
-
-    uint32* flags = UnitUpdateFieldFlags;
     uint32 visibleFlag = UF_FLAG_PUBLIC;
 
     if (target == this)
@@ -20878,49 +20888,232 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
     if (plr && plr->IsInSameRaidWith(target))
         visibleFlag |= UF_FLAG_PARTY_MEMBER;
 
+    return visibleFlag;
+}
+
+bool Unit::IsValuesUpdateFieldSent(uint8 updateType, uint16 index, uint32 visibleFlag) const
+{
+    uint32 const* flags = UnitUpdateFieldFlags;
+
+    return _fieldNotifyFlags & flags[index] ||
+        ((flags[index] & visibleFlag) & UF_FLAG_SPECIAL_INFO) ||
+        ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
+        (index == UNIT_FIELD_AURASTATE && HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK));
+}
+
+bool Unit::GetTargetSpecificFieldValue(uint16 index, Player* target, uint32& value) const
+{
     Creature const* creature = ToCreature();
-    for (uint16 index = 0; index < m_valuesCount; ++index)
+
+    switch (index)
     {
-        if (_fieldNotifyFlags & flags[index] ||
-                ((flags[index] & visibleFlag) & UF_FLAG_SPECIAL_INFO) ||
-                ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) ||
-                (index == UNIT_FIELD_AURASTATE && HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK)))
+        case UNIT_NPC_FLAGS:
         {
-            updateMask.SetBit(index);
+            value = m_uint32Values[UNIT_NPC_FLAGS];
 
-            if (index == UNIT_NPC_FLAGS)
+            if (creature)
             {
-                uint32 appendValue = m_uint32Values[UNIT_NPC_FLAGS];
+                if (CONF_GET_INT("InstantFlightPaths") == 2 && value & UNIT_NPC_FLAG_FLIGHTMASTER)
+                {
+                    value |= UNIT_NPC_FLAG_GOSSIP; // flight masters need NPC gossip flag to show instant flight toggle option
+                }
 
-                if (creature)
+                if (!target->CanSeeSpellClickOn(creature))
                 {
-                    if (CONF_GET_INT("InstantFlightPaths") == 2 && appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
-                    {
-                        appendValue |= UNIT_NPC_FLAG_GOSSIP; // flight masters need NPC gossip flag to show instant flight toggle option
-                    }
+                    value &= ~UNIT_NPC_FLAG_SPELLCLICK;
+                }
 
-                    if (!target->CanSeeSpellClickOn(creature))
-                    {
-                        appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
-                    }
+                if (!target->CanSeeVendor(creature))
+                {
+                    value &= ~UNIT_NPC_FLAG_VENDOR_MASK;
+                }
 
-                    if (!target->CanSeeVendor(creature))
+                if (!creature->IsValidTrainerForPlayer(target, &value))
+                {
+                    value &= ~UNIT_NPC_FLAG_TRAINER;
+                }
+            }
+
+            return true;
+        }
+        // Check per caster aura states to not enable using a spell in client if specified aura is not by target
+        case UNIT_FIELD_AURASTATE:
+            value = BuildAuraStateUpdateForTarget(target);
+            return true;
+        // Gamemasters should be always able to select units - remove not selectable flag
+        case UNIT_FIELD_FLAGS:
+            value = m_uint32Values[UNIT_FIELD_FLAGS];
+            if (target->IsGameMaster() && AccountMgr::IsGMAccount(target->GetSession()->GetSecurity()))
+                value &= ~UNIT_FLAG_NOT_SELECTABLE;
+
+            return true;
+        // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
+        case UNIT_FIELD_DISPLAYID:
+        {
+            value = m_uint32Values[UNIT_FIELD_DISPLAYID];
+            if (creature)
+            {
+                CreatureTemplate const* cinfo = creature->GetCreatureTemplate();
+
+                // this also applies for transform auras
+                if (SpellInfo const* transform = sSpellMgr->GetSpellInfo(getTransForm()))
+                    for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+                        if (transform->Effects[i].IsAura(SPELL_AURA_TRANSFORM))
+                            if (CreatureTemplate const* transformInfo = sObjectMgr->GetCreatureTemplate(transform->Effects[i].MiscValue))
+                            {
+                                cinfo = transformInfo;
+                                break;
+                            }
+
+                if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
+                {
+                    if (target->IsGameMaster() && AccountMgr::IsGMAccount(target->GetSession()->GetSecurity()))
                     {
-                        appendValue &= ~UNIT_NPC_FLAG_VENDOR_MASK;
+                        if (cinfo->Modelid1)
+                            value = cinfo->Modelid1;    // Modelid1 is a visible model for gms
+                        else
+                            value = 17519;              // world visible trigger's model
                     }
-
-                    if (!creature->IsValidTrainerForPlayer(target, &appendValue))
+                    else
                     {
-                        appendValue &= ~UNIT_NPC_FLAG_TRAINER;
+                        if (cinfo->Modelid2)
+                            value = cinfo->Modelid2;    // Modelid2 is an invisible model for players
+                        else
+                            value = 11686;              // world invisible trigger's model
                     }
                 }
+            }
 
-                fieldBuffer << uint32(appendValue);
+            return true;
+        }
+        // hide lootable animation for unallowed players
+        case UNIT_DYNAMIC_FLAGS:
+        {
+            value = m_uint32Values[UNIT_DYNAMIC_FLAGS] & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
+
+            if (creature)
+            {
+                if (creature->hasLootRecipient())
+                {
+                    value |= UNIT_DYNFLAG_TAPPED;
+                    if (creature->isTappedBy(target))
+                        value |= UNIT_DYNFLAG_TAPPED_BY_PLAYER;
+                }
+
+                if (!target->isAllowedToLoot(creature))
+                    value &= ~UNIT_DYNFLAG_LOOTABLE;
             }
-            else if (index == UNIT_FIELD_AURASTATE)
+
+            // unit UNIT_DYNFLAG_TRACK_UNIT should only be sent to caster of SPELL_AURA_MOD_STALKED auras
+            if (value & UNIT_DYNFLAG_TRACK_UNIT)
+                if (!HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetGUID()))
+                    value &= ~UNIT_DYNFLAG_TRACK_UNIT;
+
+            return true;
+        }
+        // FG: pretend that OTHER players in own group are friendly ("blue")
+        case UNIT_FIELD_BYTES_2:
+        case UNIT_FIELD_FACTIONTEMPLATE:
+            if (IsControlledByPlayer() && target != this && CONF_GET_BOOL("AllowTwoSide.Interaction.Group") && IsInRaidWith(target))
+            {
+                FactionTemplateEntry const* ft1 = GetFactionTemplateEntry();
+                FactionTemplateEntry const* ft2 = target->GetFactionTemplateEntry();
+                if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
+                {
+                    if (index == UNIT_FIELD_BYTES_2)
+                        // Allow targetting opposite faction in party when enabled in config
+                        value = m_uint32Values[UNIT_FIELD_BYTES_2] & ((UNIT_BYTE2_FLAG_SANCTUARY /*| UNIT_BYTE2_FLAG_AURAS | UNIT_BYTE2_FLAG_UNK5*/) << 8); // this flag is at uint8 offset 1 !!
+                    else
+                        // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
+                        value = target->GetFaction();
+                }
+                else
+                    value = m_uint32Values[index];
+
+                return true;
+            }
+            // pussywizard / Callmephil
+            else if (target->IsSpectator() && target->FindMap() && target->FindMap()->IsBattleArena() &&
+                     (this->GetTypeId() == TYPEID_PLAYER || this->GetTypeId() == TYPEID_UNIT || this->GetTypeId() == TYPEID_DYNAMICOBJECT))
+            {
+                if (index == UNIT_FIELD_BYTES_2)
+                    value = m_uint32Values[index] & 0xFFFFF2FF; // clear UNIT_BYTE2_FLAG_PVP, UNIT_BYTE2_FLAG_FFA_PVP, UNIT_BYTE2_FLAG_SANCTUARY
+                else
+                    value = target->GetFaction();
+
+                return true;
+            }
+
+            return false;
+        default:
+            return false;
+    }
+}
+
+bool Unit::GetValuesUpdateClass(Player* target, ValuesUpdateClass& updateClass) const
+{
+    // Script hooks may rewrite any field per target, sharing has to be disabled for them
+    if (!target || !CONF_GET_BOOL("Visibility.ShareValuesUpdates"))
+        return false;
+
+    static constexpr std::array<uint16, 7> TargetSpecificFields =
+    {
+        UNIT_NPC_FLAGS, UNIT_FIELD_AURASTATE, UNIT_FIELD_FLAGS, UNIT_FIELD_DISPLAYID,
+        UNIT_DYNAMIC_FLAGS, UNIT_FIELD_BYTES_2, UNIT_FIELD_FACTIONTEMPLATE
+    };
+    static_assert(TargetSpecificFields.size() <= ValuesUpdateClass::MAX_TARGET_VALUES);
+
+    // Which fields are sent depends only on the visible flags, so equal classes give equal masks
+    updateClass.VisibleFlag = GetValuesUpdateVisibleFlag(target);
+    for (std::size_t i = 0; i < TargetSpecificFields.size(); ++i)
+    {
+        uint16 index = TargetSpecificFields[i];
+        if (!IsValuesUpdateFieldSent(UPDATETYPE_VALUES, index, updateClass.VisibleFlag))
+            continue;
+
+        uint32 value = m_uint32Values[index];
+        GetTargetSpecificFieldValue(index, target, value);
+        updateClass.TargetValues[i] = value;
+    }
+
+    return true;
+}
+
+void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target) const
+{
+    if (!target)
+        return;
+
+    ByteBuffer fieldBuffer;
+
+    UpdateMask updateMask;
+    updateMask.SetCount(m_valuesCount);
+
+    uint32* flags = UnitUpdateFieldFlags;
+    uint32 visibleFlag = GetValuesUpdateVisibleFlag(target);
+
+    UpdateMask fields = GetValuesUpdateFields(updateType, flags);
+    if (visibleFlag & UF_FLAG_SPECIAL_INFO)
+    {
+        // Covers all player fields, can't be merged into the smaller mask of a creature
+        UpdateMask specialInfoFields = GetUpdateFieldsWithFlags(flags, UF_FLAG_SPECIAL_INFO);
+        specialInfoFields |= fields;
+        fields = specialInfoFields;
+    }
+
+    if (HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK))
+        fields.SetBit(UNIT_FIELD_AURASTATE);
+
+    for (uint32 index = fields.GetNextBit(0); index < m_valuesCount; index = fields.GetNextBit(index + 1))
+    {
+        if (IsValuesUpdateFieldSent(updateType, index, visibleFlag))
+        {
+            updateMask.SetBit(index);
+
+            uint32 appendValue;
+            if (GetTargetSpecificFieldValue(index, target, appendValue))
             {
-                // Check per caster aura states to not enable using a spell in client if specified aura is not by target
-                fieldBuffer << BuildAuraStateUpdateForTarget(target);
+                fieldBuffer << uint32(appendValue);
             }
             // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
             else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
@@ -20936,111 +21129,12 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
             {
                 fieldBuffer << uint32(m_floatValues[index]);
             }
-            // Gamemasters should be always able to select units - remove not selectable flag
-            else if (index == UNIT_FIELD_FLAGS)
-            {
-                uint32 appendValue = m_uint32Values[UNIT_FIELD_FLAGS];
-                if (target->IsGameMaster() && AccountMgr::IsGMAccount(target->GetSession()->GetSecurity()))
-                    appendValue &= ~UNIT_FLAG_NOT_SELECTABLE;
-
-                fieldBuffer << uint32(appendValue);
-            }
-            // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
-            else if (index == UNIT_FIELD_DISPLAYID)
-            {
-                uint32 displayId = m_uint32Values[UNIT_FIELD_DISPLAYID];
-                if (creature)
-                {
-                    CreatureTemplate const* cinfo = creature->GetCreatureTemplate();
-
-                    // this also applies for transform auras
-                    if (SpellInfo const* transform = sSpellMgr->GetSpellInfo(getTransForm()))
-                        for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
-                            if (transform->Effects[i].IsAura(SPELL_AURA_TRANSFORM))
-                                if (CreatureTemplate const* transformInfo = sObjectMgr->GetCreatureTemplate(transform->Effects[i].MiscValue))
-                                {
-                                    cinfo = transformInfo;
-                                    break;
-                                }
-
-                    if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
-                    {
-                        if (target->IsGameMaster() && AccountMgr::IsGMAccount(target->GetSession()->GetSecurity()))
-                        {
-                            if (cinfo->Modelid1)
-                                displayId = cinfo->Modelid1;    // Modelid1 is a visible model for gms
-                            else
-                                displayId = 17519;              // world visible trigger's model
-                        }
-                        else
-                        {
-                            if (cinfo->Modelid2)
-                                displayId = cinfo->Modelid2;    // Modelid2 is an invisible model for players
-                            else
-                                displayId = 11686;              // world invisible trigger's model
-                        }
-                    }
-                }
-
-                fieldBuffer << uint32(displayId);
-            }
-            // hide lootable animation for unallowed players
-            else if (index == UNIT_DYNAMIC_FLAGS)
-            {
-                uint32 dynamicFlags = m_uint32Values[UNIT_DYNAMIC_FLAGS] & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
-
-                if (creature)
-                {
-                    if (creature->hasLootRecipient())
-                    {
-                        dynamicFlags |= UNIT_DYNFLAG_TAPPED;
-                        if (creature->isTappedBy(target))
-                            dynamicFlags |= UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                    }
-
-                    if (!target->isAllowedToLoot(creature))
-                        dynamicFlags &= ~UNIT_DYNFLAG_LOOTABLE;
-                }
-
-                // unit UNIT_DYNFLAG_TRACK_UNIT should only be sent to caster of SPELL_AURA_MOD_STALKED auras
-                if (dynamicFlags & UNIT_DYNFLAG_TRACK_UNIT)
-                    if (!HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetGUID()))
-                        dynamicFlags &= ~UNIT_DYNFLAG_TRACK_UNIT;
-
-                fieldBuffer << dynamicFlags;
-            }
-            // FG: pretend that OTHER players in own group are friendly ("blue")
             else if (index == UNIT_FIELD_BYTES_2 || index == UNIT_FIELD_FACTIONTEMPLATE)
             {
-                if (IsControlledByPlayer() && target != this && CONF_GET_BOOL("AllowTwoSide.Interaction.Group") && IsInRaidWith(target))
-                {
-                    FactionTemplateEntry const* ft1 = GetFactionTemplateEntry();
-                    FactionTemplateEntry const* ft2 = target->GetFactionTemplateEntry();
-                    if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
-                    {
-                        if (index == UNIT_FIELD_BYTES_2)
-                            // Allow targetting opposite faction in party when enabled in config
-                            fieldBuffer << (m_uint32Values[UNIT_FIELD_BYTES_2] & ((UNIT_BYTE2_FLAG_SANCTUARY /*| UNIT_BYTE2_FLAG_AURAS | UNIT_BYTE2_FLAG_UNK5*/) << 8)); // this flag is at uint8 offset 1 !!
-                        else
-                            // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
-                            fieldBuffer << uint32(target->GetFaction());
-                    }
-                    else
-                        fieldBuffer << m_uint32Values[index];
-                }// pussywizard / Callmephil
-                else if (target->IsSpectator() && target->FindMap() && target->FindMap()->IsBattleArena() &&
-                         (this->GetTypeId() == TYPEID_PLAYER || this->GetTypeId() == TYPEID_UNIT || this->GetTypeId() == TYPEID_DYNAMICOBJECT))
+                if (!sScriptMgr->IsCustomBuildValuesUpdate(this, updateType, &fieldBuffer, target, index))
                 {
-                    if (index == UNIT_FIELD_BYTES_2)
-                        fieldBuffer << (m_uint32Values[index] & 0xFFFFF2FF); // clear UNIT_BYTE2_FLAG_PVP, UNIT_BYTE2_FLAG_FFA_PVP, UNIT_BYTE2_FLAG_SANCTUARY
-                    else
-                        fieldBuffer << (uint32)target->GetFaction();
+                    fieldBuffer << m_uint32Values[index];
                 }
-                else
-                    if (!sScriptMgr->IsCustomBuildValuesUpdate(this, updateType, &fieldBuffer, target, index))
-                    {
-                        fieldBuffer << m_uint32Values[index];
-                    }
             }
             else
             {
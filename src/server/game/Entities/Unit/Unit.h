@@ -31,6 +31,7 @@
 #include "SpellDefines.h"
 #include "ThreatMgr.h"
 #include <functional>
+#include <span>
 #include <utility>
 
 class TaskScheduler;
@@ -1306,6 +1307,7 @@ public:
     typedef std::pair<AuraStateAurasMap::const_iterator, AuraStateAurasMap::const_iterator> AuraStateAurasMapBounds;
 
     typedef std::list<AuraEffect*> AuraEffectList;
+    typedef std::span<AuraEffect* const> AuraEffectSpan;
     typedef std::list<Aura*> AuraList;
     typedef std::list<AuraApplication*> AuraApplicationList;
     typedef std::list<DiminishingReturn> Diminishing;
@@ -1964,6 +1966,8 @@ public:
     void _ApplyAllAuraStatMods();
 
     [[nodiscard]] AuraEffectList const& GetAuraEffectsByType(AuraType type) const { return m_modAuras[type]; }
+    // Same effects in the same order, stored contiguously. Only for loops that do not apply or remove auras while iterating
+    [[nodiscard]] AuraEffectSpan GetAuraEffectSpanByType(AuraType type) const { return AuraEffectSpan(m_modAuraEffects).subspan(m_modAuraOffsets[type], m_modAuraOffsets[type + 1] - m_modAuraOffsets[type]); }
     AuraList&       GetSingleCastAuras()       { return m_scAuras; }
     [[nodiscard]] AuraList const& GetSingleCastAuras() const { return m_scAuras; }
 
@@ -2464,6 +2468,10 @@ protected:
     explicit Unit (bool isWorldObject);
 
     void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
+    [[nodiscard]] bool GetValuesUpdateClass(Player* target, ValuesUpdateClass& updateClass) const override;
+    [[nodiscard]] uint32 GetValuesUpdateVisibleFlag(Player const* target) const;
+    [[nodiscard]] bool IsValuesUpdateFieldSent(uint8 updateType, uint16 index, uint32 visibleFlag) const;
+    bool GetTargetSpecificFieldValue(uint16 index, Player* target, uint32& value) const; // false when the field is sent as stored
 
     UnitAI* i_AI, *i_disabledAI;
 
@@ -2504,6 +2512,8 @@ protected:
     uint32 m_removedAurasCount;
 
     AuraEffectList m_modAuras[TOTAL_AURAS];
+    std::vector<AuraEffect*> m_modAuraEffects;                    // m_modAuras flattened and grouped by aura type
+    std::array<uint16, TOTAL_AURAS + 1> m_modAuraOffsets = { };  // first index of each aura type in m_modAuraEffects
     AuraList m_scAuras;                        // casted singlecast auras
     AuraApplicationList m_interruptableAuras;             // auras which have interrupt mask applied on unit
     AuraStateAurasMap m_auraStateAuras;        // Used for improve performance of aura state checks on aura apply/remove
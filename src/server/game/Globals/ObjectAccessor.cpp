@@ -19,6 +19,7 @@
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 
 #include "ObjectAccessor.h"
+#include "ConcurrentLookupMap.h"
 #include "Corpse.h"
 #include "Creature.h"
 #include "DynamicObject.h"
@@ -36,6 +37,17 @@
 #include "Transport.h"
 #include "Vehicle.h"
 
+namespace
+{
+    // Copy of the container for lookups, so Find doesn't contend with other readers on the lock
+    template<class T>
+    Warhead::ConcurrentLookupMap<ObjectGuid, T*>& GetLookupMap()
+    {
+        static Warhead::ConcurrentLookupMap<ObjectGuid, T*> _lookupMap;
+        return _lookupMap;
+    }
+}
+
 template<class T>
 void HashMapHolder<T>::Insert(T* o)
 {
@@ -46,6 +58,7 @@ void HashMapHolder<T>::Insert(T* o)
     std::unique_lock<std::shared_mutex> lock(*GetLock());
 
     GetContainer()[o->GetGUID()] = o;
+    GetLookupMap<T>().InsertOrAssign(o->GetGUID(), o);
 }
 
 template<class T>
@@ -54,15 +67,13 @@ void HashMapHolder<T>::Remove(T* o)
     std::unique_lock<std::shared_mutex> lock(*GetLock());
 
     GetContainer().erase(o->GetGUID());
+    GetLookupMap<T>().Erase(o->GetGUID());
 }
 
 template<class T>
 T* HashMapHolder<T>::Find(ObjectGuid guid)
 {
-    std::shared_lock<std::shared_mutex> lock(*GetLock());
-
-    typename MapType::iterator itr = GetContainer().find(guid);
-    return (itr != GetContainer().end()) ? itr->second : nullptr;
+    return GetLookupMap<T>().Find(guid, nullptr);
 }
 
 template<class T>
@@ -89,22 +100,22 @@ template class HashMapHolder<MotionTransport>;
 
 namespace PlayerNameMapHolder
 {
-    typedef std::unordered_map<std::string, Player*> MapType;
+    typedef Warhead::ConcurrentLookupMap<std::string, Player*> MapType;
     static MapType PlayerNameMap;
 
     void Insert(Player* p)
     {
-        PlayerNameMap[p->GetName()] = p;
+        PlayerNameMap.InsertOrAssign(p->GetName(), p);
     }
 
     void Remove(Player* p)
     {
-        PlayerNameMap.erase(p->GetName());
+        PlayerNameMap.Erase(p->GetName());
     }
 
     void RemoveByName(std::string const& name)
     {
-        PlayerNameMap.erase(name);
+        PlayerNameMap.Erase(name);
     }
 
     Player* Find(std::string const& name)
@@ -113,8 +124,7 @@ namespace PlayerNameMapHolder
         if (!normalizePlayerName(charName))
             return nullptr;
 
-        auto itr = PlayerNameMap.find(charName);
-        return (itr != PlayerNameMap.end()) ? itr->second : nullptr;
+        return PlayerNameMap.Find(charName, nullptr);
     }
 
 } // namespace PlayerNameMapHolder
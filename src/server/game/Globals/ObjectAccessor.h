@@ -51,6 +51,7 @@ public:
 
     static void Remove(T* o);
 
+    // Lock free, the lock only guards iterating the container
     static T* Find(ObjectGuid guid);
 
     static MapType& GetContainer();
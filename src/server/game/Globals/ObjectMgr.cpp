@@ -6417,13 +6417,14 @@ void ObjectMgr::SetHighestGuids()
 
 uint32 ObjectMgr::GenerateAuctionID()
 {
-    if (_auctionId >= 0xFFFFFFFE)
+    uint32 const auctionId = _auctionId.fetch_add(1);
+    if (auctionId >= 0xFFFFFFFE)
     {
         LOG_ERROR("server.worldserver", "Auctions ids overflow!! Can't continue, shutting down server. ");
         World::StopNow(ERROR_EXIT_CODE);
     }
 
-    return _auctionId++;
+    return auctionId;
 }
 
 uint64 ObjectMgr::GenerateEquipmentSetGuid()
@@ -34,6 +34,7 @@
 #include "QuestDef.h"
 #include "TemporarySummon.h"
 #include "VehicleDefines.h"
+#include <atomic>
 #include <map>
 #include <string>
 
@@ -1227,7 +1228,7 @@ public:
     void NewInstanceSavedGameobjectState(uint32 id, uint32 guid, uint8 state);
 private:
     // first free id for selected id type
-    uint32 _auctionId; // pussywizard: accessed by a single thread
+    std::atomic<uint32> _auctionId; // auction houses sell in parallel, AHBot too
     uint64 _equipmentSetGuid; // pussywizard: accessed by a single thread
     uint32 _mailId;
     std::mutex _mailIdMutex;
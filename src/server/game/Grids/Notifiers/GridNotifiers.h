@@ -119,8 +119,15 @@ namespace Warhead
             if (!player->HaveAtClient(i_source))
                 return;
 
-            player->GetSession()->SendPacket(i_message);
+            // Copied once for the first receiver, every socket references the same payload
+            if (!i_sharedMessage)
+                i_sharedMessage = std::make_shared<WorldPacket const>(*i_message);
+
+            player->GetSession()->SendPacket(i_sharedMessage);
         }
+
+    private:
+        SharedWorldPacket i_sharedMessage;
     };
 
     struct MessageDistDelivererToHostile
@@ -144,8 +151,14 @@ namespace Warhead
             if (player == i_source || !player->HaveAtClient(i_source) || player->IsFriendlyTo(i_source))
                 return;
 
-            player->GetSession()->SendPacket(i_message);
+            if (!i_sharedMessage)
+                i_sharedMessage = std::make_shared<WorldPacket const>(*i_message);
+
+            player->GetSession()->SendPacket(i_sharedMessage);
         }
+
+    private:
+        SharedWorldPacket i_sharedMessage;
     };
 
     struct ObjectUpdater
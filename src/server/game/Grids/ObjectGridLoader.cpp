@@ -154,6 +154,7 @@ void ObjectGridLoader::Visit(CreatureMapType& m)
 void ObjectWorldLoader::Visit(CorpseMapType& /*m*/)
 {
     CellCoord cellCoord = i_cell.GetCellCoord();
+    auto guard = i_map->LockForRegionUpdate();
     if (std::unordered_set<Corpse*> const* corpses = i_map->GetCorpsesInCell(cellCoord.GetId()))
     {
         for (Corpse* corpse : *corpses)
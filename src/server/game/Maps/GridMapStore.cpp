@@ -0,0 +1,76 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "GridMapStore.h"
+#include "Log.h"
+#include "Map.h"
+#include "StringFormat.h"
+#include "World.h"
+
+GridMapStore* GridMapStore::instance()
+{
+    static GridMapStore instance;
+    return &instance;
+}
+
+std::shared_ptr<GridMap> GridMapStore::Acquire(uint32 mapId, int gx, int gy, bool reload /*= false*/)
+{
+    // Mapping the file is cheap (no data is read until a lookup touches the pages),
+    // so the load can stay under the lock and concurrent maps never map the same file twice
+    std::lock_guard<std::mutex> guard(_lock);
+
+    std::weak_ptr<GridMap>& entry = _gridMaps[MakeKey(mapId, gx, gy)];
+
+    if (!reload)
+        if (std::shared_ptr<GridMap> gridMap = entry.lock())
+            return gridMap;
+
+    std::string mapName = Warhead::StringFormat(sWorld->GetDataPath() + "maps/{:03}{:02}{:02}.map", mapId, gx, gy);
+
+    LOG_TRACE("maps", "Loading map {}", mapName);
+
+    auto gridMap = std::make_shared<GridMap>();
+    if (!gridMap->LoadData(mapName))
+        LOG_ERROR("maps", "Error loading map file: {}", mapName);
+
+    entry = gridMap;
+    return gridMap;
+}
+
+std::size_t GridMapStore::GetLoadedCount()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    std::erase_if(_gridMaps, [](auto const& itr) { return itr.second.expired(); });
+    return _gridMaps.size();
+}
+
+std::size_t GridMapStore::GetMappedSize()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    std::size_t size = 0;
+
+    for (auto const& [key, entry] : _gridMaps)
+        if (std::shared_ptr<GridMap> gridMap = entry.lock())
+            size += gridMap->GetMappedSize();
+
+    return size;
+}
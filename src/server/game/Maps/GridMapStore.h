@@ -0,0 +1,61 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GRID_MAP_STORE_H_
+#define GRID_MAP_STORE_H_
+
+#include "Define.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class GridMap;
+
+// Process wide owner of loaded terrain (.map) files.
+// Every map asking for the same (mapId, gx, gy) gets the same read-only GridMap, so base maps,
+// their instances and grids reloaded while another map still holds the terrain never read
+// the file twice. Entries do not keep terrain alive, it is freed with the last map holding it.
+class WH_GAME_API GridMapStore
+{
+    GridMapStore() = default;
+    ~GridMapStore() = default;
+
+public:
+    GridMapStore(GridMapStore const&) = delete;
+    GridMapStore(GridMapStore&&) = delete;
+    GridMapStore& operator=(GridMapStore const&) = delete;
+    GridMapStore& operator=(GridMapStore&&) = delete;
+
+    static GridMapStore* instance();
+
+    // Returns the shared terrain of the grid, loading it when no map holds it yet.
+    // reload forces a fresh read; maps still holding the previous data keep it until released.
+    std::shared_ptr<GridMap> Acquire(uint32 mapId, int gx, int gy, bool reload = false);
+
+    std::size_t GetLoadedCount();
+    std::size_t GetMappedSize();
+
+private:
+    static constexpr uint32 MakeKey(uint32 mapId, int gx, int gy) { return (mapId << 12) | (uint32(gx) << 6) | uint32(gy); }
+
+    std::mutex _lock;
+    std::unordered_map<uint32, std::weak_ptr<GridMap>> _gridMaps;
+};
+
+#define sGridMapStore GridMapStore::instance()
+
+#endif
@@ -0,0 +1,209 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "GridPreloader.h"
+#include "DisableMgr.h"
+#include "GameConfig.h"
+#include "GridMapStore.h"
+#include "Log.h"
+#include "MMapFactory.h"
+#include "MMapMgr.h"
+#include "Map.h"
+#include "MoveSpline.h"
+#include "Player.h"
+#include "ThreadPool.h"
+#include "VMapFactory.h"
+#include "VMapMgr2.h"
+#include "World.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // shared by all maps, the requests only hold their own data so a map never waits for another one
+    Warhead::ThreadPool& GetPreloadThreads()
+    {
+        static Warhead::ThreadPool threads(std::max<int32>(1, CONF_GET_INT("MapPreload.Threads")));
+        return threads;
+    }
+}
+
+GridPreloader::GridPreloader(Map& map) : _map(map),
+    _requestedMetric("map_grid_preloads", { METRIC_TAG("map_id", std::to_string(map.GetId())), METRIC_TAG("type", "Requested") }),
+    _usedMetric("map_grid_preloads", { METRIC_TAG("map_id", std::to_string(map.GetId())), METRIC_TAG("type", "Used") }),
+    _expiredMetric("map_grid_preloads", { METRIC_TAG("map_id", std::to_string(map.GetId())), METRIC_TAG("type", "Expired") })
+{
+}
+
+GridPreloader::~GridPreloader()
+{
+    for (auto& [id, request] : _requests)
+    {
+        request->Done.wait(false);
+        Release(*request);
+    }
+}
+
+bool GridPreloader::IsEnabled()
+{
+    return CONF_GET_BOOL("MapPreload.Enable");
+}
+
+void GridPreloader::Update(uint32 diff)
+{
+    uint32 const lookAhead = CONF_GET_UINT("MapPreload.LookAhead") * IN_MILLISECONDS;
+
+    for (auto itr = _requests.begin(); itr != _requests.end();)
+    {
+        Request& request = *itr->second;
+        request.Age += diff;
+
+        if (!request.Done)
+        {
+            ++itr;
+            continue;
+        }
+
+        GridCoord coord((MAX_NUMBER_OF_GRIDS - 1) - request.GridX, (MAX_NUMBER_OF_GRIDS - 1) - request.GridY);
+
+        // the map holds its own references once the grid is created
+        if (_map.getNGrid(coord.x_coord, coord.y_coord))
+            _usedMetric.Add(1);
+        else if (request.Age > 2 * lookAhead)
+            _expiredMetric.Add(1);
+        else
+        {
+            ++itr;
+            continue;
+        }
+
+        Release(request);
+        itr = _requests.erase(itr);
+    }
+
+    _timer += diff;
+    if (_timer < CONF_GET_UINT("MapPreload.Interval"))
+        return;
+
+    _timer = 0;
+
+    for (auto const& ref : _map.GetPlayers())
+        if (Player* player = ref.GetSource())
+            if (player->IsInWorld())
+                PredictPlayer(player, lookAhead);
+}
+
+void GridPreloader::PredictPlayer(Player* player, uint32 lookAhead)
+{
+    // flight paths, the spline tells exactly where the player will be
+    if (player->IsInFlight() && player->movespline->Initialized() && !player->movespline->Finalized())
+    {
+        Movement::MoveSpline const& moveSpline = *player->movespline;
+        Movement::MoveSpline::MySpline const& spline = moveSpline._Spline();
+
+        int32 const until = moveSpline.timePassed() + int32(lookAhead);
+        for (int32 i = moveSpline._currentSplineIdx() + 1; i <= spline.last(); ++i)
+        {
+            G3D::Vector3 const& point = spline.getPoint(i);
+            PreloadAround(point.x, point.y);
+
+            if (spline.length(i) > until)
+                break;
+        }
+
+        return;
+    }
+
+    if (!player->isMoving())
+        return;
+
+    float const speed = player->GetSpeed(player->IsFlying() ? MOVE_FLIGHT : MOVE_RUN);
+    float const distance = speed * lookAhead / IN_MILLISECONDS;
+    float const orientation = player->GetOrientation();
+
+    PreloadAround(player->GetPositionX() + distance * std::cos(orientation), player->GetPositionY() + distance * std::sin(orientation));
+}
+
+void GridPreloader::PreloadAround(float x, float y)
+{
+    if (!Warhead::IsValidMapCoord(x, y))
+        return;
+
+    // every grid the player could see from there
+    float const range = _map.GetVisibilityRange();
+    float lowX = x - range, lowY = y - range, highX = x + range, highY = y + range;
+    Warhead::NormalizeMapCoord(lowX);
+    Warhead::NormalizeMapCoord(lowY);
+    Warhead::NormalizeMapCoord(highX);
+    Warhead::NormalizeMapCoord(highY);
+
+    GridCoord const low = Warhead::ComputeGridCoord(lowX, lowY);
+    GridCoord const high = Warhead::ComputeGridCoord(highX, highY);
+
+    for (uint32 gridX = low.x_coord; gridX <= high.x_coord; ++gridX)
+        for (uint32 gridY = low.y_coord; gridY <= high.y_coord; ++gridY)
+            if (!_map.getNGrid(gridX, gridY))
+                Submit(GridCoord(gridX, gridY));
+}
+
+void GridPreloader::Submit(GridCoord const& coord)
+{
+    auto [itr, inserted] = _requests.try_emplace(coord.GetId());
+    if (!inserted)
+        return;
+
+    RequestPtr request = std::make_shared<Request>();
+    request->MapId = _map.GetId();
+    request->GridX = (MAX_NUMBER_OF_GRIDS - 1) - coord.x_coord;
+    request->GridY = (MAX_NUMBER_OF_GRIDS - 1) - coord.y_coord;
+    request->LoadMMap = DisableMgr::IsPathfindingEnabled(&_map);
+    itr->second = request;
+
+    _requestedMetric.Add(1);
+
+    GetPreloadThreads().PostWork([request = std::move(request)]()
+    {
+        Load(*request);
+        request->Done = true;
+        request->Done.notify_all();
+    });
+}
+
+void GridPreloader::Load(Request& request)
+{
+    LOG_DEBUG("maps", "Preloading grid [{}, {}] of map {}", request.GridX, request.GridY, request.MapId);
+
+    request.Terrain = sGridMapStore->Acquire(request.MapId, request.GridX, request.GridY);
+    request.Terrain->Prefetch();
+
+    VMAP::VMapFactory::createOrGetVMapMgr()->preloadMapTile((sWorld->GetDataPath() + "vmaps").c_str(), request.MapId, request.GridX, request.GridY);
+
+    if (request.LoadMMap)
+        request.MMapLoaded = MMAP::MMapFactory::createOrGetMMapMgr()->loadMap(request.MapId, request.GridX, request.GridY);
+}
+
+void GridPreloader::Release(Request& request)
+{
+    if (request.MMapLoaded)
+        MMAP::MMapFactory::createOrGetMMapMgr()->unloadMap(request.MapId, request.GridX, request.GridY);
+
+    request.MMapLoaded = false;
+    request.Terrain.reset();
+}
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GRID_PRELOADER_H_
+#define GRID_PRELOADER_H_
+
+#include "Define.h"
+#include "GridDefines.h"
+#include "Metric.h"
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+class GridMap;
+class Map;
+class Player;
+
+// Opt-in (MapPreload.Enable) loading of the grids players of a continent are heading to.
+// Every MapPreload.Interval the map thread predicts where each moving player will be in MapPreload.LookAhead seconds,
+// along the spline of the flight path for players on a taxi, and hands the grids around those points that are not
+// created yet to the MapPreload.Threads. They map and fault in the terrain file, load the mmap tile and read the vmap
+// models of the tile. The map thread still creates the grid and spawns its objects (EnsureGridCreated, EnsureGridLoaded)
+// but finds all files already loaded. A preload holds its terrain and mmap tile until the grid is created or expires.
+class WH_GAME_API GridPreloader
+{
+public:
+    explicit GridPreloader(Map& map);
+    ~GridPreloader();
+
+    [[nodiscard]] static bool IsEnabled();
+
+    void Update(uint32 diff);
+
+private:
+    struct Request
+    {
+        uint32 MapId{};
+        int32 GridX{}; // terrain file coordinates, GridCoord is mirrored
+        int32 GridY{};
+        bool LoadMMap{};
+        bool MMapLoaded{};
+        std::shared_ptr<GridMap> Terrain;
+        std::atomic<bool> Done{};
+        uint32 Age{};
+    };
+
+    typedef std::shared_ptr<Request> RequestPtr;
+
+    void PredictPlayer(Player* player, uint32 lookAhead);
+    void PreloadAround(float x, float y);
+    void Submit(GridCoord const& coord);
+    void Release(Request& request);
+
+    static void Load(Request& request);
+
+    Map& _map;
+    uint32 _timer{};
+    std::unordered_map<uint32 /*GridCoord id*/, RequestPtr> _requests;
+
+    MetricCounter _requestedMetric;
+    MetricCounter _usedMetric;
+    MetricCounter _expiredMetric;
+};
+
+#endif
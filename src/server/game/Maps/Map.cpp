@@ -26,19 +26,29 @@
 #include "GameConfig.h"
 #include "GameObjectModel.h"
 #include "GameTime.h"
+#include "GridMapStore.h"
+#include "GridPreloader.h"
 #include "GridNotifiers.h"
 #include "InstanceScript.h"
 #include "LFGMgr.h"
 #include "MapMgr.h"
+#include "MapRegionUpdater.h"
 #include "Metric.h"
 #include "MiscPackets.h"
 #include "ObjectAccessor.h"
+#include "PathRequestQueue.h"
 #include "ScriptMgr.h"
+#include "StringConvert.h"
+#include "Tokenize.h"
 #include "Transport.h"
 #include "VMapFactory.h"
 #include "VMapMgr2.h"
 #include "Vehicle.h"
 #include "Weather.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstring>
+#include <filesystem>
 #include <utility>
 
 union u_map_magic
@@ -74,8 +84,6 @@ Map::~Map()
 
     if (!m_scriptSchedule.empty())
         sMapMgr->DecreaseScheduledScriptCount(m_scriptSchedule.size());
-
-    MMAP::MMapFactory::createOrGetMMapMgr()->unloadMapInstance(GetId(), _instanceId);
 }
 
 bool Map::ExistMap(uint32 mapid, int gx, int gy)
@@ -198,15 +206,8 @@ void Map::LoadMap(int gx, int gy, bool reload)
         _gridMaps[gx][gy].reset();
     }
 
-    std::string mapName = Warhead::StringFormat(sWorld->GetDataPath() + "maps/{:03}{:02}{:02}.map", GetId(), gx, gy);
-
-    LOG_TRACE("maps", "Loading map {}", mapName);
-
-    // loading data
-    _gridMaps[gx][gy] = std::make_shared<GridMap>();
-
-    if (!_gridMaps[gx][gy]->LoadData(mapName))
-        LOG_ERROR("maps", "Error loading map file: {}", mapName);
+    // terrain is shared with every other map using the same grid (instances, reloads after grid unload)
+    _gridMaps[gx][gy] = sGridMapStore->Acquire(GetId(), gx, gy, reload);
 
     sScriptMgr->OnLoadGridMap(this, _gridMaps[gx][gy].get(), gx, gy);
 }
@@ -220,6 +221,9 @@ void Map::LoadMapAndVMap(int gx, int gy)
         LoadVMap(gx, gy); // Only load the data for the base map
         LoadMMap(gx, gy);
     }
+
+    // the vmap tile is there now, also when the base map loaded it for this instance
+    _collisionCache.InvalidateStatic();
 }
 
 Map::Map(uint32 id, uint32 InstanceId, uint8 SpawnMode, Map* _parent) :
@@ -229,7 +233,8 @@ Map::Map(uint32 id, uint32 InstanceId, uint8 SpawnMode, Map* _parent) :
     _visibleDistance(DEFAULT_VISIBILITY_DISTANCE),
     _activeNonPlayersIter(_activeNonPlayers.end()),
     _transportsUpdateIter(_transports.end()),
-    _defaultLight(GetDefaultMapLight(id))
+    _defaultLight(GetDefaultMapLight(id)),
+    _collisionCache(id)
 {
     m_parentMap = (_parent ? _parent : this);
 
@@ -246,6 +251,31 @@ Map::Map(uint32 id, uint32 InstanceId, uint8 SpawnMode, Map* _parent) :
     //lets initialize visibility distance for map
     Map::InitVisibilityDistance();
 
+    // metric handles, tags are built once here instead of on every update
+    _updateTimeMetric = MetricHistogram("map_update_time_diff", { METRIC_TAG("map_id", std::to_string(id)) });
+    _creaturesMetric = MetricGauge("map_creatures", { METRIC_TAG("map_id", std::to_string(id)), METRIC_TAG("map_instanceid", std::to_string(InstanceId)) });
+    _gameObjectsMetric = MetricGauge("map_gameobjects", { METRIC_TAG("map_id", std::to_string(id)), METRIC_TAG("map_instanceid", std::to_string(InstanceId)) });
+
+    _pathRequests = std::make_unique<PathRequestQueue>(*this);
+
+    if (!Instanceable() && GridPreloader::IsEnabled())
+        _gridPreloader = std::make_unique<GridPreloader>(*this);
+
+    // parallel region update, continents only
+    if (!Instanceable())
+    {
+        std::string const parallelMaps = CONF_GET_STR("MapUpdate.Parallel.Maps");
+
+        for (std::string_view mapIdStr : Warhead::Tokenize(parallelMaps, ',', false))
+        {
+            if (Warhead::StringTo<uint32>(mapIdStr) == id)
+            {
+                _regionUpdater = std::make_unique<MapRegionUpdater>(*this, CONF_GET_FLOAT("MapUpdate.Parallel.RegionGap"));
+                break;
+            }
+        }
+    }
+
     sScriptMgr->OnCreateMap(this);
 }
 
@@ -465,6 +495,8 @@ void Map::BuildNGridLinkage(std::shared_ptr<NGridType> pNGridType)
 //Create NGrid and load the object data in it
 bool Map::EnsureGridLoaded(const Cell& cell)
 {
+    auto guard = LockForRegionUpdate();
+
     EnsureGridCreated(GridCoord(cell.GridX(), cell.GridY()));
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -550,6 +582,8 @@ void Map::InitializeObject(GameObject*  /*obj*/)
 template<class T>
 bool Map::AddToMap(T* obj, bool checkTransport)
 {
+    auto guard = LockForRegionUpdate();
+
     //TODO: Needs clean up. An object should not be added to map twice.
     if (obj->IsInWorld())
     {
@@ -734,42 +768,8 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Warhead::Obj
     }
 }
 
-void Map::Update(const uint32 t_diff, const uint32 s_diff, bool  /*thread*/)
+void Map::UpdateNearbyCells(uint32 t_diff, uint32 s_diff)
 {
-    if (t_diff)
-        _dynamicTree.update(t_diff);
-
-    /// update worldsessions for existing players
-    for (m_mapRefIter = m_mapRefMgr.begin(); m_mapRefIter != m_mapRefMgr.end(); ++m_mapRefIter)
-    {
-        Player* player = m_mapRefIter->GetSource();
-        if (player && player->IsInWorld())
-        {
-            //player->Update(t_diff);
-            WorldSession* session = player->GetSession();
-            MapSessionFilter updater(session);
-            session->Update(s_diff, updater);
-        }
-    }
-
-    if (!t_diff)
-    {
-        for (m_mapRefIter = m_mapRefMgr.begin(); m_mapRefIter != m_mapRefMgr.end(); ++m_mapRefIter)
-        {
-            Player* player = m_mapRefIter->GetSource();
-
-            if (!player || !player->IsInWorld())
-                continue;
-
-            // update players at tick
-            player->Update(s_diff);
-        }
-
-        HandleDelayedVisibility();
-        return;
-    }
-
-    /// update active cells around players and active objects
     resetMarkedCells();
     resetMarkedCellsLarge();
 
@@ -851,7 +851,10 @@ void Map::Update(const uint32 t_diff, const uint32 s_diff, bool  /*thread*/)
                 VisitNearbyCellsOf(itr, grid_object_update, world_object_update, grid_large_object_update, world_large_object_update);
         }
     }
+}
 
+void Map::UpdateTransports(uint32 t_diff)
+{
     for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();) // pussywizard: transports updated after VisitNearbyCellsOf, grids around are loaded, everything ok
     {
         MotionTransport* transport = *_transportsUpdateIter;
@@ -862,6 +865,57 @@ void Map::Update(const uint32 t_diff, const uint32 s_diff, bool  /*thread*/)
 
         transport->Update(t_diff);
     }
+}
+
+void Map::Update(const uint32 t_diff, const uint32 s_diff, bool  /*thread*/)
+{
+    if (t_diff)
+        _dynamicTree.update(t_diff);
+
+    // paths requested during the previous update, movement generators pick them up below
+    _pathRequests->Process();
+
+    // grids the players are heading to, loaded in background before they arrive
+    if (_gridPreloader)
+        _gridPreloader->Update(t_diff);
+
+    /// update worldsessions for existing players
+    for (m_mapRefIter = m_mapRefMgr.begin(); m_mapRefIter != m_mapRefMgr.end(); ++m_mapRefIter)
+    {
+        Player* player = m_mapRefIter->GetSource();
+        if (player && player->IsInWorld())
+        {
+            //player->Update(t_diff);
+            WorldSession* session = player->GetSession();
+            MapSessionFilter updater(session);
+            session->Update(s_diff, updater);
+        }
+    }
+
+    if (!t_diff)
+    {
+        for (m_mapRefIter = m_mapRefMgr.begin(); m_mapRefIter != m_mapRefMgr.end(); ++m_mapRefIter)
+        {
+            Player* player = m_mapRefIter->GetSource();
+
+            if (!player || !player->IsInWorld())
+                continue;
+
+            // update players at tick
+            player->Update(s_diff);
+        }
+
+        HandleDelayedVisibility();
+        return;
+    }
+
+    /// update active cells around players and active objects
+    if (_regionUpdater)
+        _regionUpdater->Update(t_diff, s_diff);
+    else
+        UpdateNearbyCells(t_diff, s_diff);
+
+    UpdateTransports(t_diff);
 
     SendObjectUpdates();
 
@@ -881,13 +935,45 @@ void Map::Update(const uint32 t_diff, const uint32 s_diff, bool  /*thread*/)
 
     sScriptMgr->OnMapUpdate(this, t_diff);
 
-    METRIC_VALUE("map_creatures", uint64(GetObjectsStore().Size<Creature>()),
-        METRIC_TAG("map_id", std::to_string(GetId())),
-        METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+    _creaturesMetric.Set(int64(GetObjectsStore().Size<Creature>()));
+    _gameObjectsMetric.Set(int64(GetObjectsStore().Size<GameObject>()));
+}
+
+void Map::AddObjectForDelayedVisibility(Unit* unit)
+{
+    if (MapUpdateRegion* region = GetUpdateRegion())
+        region->ObjectsForDelayedVisibility.push_back(unit);
+    else
+        i_objectsForDelayedVisibility.insert(unit);
+}
+
+std::unique_lock<std::recursive_mutex> Map::LockForRegionUpdate() const
+{
+    if (GetUpdateRegion())
+        return std::unique_lock<std::recursive_mutex>(_regionUpdateLock);
+
+    return {};
+}
+
+MapUpdateRegion* Map::GetUpdateRegion() const
+{
+    return _regionUpdater ? MapRegionUpdater::GetCurrentRegion(this) : nullptr;
+}
 
-    METRIC_VALUE("map_gameobjects", uint64(GetObjectsStore().Size<GameObject>()),
-        METRIC_TAG("map_id", std::to_string(GetId())),
-        METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+void Map::AddUpdateObject(Object* obj)
+{
+    if (MapUpdateRegion* region = GetUpdateRegion())
+        region->UpdateObjects.emplace_back(obj, true);
+    else
+        _updateObjects.insert(obj);
+}
+
+void Map::RemoveUpdateObject(Object* obj)
+{
+    if (MapUpdateRegion* region = GetUpdateRegion())
+        region->UpdateObjects.emplace_back(obj, false);
+    else
+        _updateObjects.erase(obj);
 }
 
 void Map::HandleDelayedVisibility()
@@ -947,6 +1033,8 @@ void Map::AfterPlayerUnlinkFromMap()
 template<class T>
 void Map::RemoveFromMap(T* obj, bool remove)
 {
+    auto guard = LockForRegionUpdate();
+
     bool inWorld = obj->IsInWorld() && obj->GetTypeId() >= TYPEID_UNIT && obj->GetTypeId() <= TYPEID_GAMEOBJECT;
     obj->RemoveFromWorld();
 
@@ -1102,7 +1190,12 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
 void Map::AddCreatureToMoveList(Creature* c)
 {
     if (c->_moveState == MAP_OBJECT_CELL_MOVE_NONE)
-        _creaturesToMove.push_back(c);
+    {
+        if (MapUpdateRegion* region = GetUpdateRegion())
+            region->CreaturesToMove.push_back(c);
+        else
+            _creaturesToMove.push_back(c);
+    }
 
     c->_moveState = MAP_OBJECT_CELL_MOVE_ACTIVE;
 }
@@ -1116,7 +1209,12 @@ void Map::RemoveCreatureFromMoveList(Creature* c)
 void Map::AddGameObjectToMoveList(GameObject* go)
 {
     if (go->_moveState == MAP_OBJECT_CELL_MOVE_NONE)
-        _gameObjectsToMove.push_back(go);
+    {
+        if (MapUpdateRegion* region = GetUpdateRegion())
+            region->GameObjectsToMove.push_back(go);
+        else
+            _gameObjectsToMove.push_back(go);
+    }
 
     go->_moveState = MAP_OBJECT_CELL_MOVE_ACTIVE;
 }
@@ -1130,7 +1228,12 @@ void Map::RemoveGameObjectFromMoveList(GameObject* go)
 void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj)
 {
     if (dynObj->_moveState == MAP_OBJECT_CELL_MOVE_NONE)
-        _dynamicObjectsToMove.push_back(dynObj);
+    {
+        if (MapUpdateRegion* region = GetUpdateRegion())
+            region->DynamicObjectsToMove.push_back(dynObj);
+        else
+            _dynamicObjectsToMove.push_back(dynObj);
+    }
     dynObj->_moveState = MAP_OBJECT_CELL_MOVE_ACTIVE;
 }
 
@@ -1269,6 +1372,7 @@ bool Map::UnloadGrid(NGridType& ngrid)
         // x and y are swapped
         VMAP::VMapFactory::createOrGetVMapMgr()->unloadMap(GetId(), gx, gy);
         MMAP::MMapFactory::createOrGetMMapMgr()->unloadMap(GetId(), gx, gy);
+        _collisionCache.InvalidateStatic();
     }
 
     LOG_DEBUG("maps", "Unloading grid[{}, {}] for map {} finished", x, y, GetId());
@@ -1358,130 +1462,200 @@ bool GridMap::LoadData(std::string_view filename)
     // Unload old data if exist
     UnloadData();
 
-    map_fileheader header;
+    std::string const fileName(filename);
 
     // Not return error if file not found
-    FILE* in = fopen(filename.data(), "rb");
-    if (!in)
+    std::error_code error;
+    if (!std::filesystem::exists(fileName, error))
         return true;
 
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    try
+    {
+        boost::interprocess::file_mapping file(fileName.c_str(), boost::interprocess::read_only);
+        _mappedFile = std::make_unique<boost::interprocess::mapped_region>(file, boost::interprocess::read_only);
+    }
+    catch (boost::interprocess::interprocess_exception const& e)
     {
-        fclose(in);
+        LOG_ERROR("maps", "Unable to map file '{}': {}", filename, e.what());
+        return false;
+    }
+
+    _fileData = static_cast<uint8 const*>(_mappedFile->get_address());
+    _fileSize = _mappedFile->get_size();
+
+    map_fileheader header{};
+    if (!ReadHeader(header, 0))
+    {
+        UnloadData();
         return false;
     }
 
     if (header.mapMagic == MapMagic.asUInt && header.versionMagic == MapVersionMagic)
     {
         // loadup area data
-        if (header.areaMapOffset && !LoadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        if (header.areaMapOffset && !LoadAreaData(header.areaMapOffset, header.areaMapSize))
         {
             LOG_ERROR("maps", "Error loading map area data\n");
-            fclose(in);
+            UnloadData();
             return false;
         }
 
         // loadup height data
-        if (header.heightMapOffset && !LoadHeightData(in, header.heightMapOffset, header.heightMapSize))
+        if (header.heightMapOffset && !LoadHeightData(header.heightMapOffset, header.heightMapSize))
         {
             LOG_ERROR("maps", "Error loading map height data\n");
-            fclose(in);
+            UnloadData();
             return false;
         }
 
         // loadup liquid data
-        if (header.liquidMapOffset && !LoadLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
+        if (header.liquidMapOffset && !LoadLiquidData(header.liquidMapOffset, header.liquidMapSize))
         {
             LOG_ERROR("maps", "Error loading map liquids data\n");
-            fclose(in);
+            UnloadData();
             return false;
         }
 
         // loadup holes data (if any. check header.holesOffset)
-        if (header.holesSize && !LoadHolesData(in, header.holesOffset, header.holesSize))
+        if (header.holesSize && !LoadHolesData(header.holesOffset, header.holesSize))
         {
             LOG_ERROR("maps", "Error loading map holes data\n");
-            fclose(in);
+            UnloadData();
             return false;
         }
 
-        fclose(in);
         return true;
     }
 
     LOG_ERROR("maps", "Map file '{}' is from an incompatible clientversion. Please recreate using the mapextractor.", filename);
-    fclose(in);
+    UnloadData();
     return false;
 }
 
 void GridMap::UnloadData()
 {
+    _v9 = static_cast<float const*>(nullptr);
+    _v8 = static_cast<float const*>(nullptr);
+    _maxHeight = nullptr;
+    _minHeight = nullptr;
+    _areaMap = nullptr;
+    _liquidEntry = nullptr;
+    _liquidFlags = nullptr;
+    _liquidMap = nullptr;
+    _holes = nullptr;
+    _unalignedSections.clear();
+
+    _fileData = nullptr;
+    _fileSize = 0;
+    _mappedFile.reset();
+
     _gridGetHeight = &GridMap::GetHeightFromFlat;
 }
 
-bool GridMap::LoadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+void GridMap::Prefetch() const
+{
+    static constexpr std::size_t PREFETCH_STRIDE = 4096;
+
+    uint32 volatile checksum = 0;
+    for (std::size_t offset = 0; offset < _fileSize; offset += PREFETCH_STRIDE)
+        checksum = checksum + _fileData[offset];
+}
+
+template<typename T>
+bool GridMap::ReadHeader(T& header, uint32 offset) const
 {
-    map_areaHeader header;
-    fseek(in, offset, SEEK_SET);
+    if (std::size_t(offset) + sizeof(T) > _fileSize)
+        return false;
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapAreaMagic.asUInt)
+    std::memcpy(&header, _fileData + offset, sizeof(T));
+    return true;
+}
+
+template<typename T>
+T const* GridMap::MapSection(uint32 offset, std::size_t count)
+{
+    std::size_t const bytes = count * sizeof(T);
+    if (std::size_t(offset) + bytes > _fileSize)
+        return nullptr;
+
+    uint8 const* data = _fileData + offset;
+    if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0)
+        return reinterpret_cast<T const*>(data);
+
+    // Packed sections (e.g. flight bounds after uint8 heights) can start at an odd offset,
+    // those few bytes are copied to keep the reads aligned
+    auto& copy = _unalignedSections.emplace_back(std::make_unique<uint8[]>(bytes));
+    std::memcpy(copy.get(), data, bytes);
+    return reinterpret_cast<T const*>(copy.get());
+}
+
+bool GridMap::LoadAreaData(uint32 offset, uint32 /*size*/)
+{
+    map_areaHeader header{};
+    if (!ReadHeader(header, offset) || header.fourcc != MapAreaMagic.asUInt)
         return false;
 
     _gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
     {
-        _areaMap = std::make_unique<uint16[]>(16 * 16);
-        if (fread(_areaMap.get(), sizeof(uint16), 16 * 16, in) != 16 * 16)
+        _areaMap = MapSection<uint16>(offset + sizeof(header), 16 * 16);
+        if (!_areaMap)
             return false;
     }
 
     return true;
 }
 
-bool GridMap::LoadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::LoadHeightData(uint32 offset, uint32 /*size*/)
 {
-    map_heightHeader header;
-    fseek(in, offset, SEEK_SET);
-
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapHeightMagic.asUInt)
+    map_heightHeader header{};
+    if (!ReadHeader(header, offset) || header.fourcc != MapHeightMagic.asUInt)
         return false;
 
+    uint32 dataOffset = offset + sizeof(header);
+
     _gridHeight = header.gridHeight;
     if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            _v9 = std::make_unique<uint16[]>(129 * 129);
-            _v8 = std::make_unique<uint16[]>(128 * 128);
-
-            if (fread(std::get<std::unique_ptr<uint16[]>>(_v9).get(), sizeof(uint16), 129 * 129, in) != 129 * 129 ||
-                fread(std::get<std::unique_ptr<uint16[]>>(_v8).get(), sizeof(uint16), 128 * 128, in) != 128 * 128)
+            auto v9 = MapSection<uint16>(dataOffset, 129 * 129);
+            auto v8 = MapSection<uint16>(dataOffset + sizeof(uint16) * 129 * 129, 128 * 128);
+            if (!v9 || !v8)
                 return false;
 
+            _v9 = v9;
+            _v8 = v8;
+            dataOffset += sizeof(uint16) * (129 * 129 + 128 * 128);
+
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             _gridGetHeight = &GridMap::GetHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            _v9 = std::make_unique<uint8[]>(129 * 129);
-            _v8 = std::make_unique<uint8[]>(128 * 128);
-
-            if (fread(std::get<std::unique_ptr<uint8[]>>(_v9).get(), sizeof(uint8), 129 * 129, in) != 129 * 129 ||
-                fread(std::get<std::unique_ptr<uint8[]>>(_v8).get(), sizeof(uint8), 128 * 128, in) != 128 * 128)
+            auto v9 = MapSection<uint8>(dataOffset, 129 * 129);
+            auto v8 = MapSection<uint8>(dataOffset + sizeof(uint8) * 129 * 129, 128 * 128);
+            if (!v9 || !v8)
                 return false;
 
+            _v9 = v9;
+            _v8 = v8;
+            dataOffset += sizeof(uint8) * (129 * 129 + 128 * 128);
+
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             _gridGetHeight = &GridMap::GetHeightFromUint8;
         }
         else
         {
-            _v9 = std::make_unique<float[]>(129 * 129);
-            _v8 = std::make_unique<float[]>(128 * 128);
-
-            if (fread(std::get<std::unique_ptr<float[]>>(_v9).get(), sizeof(float), 129 * 129, in) != 129 * 129 ||
-                fread(std::get<std::unique_ptr<float[]>>(_v8).get(), sizeof(float), 128 * 128, in) != 128 * 128)
+            auto v9 = MapSection<float>(dataOffset, 129 * 129);
+            auto v8 = MapSection<float>(dataOffset + sizeof(float) * 129 * 129, 128 * 128);
+            if (!v9 || !v8)
                 return false;
 
+            _v9 = v9;
+            _v8 = v8;
+            dataOffset += sizeof(float) * (129 * 129 + 128 * 128);
+
             _gridGetHeight = &GridMap::GetHeightFromFloat;
         }
     }
@@ -1490,25 +1664,24 @@ bool GridMap::LoadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (header.flags & MAP_HEIGHT_HAS_FLIGHT_BOUNDS)
     {
-        _maxHeight = std::make_unique<int16[]>(3 * 3);
-        _minHeight = std::make_unique<int16[]>(3 * 3);
+        _maxHeight = MapSection<int16>(dataOffset, 3 * 3);
+        _minHeight = MapSection<int16>(dataOffset + sizeof(int16) * 3 * 3, 3 * 3);
 
-        if (fread(_maxHeight.get(), sizeof(int16), 3 * 3, in) != 3 * 3 ||
-            fread(_minHeight.get(), sizeof(int16), 3 * 3, in) != 3 * 3)
+        if (!_maxHeight || !_minHeight)
             return false;
     }
 
     return true;
 }
 
-bool GridMap::LoadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::LoadLiquidData(uint32 offset, uint32 /*size*/)
 {
-    map_liquidHeader header;
-    fseek(in, offset, SEEK_SET);
-
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapLiquidMagic.asUInt)
+    map_liquidHeader header{};
+    if (!ReadHeader(header, offset) || header.fourcc != MapLiquidMagic.asUInt)
         return false;
 
+    uint32 dataOffset = offset + sizeof(header);
+
     _liquidGlobalEntry = header.liquidType;
     _liquidGlobalFlags = header.liquidFlags;
     _liquidOffX  = header.offsetX;
@@ -1519,35 +1692,33 @@ bool GridMap::LoadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        _liquidEntry = std::make_unique<uint16[]>(16 * 16);
-        if (fread(_liquidEntry.get(), sizeof(uint16), 16 * 16, in) != 16 * 16)
+        _liquidEntry = MapSection<uint16>(dataOffset, 16 * 16);
+        if (!_liquidEntry)
             return false;
 
-        _liquidFlags = std::make_unique<uint8[]>(16 * 16);
-        if (fread(_liquidFlags.get(), sizeof(uint8), 16 * 16, in) != 16 * 16)
+        dataOffset += sizeof(uint16) * 16 * 16;
+
+        _liquidFlags = MapSection<uint8>(dataOffset, 16 * 16);
+        if (!_liquidFlags)
             return false;
+
+        dataOffset += sizeof(uint8) * 16 * 16;
     }
 
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        _liquidMap = std::make_unique<float[]>(uint32(_liquidWidth) * uint32(_liquidHeight));
-        if (fread(_liquidMap.get(), sizeof(float), _liquidWidth * _liquidHeight, in) != (uint32(_liquidWidth) * uint32(_liquidHeight)))
+        _liquidMap = MapSection<float>(dataOffset, uint32(_liquidWidth) * uint32(_liquidHeight));
+        if (!_liquidMap)
             return false;
     }
 
     return true;
 }
 
-bool GridMap::LoadHolesData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::LoadHolesData(uint32 offset, uint32 /*size*/)
 {
-    if (fseek(in, offset, SEEK_SET) != 0)
-        return false;
-
-    _holes = std::make_unique<uint16[]>(16 * 16);
-    if (fread(_holes.get(), sizeof(uint16), 16 * 16, in) != 16 * 16)
-        return false;
-
-    return true;
+    _holes = MapSection<uint16>(offset, 16 * 16);
+    return _holes != nullptr;
 }
 
 uint16 GridMap::GetArea(float x, float y) const
@@ -1569,7 +1740,7 @@ float GridMap::GetHeightFromFlat(float /*x*/, float /*y*/) const
 
 float GridMap::GetHeightFromFloat(float x, float y) const
 {
-    if (!std::holds_alternative<std::unique_ptr<float[]>>(_v8) || !std::holds_alternative<std::unique_ptr<float[]>>(_v9))
+    if (!std::holds_alternative<float const*>(_v8) || !std::holds_alternative<float const*>(_v9))
         return _gridHeight;
 
     x = MAP_RESOLUTION * (32 - x / SIZE_OF_GRIDS);
@@ -1601,8 +1772,8 @@ float GridMap::GetHeightFromFloat(float x, float y) const
     // Calculate coefficients for solve h = a*x + b*y + c
 
     float a, b, c;
-    auto v9 = std::get<std::unique_ptr<float[]>>(_v9).get();
-    auto v8 = std::get<std::unique_ptr<float[]>>(_v8).get();
+    auto v9 = std::get<float const*>(_v9);
+    auto v8 = std::get<float const*>(_v8);
 
     // Select triangle:
     if (x + y < 1)
@@ -1658,7 +1829,7 @@ float GridMap::GetHeightFromFloat(float x, float y) const
 
 float GridMap::GetHeightFromUint8(float x, float y) const
 {
-    if (!std::holds_alternative<std::unique_ptr<uint8[]>>(_v8) || !std::holds_alternative<std::unique_ptr<uint8[]>>(_v9))
+    if (!std::holds_alternative<uint8 const*>(_v8) || !std::holds_alternative<uint8 const*>(_v9))
         return _gridHeight;
 
     x = MAP_RESOLUTION * (32 - x / SIZE_OF_GRIDS);
@@ -1674,11 +1845,11 @@ float GridMap::GetHeightFromUint8(float x, float y) const
     if (isHole(x_int, y_int))
         return INVALID_HEIGHT;
 
-    auto v9 = std::get<std::unique_ptr<uint8[]>>(_v9).get();
-    auto v8 = std::get<std::unique_ptr<uint8[]>>(_v8).get();
+    auto v9 = std::get<uint8 const*>(_v9);
+    auto v8 = std::get<uint8 const*>(_v8);
 
     int32 a, b, c;
-    uint8* V9_h1_ptr = &v9[x_int * 128 + x_int + y_int];
+    uint8 const* V9_h1_ptr = &v9[x_int * 128 + x_int + y_int];
 
     if (x + y < 1)
     {
@@ -1733,7 +1904,7 @@ float GridMap::GetHeightFromUint8(float x, float y) const
 
 float GridMap::GetHeightFromUint16(float x, float y) const
 {
-    if (!std::holds_alternative<std::unique_ptr<uint16[]>>(_v8) || !std::holds_alternative<std::unique_ptr<uint16[]>>(_v9))
+    if (!std::holds_alternative<uint16 const*>(_v8) || !std::holds_alternative<uint16 const*>(_v9))
         return _gridHeight;
 
     x = MAP_RESOLUTION * (32 - x / SIZE_OF_GRIDS);
@@ -1750,9 +1921,9 @@ float GridMap::GetHeightFromUint16(float x, float y) const
         return INVALID_HEIGHT;
 
     int32 a, b, c;
-    auto v9 = std::get<std::unique_ptr<uint16[]>>(_v9).get();
-    auto v8 = std::get<std::unique_ptr<uint16[]>>(_v8).get();
-    uint16* V9_h1_ptr = &v9[x_int * 128 + x_int + y_int];
+    auto v9 = std::get<uint16 const*>(_v9);
+    auto v8 = std::get<uint16 const*>(_v8);
+    uint16 const* V9_h1_ptr = &v9[x_int * 128 + x_int + y_int];
 
     if (x + y < 1)
     {
@@ -2031,6 +2202,7 @@ Transport* Map::GetTransportForPos(uint32 phase, float x, float y, float z, Worl
     G3D::Vector3 v(x, y, z + 2.0f);
     G3D::Ray r(v, G3D::Vector3(0, 0, -1));
 
+    auto guard = LockForRegionUpdate();
     for (auto _transport : _transports)
     {
         if (_transport->IsInWorld() && _transport->GetExactDistSq(x, y, z) < 75.0f * 75.0f && _transport->m_model)
@@ -2079,8 +2251,27 @@ float Map::GetHeight(Position const& pos, bool checkVMap /*= true*/, float maxSe
     float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;
     if (checkVMap)
     {
-        VMAP::IVMapMgr* vmgr = VMAP::VMapFactory::createOrGetVMapMgr();
-        vmapHeight = vmgr->getHeight(GetId(), pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), maxSearchDist);   // look from a bit higher pos to find the floor
+        // static vmap models only, gameobject floors don't change the result
+        Optional<MapCollisionCache::Key> cacheKey;
+        Optional<float> cachedHeight;
+        uint32 staticGeneration = 0;
+        if (_collisionCache.IsEnabled())
+        {
+            cacheKey = _collisionCache.MakeHeightKey(pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), maxSearchDist);
+            staticGeneration = _collisionCache.GetStaticGeneration();
+            cachedHeight = _collisionCache.Find(*cacheKey, staticGeneration, {});
+        }
+
+        if (cachedHeight)
+            vmapHeight = *cachedHeight;
+        else
+        {
+            VMAP::IVMapMgr* vmgr = VMAP::VMapFactory::createOrGetVMapMgr();
+            vmapHeight = vmgr->getHeight(GetId(), pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), maxSearchDist);   // look from a bit higher pos to find the floor
+
+            if (cacheKey)
+                _collisionCache.Store(*cacheKey, staticGeneration, {}, vmapHeight, 1);
+        }
     }
 
     // mapHeight set for any above raw ground Z or <= INVALID_HEIGHT
@@ -2142,7 +2333,15 @@ bool Map::GetAreaInfo(uint32 phaseMask, float x, float y, float z, uint32& flags
     int32 dgroupId{};
 
     bool hasVmapAreaInfo = vmgr->GetAreaInfo(GetId(), x, y, vmap_z, vflags, vadtId, vrootId, vgroupId);
-    bool hasDynamicAreaInfo = _dynamicTree.GetAreaInfo(x, y, dynamic_z, phaseMask, dflags, dadtId, drootId, dgroupId);
+    bool hasDynamicAreaInfo;
+    {
+        std::shared_lock<std::shared_mutex> guard(_dynamicTreeLock, std::defer_lock);
+        if (GetUpdateRegion())
+            guard.lock();
+
+        hasDynamicAreaInfo = _dynamicTree.GetAreaInfo(x, y, dynamic_z, phaseMask, dflags, dadtId, drootId, dgroupId);
+    }
+
     auto useVmap = [&]() { check_z = vmap_z; flags = vflags; adtId = vadtId; rootId = vrootId; groupId = vgroupId; };
     auto useDyn = [&]() { check_z = dynamic_z; flags = dflags; adtId = dadtId; rootId = drootId; groupId = dgroupId; };
 
@@ -2474,26 +2673,60 @@ bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, floa
     if (!CONF_GET_BOOL("vmap.BlizzlikePvPLOS") && IsBattlegroundOrArena())
         ignoreFlags = VMAP::ModelIgnoreFlags::Nothing;
 
-    if ((checks & LINEOFSIGHT_CHECK_VMAP) && !VMAP::VMapFactory::createOrGetVMapMgr()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2, ignoreFlags))
+    // Creature packs and area spells ask nearly the same question many times per update
+    Optional<MapCollisionCache::Key> cacheKey;
+    uint32 staticGeneration = 0;
+    Optional<uint32> dynamicGeneration;
+    if (_collisionCache.IsEnabled())
     {
-        return false;
+        cacheKey = _collisionCache.MakeLineOfSightKey(x1, y1, z1, x2, y2, z2, phasemask, uint32(checks), uint32(ignoreFlags));
+        staticGeneration = _collisionCache.GetStaticGeneration();
+        if (CONF_GET_BOOL("CheckGameObjectLoS") && (checks & LINEOFSIGHT_CHECK_GOBJECT_ALL))
+            dynamicGeneration = _dynamicTree.GetGeneration();
+
+        if (Optional<float> result = _collisionCache.Find(*cacheKey, staticGeneration, dynamicGeneration))
+            return *result != 0.0f;
     }
 
-    if (CONF_GET_BOOL("CheckGameObjectLoS") && (checks & LINEOFSIGHT_CHECK_GOBJECT_ALL))
+    uint8 traversals = 0;
+    auto checkLineOfSight = [&]()
     {
-        ignoreFlags = VMAP::ModelIgnoreFlags::Nothing;
-        if (!(checks & LINEOFSIGHT_CHECK_GOBJECT_M2))
+        if (checks & LINEOFSIGHT_CHECK_VMAP)
         {
-            ignoreFlags = VMAP::ModelIgnoreFlags::M2;
+            ++traversals;
+            if (!VMAP::VMapFactory::createOrGetVMapMgr()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2, ignoreFlags))
+            {
+                return false;
+            }
         }
 
-        if (!_dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask, ignoreFlags))
+        if (CONF_GET_BOOL("CheckGameObjectLoS") && (checks & LINEOFSIGHT_CHECK_GOBJECT_ALL))
         {
-            return false;
+            ignoreFlags = VMAP::ModelIgnoreFlags::Nothing;
+            if (!(checks & LINEOFSIGHT_CHECK_GOBJECT_M2))
+            {
+                ignoreFlags = VMAP::ModelIgnoreFlags::M2;
+            }
+
+            std::shared_lock<std::shared_mutex> guard(_dynamicTreeLock, std::defer_lock);
+            if (GetUpdateRegion())
+                guard.lock();
+
+            ++traversals;
+            if (!_dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask, ignoreFlags))
+            {
+                return false;
+            }
         }
-    }
 
-    return true;
+        return true;
+    };
+
+    bool result = checkLineOfSight();
+    if (cacheKey)
+        _collisionCache.Store(*cacheKey, staticGeneration, dynamicGeneration, result ? 1.0f : 0.0f, traversals);
+
+    return result;
 }
 
 bool Map::GetObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
@@ -2502,7 +2735,14 @@ bool Map::GetObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float
     G3D::Vector3 dstPos(x2, y2, z2);
 
     G3D::Vector3 resultPos;
-    bool result = _dynamicTree.GetObjectHitPos(phasemask, startPos, dstPos, resultPos, modifyDist);
+    bool result;
+    {
+        std::shared_lock<std::shared_mutex> guard(_dynamicTreeLock, std::defer_lock);
+        if (GetUpdateRegion())
+            guard.lock();
+
+        result = _dynamicTree.GetObjectHitPos(phasemask, startPos, dstPos, resultPos, modifyDist);
+    }
 
     rx = resultPos.x;
     ry = resultPos.y;
@@ -2514,10 +2754,61 @@ float Map::GetHeight(uint32 phasemask, float x, float y, float z, bool vmap/*=tr
 {
     float h1, h2;
     h1 = GetHeight(x, y, z, vmap, maxSearchDist);
-    h2 = _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask);
+    h2 = GetGameObjectFloor(phasemask, x, y, z, maxSearchDist);
     return std::max<float>(h1, h2);
 }
 
+float Map::GetGameObjectFloor(uint32 phasemask, float x, float y, float z, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/) const
+{
+    std::shared_lock<std::shared_mutex> guard(_dynamicTreeLock, std::defer_lock);
+    if (GetUpdateRegion())
+        guard.lock();
+
+    return _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask);
+}
+
+// Gameobject models are only changed by one region at a time, the readers above take the shared lock meanwhile
+void Map::Balance()
+{
+    std::unique_lock<std::shared_mutex> guard(_dynamicTreeLock, std::defer_lock);
+    if (GetUpdateRegion())
+        guard.lock();
+
+    _dynamicTree.balance();
+}
+
+void Map::RemoveGameObjectModel(const GameObjectModel& model)
+{
+    std::unique_lock<std::shared_mutex> guard(_dynamicTreeLock, std::defer_lock);
+    if (GetUpdateRegion())
+        guard.lock();
+
+    _dynamicTree.remove(model);
+}
+
+void Map::InsertGameObjectModel(const GameObjectModel& model)
+{
+    std::unique_lock<std::shared_mutex> guard(_dynamicTreeLock, std::defer_lock);
+    if (GetUpdateRegion())
+        guard.lock();
+
+    _dynamicTree.insert(model);
+}
+
+void Map::NotifyGameObjectModelChanged()
+{
+    _dynamicTree.NotifyModelChanged();
+}
+
+bool Map::ContainsGameObjectModel(const GameObjectModel& model) const
+{
+    std::shared_lock<std::shared_mutex> guard(_dynamicTreeLock, std::defer_lock);
+    if (GetUpdateRegion())
+        guard.lock();
+
+    return _dynamicTree.contains(model);
+}
+
 bool Map::IsInWater(uint32 phaseMask, float x, float y, float pZ, float collisionHeight) const
 {
     LiquidData const& liquidData = const_cast<Map*>(this)->GetLiquidData(phaseMask, x, y, pZ, collisionHeight, MAP_ALL_LIQUIDS);
@@ -2671,6 +2962,12 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
     obj->CleanupsBeforeDelete(false);                            // remove or simplify at least cross referenced links
 
+    if (MapUpdateRegion* region = GetUpdateRegion())
+    {
+        region->ObjectsToRemove.push_back(obj);
+        return;
+    }
+
     i_objectsToRemove.insert(obj);
     //LOG_DEBUG("maps", "Object ({}) added to removing list.", obj->GetGUID().ToString());
 }
@@ -2683,6 +2980,12 @@ void Map::AddObjectToSwitchList(WorldObject* obj, bool on)
     if (obj->GetTypeId() != TYPEID_UNIT && obj->GetTypeId() != TYPEID_GAMEOBJECT)
         return;
 
+    if (MapUpdateRegion* region = GetUpdateRegion())
+    {
+        region->ObjectsToSwitch.emplace_back(obj, on);
+        return;
+    }
+
     auto itr = i_objectsToSwitch.find(obj);
     if (itr == i_objectsToSwitch.end())
         i_objectsToSwitch.insert(itr, std::make_pair(obj, on));
@@ -2770,8 +3073,12 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const* data) const
 {
+    if (m_mapRefMgr.IsEmpty())
+        return;
+
+    SharedWorldPacket sharedData = std::make_shared<WorldPacket const>(*data);
     for (MapRefMgr::const_iterator itr = m_mapRefMgr.begin(); itr != m_mapRefMgr.end(); ++itr)
-        itr->GetSource()->GetSession()->SendPacket(data);
+        itr->GetSource()->GetSession()->SendPacket(sharedData);
 }
 
 template<class T>
@@ -3383,21 +3690,25 @@ void BattlegroundMap::RemoveAllPlayers()
 
 Corpse* Map::GetCorpse(ObjectGuid const guid)
 {
+    auto guard = LockForRegionUpdate();
     return _objectsStore.Find<Corpse>(guid);
 }
 
 Creature* Map::GetCreature(ObjectGuid const guid)
 {
+    auto guard = LockForRegionUpdate();
     return _objectsStore.Find<Creature>(guid);
 }
 
 GameObject* Map::GetGameObject(ObjectGuid const guid)
 {
+    auto guard = LockForRegionUpdate();
     return _objectsStore.Find<GameObject>(guid);
 }
 
 Pet* Map::GetPet(ObjectGuid const guid)
 {
+    auto guard = LockForRegionUpdate();
     return _objectsStore.Find<Pet>(guid);
 }
 
@@ -3406,12 +3717,14 @@ Transport* Map::GetTransport(ObjectGuid guid)
     if (guid.GetHigh() != HighGuid::Mo_Transport && guid.GetHigh() != HighGuid::Transport)
         return nullptr;
 
+    auto guard = LockForRegionUpdate();
     GameObject* go = GetGameObject(guid);
     return go ? go->ToTransport() : nullptr;
 }
 
 DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
 {
+    auto guard = LockForRegionUpdate();
     return _objectsStore.Find<DynamicObject>(guid);
 }
 
@@ -3423,6 +3736,8 @@ void Map::UpdateIteratorBack(Player* player)
 
 void Map::SaveCreatureRespawnTime(ObjectGuid::LowType spawnId, time_t& respawnTime)
 {
+    auto guard = LockForRegionUpdate();
+
     if (!respawnTime)
     {
         // Delete only
@@ -3446,6 +3761,8 @@ void Map::SaveCreatureRespawnTime(ObjectGuid::LowType spawnId, time_t& respawnTi
 
 void Map::RemoveCreatureRespawnTime(ObjectGuid::LowType spawnId)
 {
+    auto guard = LockForRegionUpdate();
+
     _creatureRespawnTimes.erase(spawnId);
 
     CharacterDatabasePreparedStatement stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CREATURE_RESPAWN);
@@ -3457,6 +3774,8 @@ void Map::RemoveCreatureRespawnTime(ObjectGuid::LowType spawnId)
 
 void Map::SaveGORespawnTime(ObjectGuid::LowType spawnId, time_t& respawnTime)
 {
+    auto guard = LockForRegionUpdate();
+
     if (!respawnTime)
     {
         // Delete only
@@ -3480,6 +3799,8 @@ void Map::SaveGORespawnTime(ObjectGuid::LowType spawnId, time_t& respawnTime)
 
 void Map::RemoveGORespawnTime(ObjectGuid::LowType spawnId)
 {
+    auto guard = LockForRegionUpdate();
+
     _goRespawnTimes.erase(spawnId);
 
     CharacterDatabasePreparedStatement stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_GO_RESPAWN);
@@ -3672,6 +3993,8 @@ time_t Map::GetLinkedRespawnTime(ObjectGuid guid) const
 
 void Map::AddCorpse(Corpse* corpse)
 {
+    auto guard = LockForRegionUpdate();
+
     corpse->SetMap(this);
 
     _corpsesByCell[corpse->GetCellCoord().GetId()].insert(corpse);
@@ -3683,6 +4006,8 @@ void Map::AddCorpse(Corpse* corpse)
 
 void Map::RemoveCorpse(Corpse* corpse)
 {
+    auto guard = LockForRegionUpdate();
+
     ASSERT(corpse);
 
     corpse->DestroyForNearbyPlayers();
@@ -3703,6 +4028,7 @@ void Map::RemoveCorpse(Corpse* corpse)
 
 Corpse* Map::ConvertCorpseToBones(ObjectGuid const ownerGuid, bool insignia /*= false*/)
 {
+    auto guard = LockForRegionUpdate();
     Corpse* corpse = GetCorpseByPlayer(ownerGuid);
     if (!corpse)
         return nullptr;
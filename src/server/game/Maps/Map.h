@@ -21,10 +21,13 @@
 #include "Cell.h"
 #include "DBCStructure.h"
 #include "DataMap.h"
+#include "Duration.h"
 #include "DynamicTree.h"
 #include "GridDefines.h"
 #include "GridRefMgr.h"
+#include "MapCollisionCache.h"
 #include "MapRefMgr.h"
+#include "Metric.h"
 #include "ObjectDefines.h"
 #include "ObjectGuid.h"
 #include <bitset>
@@ -33,6 +36,7 @@
 #include <mutex>
 #include <shared_mutex>
 #include <variant>
+#include <vector>
 
 class Unit;
 class WorldPacket;
@@ -46,15 +50,19 @@ class Player;
 class CreatureGroup;
 class Battleground;
 class MapInstanced;
+class MapRegionUpdater;
 class InstanceMap;
 class BattlegroundMap;
 class Transport;
 class StaticTransport;
 class MotionTransport;
 class PathGenerator;
+class PathRequestQueue;
+class GridPreloader;
 class GameObjectModel;
 class MapEntry;
 
+struct MapUpdateRegion;
 struct ScriptInfo;
 struct ScriptAction;
 struct Position;
@@ -194,6 +202,14 @@ enum LineOfSightChecks
     LINEOFSIGHT_ALL_CHECKS          = LINEOFSIGHT_CHECK_VMAP | LINEOFSIGHT_CHECK_GOBJECT_ALL
 };
 
+namespace boost::interprocess
+{
+    class mapped_region;
+}
+
+// Terrain of a single .map file. Sections are not copied out of the file: the file is
+// mapped read-only and lookups read straight from the mapped pages, so every map sharing
+// this object (see GridMapStore) also shares the same physical memory.
 class WH_GAME_API GridMap
 {
 public:
@@ -209,13 +225,24 @@ public:
     [[nodiscard]] float GetLiquidLevel(float x, float y) const;
     [[nodiscard]] LiquidData const GetLiquidData(float x, float y, float z, float collisionHeight, uint8 ReqLiquidType) const;
 
+    [[nodiscard]] std::size_t GetMappedSize() const { return _fileSize; }
+
+    // Faults the mapped pages in, so the first lookups of the map thread don't wait on disk reads
+    void Prefetch() const;
+
 private:
-    bool LoadAreaData(FILE* in, uint32 offset, uint32 size);
-    bool LoadHeightData(FILE* in, uint32 offset, uint32 size);
-    bool LoadLiquidData(FILE* in, uint32 offset, uint32 size);
-    bool LoadHolesData(FILE* in, uint32 offset, uint32 size);
+    bool LoadAreaData(uint32 offset, uint32 size);
+    bool LoadHeightData(uint32 offset, uint32 size);
+    bool LoadLiquidData(uint32 offset, uint32 size);
+    bool LoadHolesData(uint32 offset, uint32 size);
     [[nodiscard]] bool isHole(int row, int col) const;
 
+    template<typename T>
+    bool ReadHeader(T& header, uint32 offset) const;
+
+    template<typename T>
+    T const* MapSection(uint32 offset, std::size_t count);
+
     // Get height functions and pointers
     typedef float (GridMap::*GetHeightPtr)(float x, float y) const;
     GetHeightPtr _gridGetHeight;
@@ -225,26 +252,32 @@ private:
     [[nodiscard]] float GetHeightFromUint8(float x, float y) const;
     [[nodiscard]] float GetHeightFromFlat(float x, float y) const;
 
+    // Backing storage
+    std::unique_ptr<boost::interprocess::mapped_region> _mappedFile;
+    std::vector<std::unique_ptr<uint8[]>> _unalignedSections;
+    uint8 const* _fileData{};
+    std::size_t _fileSize{};
+
     uint32 _flags{};
 
-    std::variant<std::unique_ptr<float[]>, std::unique_ptr<uint16[]>, std::unique_ptr<uint8[]>> _v9;
-    std::variant<std::unique_ptr<float[]>, std::unique_ptr<uint16[]>, std::unique_ptr<uint8[]>> _v8;
+    std::variant<float const*, uint16 const*, uint8 const*> _v9;
+    std::variant<float const*, uint16 const*, uint8 const*> _v8;
 
-    std::unique_ptr<int16[]> _maxHeight;
-    std::unique_ptr<int16[]> _minHeight;
+    int16 const* _maxHeight{};
+    int16 const* _minHeight{};
 
     // Height level data
     float _gridHeight{ INVALID_HEIGHT };
     float _gridIntHeightMultiplier{};
 
     // Area data
-    std::unique_ptr<uint16[]> _areaMap;
+    uint16 const* _areaMap{};
 
     // Liquid data
     float _liquidLevel{ INVALID_HEIGHT };
-    std::unique_ptr<uint16[]> _liquidEntry;
-    std::unique_ptr<uint8[]> _liquidFlags;
-    std::unique_ptr<float[]> _liquidMap;
+    uint16 const* _liquidEntry{};
+    uint8 const* _liquidFlags{};
+    float const* _liquidMap{};
     uint16 _gridArea{};
     uint16 _liquidGlobalEntry{};
     uint8 _liquidGlobalFlags{};
@@ -252,7 +285,7 @@ private:
     uint8 _liquidOffY{};
     uint8 _liquidWidth{};
     uint8 _liquidHeight{};
-    std::unique_ptr<uint16[]> _holes;
+    uint16 const* _holes{};
 };
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push, N), also any gcc version not support it at some platform
@@ -320,6 +353,8 @@ enum MapEnterState : uint8
 class WH_GAME_API Map : public GridRefMgr<NGridType>
 {
     friend class MapReference;
+    friend class MapRegionUpdater;
+    friend class GridPreloader;
 
 public:
     Map(uint32 id, uint32 InstanceId, uint8 SpawnMode, Map* _parent = nullptr);
@@ -362,6 +397,11 @@ public:
 
     virtual void Update(uint32, uint32, bool thread = true);
 
+    // Duration of the last update, MapUpdater schedules the most expensive maps first
+    [[nodiscard]] Microseconds GetLastUpdateCost() const { return _lastUpdateCost; }
+    void SetLastUpdateCost(Microseconds cost) { _lastUpdateCost = cost; }
+    [[nodiscard]] MetricHistogram const& GetUpdateTimeMetric() const { return _updateTimeMetric; }
+
     [[nodiscard]] float GetVisibilityRange() const { return _visibleDistance; }
     void SetVisibilityRange(float range) { _visibleDistance = range; }
 
@@ -404,8 +444,12 @@ public:
 
     // pussywizard:
     std::unordered_set<Unit*> i_objectsForDelayedVisibility;
+    void AddObjectForDelayedVisibility(Unit* unit);
     void HandleDelayedVisibility();
 
+    // Held while touching map data shared between regions updated in parallel (MapUpdate.Parallel.Maps), no-op otherwise
+    [[nodiscard]] std::unique_lock<std::recursive_mutex> LockForRegionUpdate() const;
+
     // some calls like isInWater should not use vmaps due to processor power
     // can return INVALID_HEIGHT if under z+2 z coord not found height
     [[nodiscard]] float GetHeight(float x, float y, float z, bool checkVMap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
@@ -518,6 +562,7 @@ public:
     typedef std::unordered_multimap<ObjectGuid::LowType, GameObject*> GameObjectBySpawnIdContainer;
     GameObjectBySpawnIdContainer& GetGameObjectBySpawnIdStore() { return _gameobjectBySpawnIdStore; }
 
+    // hold LockForRegionUpdate while using the result
     [[nodiscard]] std::unordered_set<Corpse*> const* GetCorpsesInCell(uint32 cellId) const
     {
         auto itr = _corpsesByCell.find(cellId);
@@ -529,6 +574,7 @@ public:
 
     [[nodiscard]] Corpse* GetCorpseByPlayer(ObjectGuid const& ownerGuid) const
     {
+        auto guard = LockForRegionUpdate();
         auto itr = _corpsesByPlayer.find(ownerGuid);
         if (itr != _corpsesByPlayer.end())
             return itr->second;
@@ -552,17 +598,16 @@ public:
     bool CanReachPositionAndGetValidCoords(WorldObject const* source, float &destX, float &destY, float &destZ, bool failOnCollision = true, bool failOnSlopes = true) const;
     bool CanReachPositionAndGetValidCoords(WorldObject const* source, float startX, float startY, float startZ, float &destX, float &destY, float &destZ, bool failOnCollision = true, bool failOnSlopes = true) const;
     bool CheckCollisionAndGetValidCoords(WorldObject const* source, float startX, float startY, float startZ, float &destX, float &destY, float &destZ, bool failOnCollision = true) const;
-    void Balance() { _dynamicTree.balance(); }
-    void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
-    void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); }
-    [[nodiscard]] bool ContainsGameObjectModel(const GameObjectModel& model) const { return _dynamicTree.contains(model);}
+    void Balance();
+    void RemoveGameObjectModel(const GameObjectModel& model);
+    void InsertGameObjectModel(const GameObjectModel& model);
+    [[nodiscard]] bool ContainsGameObjectModel(const GameObjectModel& model) const;
+    void NotifyGameObjectModelChanged(); // model enabled or disabled in place, cached collision results are stale
     [[nodiscard]] DynamicMapTree const& GetDynamicMapTree() const { return _dynamicTree; }
+    [[nodiscard]] PathRequestQueue& GetPathRequests() { return *_pathRequests; }
     bool GetObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist);
 
-    [[nodiscard]] float GetGameObjectFloor(uint32 phasemask, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const
-    {
-        return _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask);
-    }
+    [[nodiscard]] float GetGameObjectFloor(uint32 phasemask, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
 
     /*
         RESPAWN TIMES
@@ -570,6 +615,7 @@ public:
     [[nodiscard]] time_t GetLinkedRespawnTime(ObjectGuid guid) const;
     [[nodiscard]] time_t GetCreatureRespawnTime(ObjectGuid::LowType dbGuid) const
     {
+        auto guard = LockForRegionUpdate();
         auto itr = _creatureRespawnTimes.find(dbGuid);
         if (itr != _creatureRespawnTimes.end())
             return itr->second;
@@ -579,6 +625,7 @@ public:
 
     [[nodiscard]] time_t GetGORespawnTime(ObjectGuid::LowType dbGuid) const
     {
+        auto guard = LockForRegionUpdate();
         auto itr = _goRespawnTimes.find(dbGuid);
         if (itr != _goRespawnTimes.end())
             return itr->second;
@@ -632,18 +679,12 @@ public:
     inline ObjectGuid::LowType GenerateLowGuid()
     {
         static_assert(ObjectGuidTraits<high>::MapSpecific, "Only map specific guid can be generated in Map context");
+        auto guard = LockForRegionUpdate();
         return GetGuidSequenceGenerator<high>().Generate();
     }
 
-    void AddUpdateObject(Object* obj)
-    {
-        _updateObjects.insert(obj);
-    }
-
-    void RemoveUpdateObject(Object* obj)
-    {
-        _updateObjects.erase(obj);
-    }
+    void AddUpdateObject(Object* obj);
+    void RemoveUpdateObject(Object* obj);
 
     size_t GetActiveNonPlayersCount() const
     {
@@ -690,6 +731,9 @@ private:
     void setGridObjectDataLoaded(bool pLoaded, uint32 x, uint32 y) { getNGrid(x, y)->setGridObjectDataLoaded(pLoaded); }
 
     void setNGrid(std::shared_ptr<NGridType> grid, uint32 x, uint32 y);
+    void UpdateNearbyCells(uint32 t_diff, uint32 s_diff);
+    void UpdateTransports(uint32 t_diff);
+    [[nodiscard]] MapUpdateRegion* GetUpdateRegion() const;
     void ScriptsProcess();
     void SendObjectUpdates();
 
@@ -753,11 +797,14 @@ private:
 
     void AddToActiveHelper(WorldObject* obj)
     {
+        auto guard = LockForRegionUpdate();
         _activeNonPlayers.insert(obj);
     }
 
     void RemoveFromActiveHelper(WorldObject* obj)
     {
+        auto guard = LockForRegionUpdate();
+
         // Map::Update for active object in proccess
         if (_activeNonPlayersIter != _activeNonPlayers.end())
         {
@@ -797,6 +844,19 @@ private:
     std::unordered_set<Corpse*> _corpseBones;
 
     std::unordered_set<Object*> _updateObjects;
+
+    Microseconds _lastUpdateCost{};
+
+    MetricHistogram _updateTimeMetric;
+    MetricGauge _creaturesMetric;
+    MetricGauge _gameObjectsMetric;
+
+    std::unique_ptr<MapRegionUpdater> _regionUpdater;
+    std::unique_ptr<PathRequestQueue> _pathRequests;
+    std::unique_ptr<GridPreloader> _gridPreloader;
+    mutable std::recursive_mutex _regionUpdateLock;
+    mutable std::shared_mutex _dynamicTreeLock;
+    mutable MapCollisionCache _collisionCache;
 };
 
 enum InstanceResetMethod
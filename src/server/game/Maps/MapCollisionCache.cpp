@@ -0,0 +1,130 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "MapCollisionCache.h"
+#include "GameConfig.h"
+#include <cmath>
+
+namespace
+{
+    enum CollisionQueryType : int32
+    {
+        COLLISION_QUERY_LINE_OF_SIGHT = 0,
+        COLLISION_QUERY_HEIGHT        = 1
+    };
+}
+
+MapCollisionCache::MapCollisionCache(uint32 mapId) :
+    _hitsMetric("map_collision_cache", { METRIC_TAG("map_id", std::to_string(mapId)), METRIC_TAG("type", "Hit") }),
+    _missesMetric("map_collision_cache", { METRIC_TAG("map_id", std::to_string(mapId)), METRIC_TAG("type", "Miss") }),
+    _savedTraversalsMetric("map_collision_cache", { METRIC_TAG("map_id", std::to_string(mapId)), METRIC_TAG("type", "Saved traversals") })
+{
+    float gridSize = CONF_GET_FLOAT("vmap.QueryCache.GridSize");
+    _enabled = CONF_GET_BOOL("vmap.QueryCache") && gridSize > 0.0f;
+    _cellsPerYard = _enabled ? 1.0f / gridSize : 0.0f;
+}
+
+int32 MapCollisionCache::Quantize(float value) const
+{
+    return int32(std::floor(value * _cellsPerYard));
+}
+
+MapCollisionCache::Key MapCollisionCache::MakeLineOfSightKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, uint32 checks, uint32 ignoreFlags) const
+{
+    // Query type, checks and ignore flags are small, they share one value
+    int32 params = COLLISION_QUERY_LINE_OF_SIGHT | int32(checks << 8) | int32(ignoreFlags << 16);
+    return { { Quantize(x1), Quantize(y1), Quantize(z1), Quantize(x2), Quantize(y2), Quantize(z2), params }, phasemask };
+}
+
+MapCollisionCache::Key MapCollisionCache::MakeHeightKey(float x, float y, float z, float maxSearchDist) const
+{
+    return { { Quantize(x), Quantize(y), Quantize(z), Quantize(maxSearchDist), 0, 0, COLLISION_QUERY_HEIGHT }, 0 };
+}
+
+std::size_t MapCollisionCache::KeyHash::operator()(Key const& key) const
+{
+    // FNV-1a over the quantized values
+    uint64 hash = 14695981039346656037ULL;
+    for (int32 value : key.Values)
+        hash = (hash ^ uint32(value)) * 1099511628211ULL;
+
+    hash = (hash ^ key.Phasemask) * 1099511628211ULL;
+    return std::size_t(hash ^ (hash >> 32));
+}
+
+MapCollisionCache::EntryMap* MapCollisionCache::GetEntries(Shard& shard, uint32 staticGeneration, Optional<uint32> dynamicGeneration)
+{
+    if (shard.StaticGeneration != staticGeneration)
+    {
+        shard.StaticEntries.clear();
+        shard.DynamicEntries.clear();
+        shard.StaticGeneration = staticGeneration;
+        return nullptr;
+    }
+
+    if (!dynamicGeneration)
+        return &shard.StaticEntries;
+
+    if (shard.DynamicGeneration != *dynamicGeneration)
+    {
+        shard.DynamicEntries.clear();
+        shard.DynamicGeneration = *dynamicGeneration;
+        return nullptr;
+    }
+
+    return &shard.DynamicEntries;
+}
+
+Optional<float> MapCollisionCache::Find(Key const& key, uint32 staticGeneration, Optional<uint32> dynamicGeneration)
+{
+    Shard& shard = GetShard(key);
+    {
+        std::lock_guard<std::mutex> guard(shard.Lock);
+        if (EntryMap* entries = GetEntries(shard, staticGeneration, dynamicGeneration))
+        {
+            auto itr = entries->find(key);
+            if (itr != entries->end())
+            {
+                _hitsMetric.Add();
+                _savedTraversalsMetric.Add(itr->second.Traversals);
+                return itr->second.Result;
+            }
+        }
+    }
+
+    _missesMetric.Add();
+    return {};
+}
+
+void MapCollisionCache::Store(Key const& key, uint32 staticGeneration, Optional<uint32> dynamicGeneration, float result, uint8 traversals)
+{
+    Shard& shard = GetShard(key);
+    std::lock_guard<std::mutex> guard(shard.Lock);
+
+    // Models changed while the result was computed
+    if (shard.StaticGeneration != staticGeneration || (dynamicGeneration && shard.DynamicGeneration != *dynamicGeneration))
+        return;
+
+    EntryMap& entries = dynamicGeneration ? shard.DynamicEntries : shard.StaticEntries;
+    if (entries.size() >= MAX_SHARD_ENTRIES)
+        entries.clear();
+
+    entries.emplace(key, Entry{ result, traversals });
+}
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAP_COLLISION_CACHE_H_
+#define MAP_COLLISION_CACHE_H_
+
+#include "Metric.h"
+#include "Optional.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+// Opt-in (vmap.QueryCache) cache of the line of sight and vmap height results of one map.
+// Query points are quantized to vmap.QueryCache.GridSize, so units standing a few centimeters apart share a result.
+// Results of the static vmap models are kept until a vmap tile of the map is loaded or unloaded, results depending on
+// gameobject models are also dropped as soon as the dynamic tree generation changes (door opened, destructible rebuilt,
+// transport moved). The config is read once, when the map is created.
+class WH_GAME_API MapCollisionCache
+{
+public:
+    struct Key
+    {
+        std::array<int32, 7> Values;
+        uint32 Phasemask;
+
+        bool operator==(Key const& right) const = default;
+    };
+
+    explicit MapCollisionCache(uint32 mapId);
+
+    [[nodiscard]] bool IsEnabled() const { return _enabled; }
+
+    // A vmap tile of the map was loaded or unloaded, every cached result may be wrong now
+    void InvalidateStatic() { ++_staticGeneration; }
+    [[nodiscard]] uint32 GetStaticGeneration() const { return _staticGeneration; }
+
+    [[nodiscard]] Key MakeLineOfSightKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, uint32 checks, uint32 ignoreFlags) const;
+    [[nodiscard]] Key MakeHeightKey(float x, float y, float z, float maxSearchDist) const;
+
+    // Generations are read before the result is computed, dynamicGeneration is the dynamic tree generation
+    // and is only set for results depending on gameobject models
+    [[nodiscard]] Optional<float> Find(Key const& key, uint32 staticGeneration, Optional<uint32> dynamicGeneration);
+    void Store(Key const& key, uint32 staticGeneration, Optional<uint32> dynamicGeneration, float result, uint8 traversals);
+
+private:
+    struct KeyHash
+    {
+        std::size_t operator()(Key const& key) const;
+    };
+
+    struct Entry
+    {
+        float Result;
+        uint8 Traversals; // BIH walks a cache hit saves
+    };
+
+    typedef std::unordered_map<Key, Entry, KeyHash> EntryMap;
+
+    struct Shard
+    {
+        std::mutex Lock;
+        EntryMap StaticEntries;
+        EntryMap DynamicEntries;
+        uint32 StaticGeneration{};
+        uint32 DynamicGeneration{};
+    };
+
+    static constexpr std::size_t SHARD_COUNT = 16;
+    static constexpr std::size_t MAX_SHARD_ENTRIES = 1024; // per entry map, entries live across map updates
+
+    [[nodiscard]] int32 Quantize(float value) const;
+    [[nodiscard]] Shard& GetShard(Key const& key) { return _shards[KeyHash()(key) % SHARD_COUNT]; }
+
+    // Entries of the shard matching the generations, shard lock held
+    [[nodiscard]] static EntryMap* GetEntries(Shard& shard, uint32 staticGeneration, Optional<uint32> dynamicGeneration);
+
+    std::array<Shard, SHARD_COUNT> _shards;
+    std::atomic<uint32> _staticGeneration{};
+    bool _enabled{};
+    float _cellsPerYard{};
+
+    MetricCounter _hitsMetric;
+    MetricCounter _missesMetric;
+    MetricCounter _savedTraversalsMetric;
+};
+
+#endif
@@ -0,0 +1,328 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "MapRegionUpdater.h"
+#include "CellImpl.h"
+#include "GridNotifiers.h"
+#include "HostileRefMgr.h"
+#include "Map.h"
+#include "MapMgr.h"
+#include "Metric.h"
+#include "Player.h"
+#include "ThreatMgr.h"
+#include <algorithm>
+
+namespace
+{
+    thread_local MapUpdateRegion* CurrentRegion{ nullptr };
+}
+
+void MapUpdateRegion::Clear()
+{
+    Cells.clear();
+    CreaturesToMove.clear();
+    GameObjectsToMove.clear();
+    DynamicObjectsToMove.clear();
+    UpdateObjects.clear();
+    ObjectsToSwitch.clear();
+    ObjectsToRemove.clear();
+    ObjectsForDelayedVisibility.clear();
+}
+
+MapRegionUpdater::MapRegionUpdater(Map& map, float regionGap) :
+    _map(map), _regionsMetric("map_update_regions", { METRIC_TAG("map_id", std::to_string(map.GetId())) })
+{
+    _batch.Task = [this](std::size_t index)
+    {
+        MapUpdateRegion& region = _regions[_regionOrder[index]];
+
+        CurrentRegion = &region;
+        UpdateRegion(region, _diff);
+        CurrentRegion = nullptr;
+    };
+
+    // Activators are expanded by half of the gap on every side, so two regions never come closer than the gap
+    _gapCells = uint32(std::ceil(std::max(regionGap, 0.0f) / 2.0f / SIZE_OF_GRID_CELL));
+}
+
+MapUpdateRegion* MapRegionUpdater::GetCurrentRegion(Map const* map)
+{
+    return CurrentRegion && CurrentRegion->Owner == map ? CurrentRegion : nullptr;
+}
+
+void MapRegionUpdater::Update(uint32 diff, uint32 s_diff)
+{
+    _map.resetMarkedCells();
+    _map.resetMarkedCellsLarge();
+
+    _activators.clear();
+    _gridOwners.fill(-1);
+
+    for (WorldObject* obj : _map._activeNonPlayers)
+        if (obj && obj->IsInWorld())
+            AddActivator(obj, obj->GetGridActivationRange(), false);
+
+    // the player iterator is stored in the map object
+    // to make sure calls to Map::Remove don't invalidate it
+    for (_map.m_mapRefIter = _map.m_mapRefMgr.begin(); _map.m_mapRefIter != _map.m_mapRefMgr.end(); ++_map.m_mapRefIter)
+    {
+        Player* player = _map.m_mapRefIter->GetSource();
+
+        if (!player || !player->IsInWorld())
+            continue;
+
+        // players are updated serially, they can reach anything on the map
+        player->Update(s_diff);
+
+        std::size_t const playerActivator = AddActivator(player, player->GetGridActivationRange(), false);
+        AddActivator(player, MAX_VISIBILITY_DISTANCE, true);
+
+        // If player is using far sight, visit that object too
+        if (WorldObject* viewPoint = player->GetViewpoint())
+            if (viewPoint->ToCreature() || viewPoint->ToDynObject())
+                AddActivator(viewPoint, viewPoint->GetGridActivationRange(), false);
+
+        // handle updates for creatures in combat with player and are more than X yards away
+        // they change the state of the player, so they are updated in the region of the player
+        if (player->IsInCombat() && playerActivator != NO_ACTIVATOR)
+        {
+            float rangeSq = player->GetGridActivationRange() - 1.0f;
+            rangeSq = rangeSq * rangeSq;
+
+            for (HostileReference* ref = player->getHostileRefMgr().getFirst(); ref; ref = ref->next())
+                if (Unit* unit = ref->GetSource()->GetOwner())
+                    if (Creature* cre = unit->ToCreature())
+                        if (cre->FindMap() == player->FindMap() && cre->GetExactDist2dSq(player) > rangeSq)
+                            if (std::size_t const creatureActivator = AddActivator(cre, cre->GetGridActivationRange(), false); creatureActivator != NO_ACTIVATOR)
+                                JoinActivators(playerActivator, creatureActivator);
+        }
+    }
+
+    BuildRegions();
+
+    _regionsMetric.Set(int64(_regionCount));
+
+    MapUpdater* mapUpdater = sMapMgr->GetMapUpdater();
+
+    if (_regionCount < 2 || !mapUpdater->IsActive())
+    {
+        for (std::size_t i = 0; i < _regionCount; ++i)
+            UpdateRegion(_regions[i], diff);
+
+        return;
+    }
+
+    _diff = diff;
+    _batch.Count = _regionCount;
+
+    mapUpdater->RunTaskBatch(_batch, _map.GetLastUpdateCost());
+
+    for (std::size_t i = 0; i < _regionCount; ++i)
+        Merge(_regions[i]);
+}
+
+std::size_t MapRegionUpdater::AddActivator(WorldObject* obj, float range, bool largeOnly)
+{
+    // Check for valid position
+    if (!obj->IsPositionValid())
+        return NO_ACTIVATOR;
+
+    // pussywizard: gameobjects for example are on active lists, but range is equal to 0 (they just prevent grid unloading)
+    if (range <= 0.0f)
+        return NO_ACTIVATOR;
+
+    std::size_t const index = _activators.size();
+    CellArea const area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), range);
+    _activators.push_back({ area, largeOnly, index, 0 });
+
+    uint32 const lowX = (area.low_bound.x_coord > _gapCells ? area.low_bound.x_coord - _gapCells : 0) / MAX_NUMBER_OF_CELLS;
+    uint32 const lowY = (area.low_bound.y_coord > _gapCells ? area.low_bound.y_coord - _gapCells : 0) / MAX_NUMBER_OF_CELLS;
+    uint32 const highX = std::min<uint32>(area.high_bound.x_coord + _gapCells, TOTAL_NUMBER_OF_CELLS_PER_MAP - 1) / MAX_NUMBER_OF_CELLS;
+    uint32 const highY = std::min<uint32>(area.high_bound.y_coord + _gapCells, TOTAL_NUMBER_OF_CELLS_PER_MAP - 1) / MAX_NUMBER_OF_CELLS;
+
+    // Activators sharing a grid of their expanded areas end up in the same region
+    for (uint32 x = lowX; x <= highX; ++x)
+    {
+        for (uint32 y = lowY; y <= highY; ++y)
+        {
+            int32& owner = _gridOwners[x * MAX_NUMBER_OF_GRIDS + y];
+
+            if (owner < 0)
+            {
+                owner = int32(index);
+                continue;
+            }
+
+            JoinActivators(owner, index);
+        }
+    }
+
+    return index;
+}
+
+std::size_t MapRegionUpdater::FindRoot(std::size_t index)
+{
+    while (_activators[index].Parent != index)
+    {
+        _activators[index].Parent = _activators[_activators[index].Parent].Parent;
+        index = _activators[index].Parent;
+    }
+
+    return index;
+}
+
+void MapRegionUpdater::JoinActivators(std::size_t left, std::size_t right)
+{
+    std::size_t const leftRoot = FindRoot(left);
+    std::size_t const rightRoot = FindRoot(right);
+
+    // the root keeps the lowest index of its set
+    if (leftRoot != rightRoot)
+        _activators[std::max(leftRoot, rightRoot)].Parent = std::min(leftRoot, rightRoot);
+}
+
+void MapRegionUpdater::BuildRegions()
+{
+    _regionCount = 0;
+
+    // Roots always have the lowest index of their set, so regions are numbered in activator order
+    for (std::size_t i = 0; i < _activators.size(); ++i)
+    {
+        Activator& activator = _activators[i];
+        std::size_t const root = FindRoot(i);
+
+        if (root == i)
+        {
+            if (_regions.size() <= _regionCount)
+                _regions.emplace_back();
+
+            _regions[_regionCount].Clear();
+            _regions[_regionCount].Owner = &_map;
+            activator.Region = _regionCount++;
+        }
+        else
+            activator.Region = _activators[root].Region;
+
+        MapUpdateRegion& region = _regions[activator.Region];
+
+        // same marking as Map::VisitNearbyCellsOf / Map::VisitNearbyCellsOfPlayer, so every cell is visited once
+        for (uint32 x = activator.Area.low_bound.x_coord; x <= activator.Area.high_bound.x_coord; ++x)
+        {
+            for (uint32 y = activator.Area.low_bound.y_coord; y <= activator.Area.high_bound.y_coord; ++y)
+            {
+                uint32 const cellId = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+                uint8 visit = 0;
+
+                if (activator.LargeOnly)
+                {
+                    if (_map.isCellMarkedLarge(cellId))
+                        continue;
+
+                    _map.markCellLarge(cellId);
+                    visit = MAP_REGION_CELL_VISIT_LARGE;
+                }
+                else
+                {
+                    if (_map.isCellMarked(cellId))
+                        continue;
+
+                    _map.markCell(cellId);
+                    visit = MAP_REGION_CELL_VISIT_NORMAL;
+
+                    if (!_map.isCellMarkedLarge(cellId))
+                    {
+                        _map.markCellLarge(cellId);
+                        visit |= MAP_REGION_CELL_VISIT_LARGE;
+                    }
+                }
+
+                // grid loading adds objects to shared map containers, do it before going parallel
+                _map.EnsureGridLoaded(Cell(CellCoord(x, y)));
+                region.Cells.emplace_back(cellId, visit);
+            }
+        }
+    }
+
+    // biggest regions first, they decide how long the parallel part takes
+    _regionOrder.resize(_regionCount);
+    for (std::size_t i = 0; i < _regionCount; ++i)
+        _regionOrder[i] = i;
+
+    std::sort(_regionOrder.begin(), _regionOrder.end(), [this](std::size_t left, std::size_t right)
+    {
+        return _regions[left].Cells.size() > _regions[right].Cells.size();
+    });
+}
+
+void MapRegionUpdater::UpdateRegion(MapUpdateRegion& region, uint32 diff)
+{
+    Warhead::ObjectUpdater updater(diff, false);
+
+    // for creature
+    TypeContainerVisitor<Warhead::ObjectUpdater, GridTypeMapContainer> grid_object_update(updater);
+
+    // for pets
+    TypeContainerVisitor<Warhead::ObjectUpdater, WorldTypeMapContainer> world_object_update(updater);
+
+    // for large creatures
+    Warhead::ObjectUpdater largeObjectUpdater(diff, true);
+    TypeContainerVisitor<Warhead::ObjectUpdater, GridTypeMapContainer> grid_large_object_update(largeObjectUpdater);
+    TypeContainerVisitor<Warhead::ObjectUpdater, WorldTypeMapContainer> world_large_object_update(largeObjectUpdater);
+
+    for (auto const& [cellId, visit] : region.Cells)
+    {
+        Cell cell(CellCoord(cellId % TOTAL_NUMBER_OF_CELLS_PER_MAP, cellId / TOTAL_NUMBER_OF_CELLS_PER_MAP));
+
+        if (visit & MAP_REGION_CELL_VISIT_NORMAL)
+        {
+            _map.Visit(cell, grid_object_update);
+            _map.Visit(cell, world_object_update);
+        }
+
+        if (visit & MAP_REGION_CELL_VISIT_LARGE)
+        {
+            _map.Visit(cell, grid_large_object_update);
+            _map.Visit(cell, world_large_object_update);
+        }
+    }
+}
+
+void MapRegionUpdater::Merge(MapUpdateRegion& region)
+{
+    _map._creaturesToMove.insert(_map._creaturesToMove.end(), region.CreaturesToMove.begin(), region.CreaturesToMove.end());
+    _map._gameObjectsToMove.insert(_map._gameObjectsToMove.end(), region.GameObjectsToMove.begin(), region.GameObjectsToMove.end());
+    _map._dynamicObjectsToMove.insert(_map._dynamicObjectsToMove.end(), region.DynamicObjectsToMove.begin(), region.DynamicObjectsToMove.end());
+
+    for (auto const& [obj, add] : region.UpdateObjects)
+    {
+        if (add)
+            _map._updateObjects.insert(obj);
+        else
+            _map._updateObjects.erase(obj);
+    }
+
+    for (auto const& [obj, on] : region.ObjectsToSwitch)
+        _map.AddObjectToSwitchList(obj, on);
+
+    _map.i_objectsToRemove.insert(region.ObjectsToRemove.begin(), region.ObjectsToRemove.end());
+    _map.i_objectsForDelayedVisibility.insert(region.ObjectsForDelayedVisibility.begin(), region.ObjectsForDelayedVisibility.end());
+
+    region.Clear();
+}
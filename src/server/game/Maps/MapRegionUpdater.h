@@ -0,0 +1,109 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAP_REGION_UPDATER_H_
+#define MAP_REGION_UPDATER_H_
+
+#include "Cell.h"
+#include "MapUpdater.h"
+#include "Metric.h"
+#include <array>
+#include <limits>
+#include <vector>
+
+class Creature;
+class DynamicObject;
+class GameObject;
+class Map;
+class Object;
+class Unit;
+class WorldObject;
+
+enum MapRegionCellVisit : uint8
+{
+    MAP_REGION_CELL_VISIT_NORMAL = 0x1,
+    MAP_REGION_CELL_VISIT_LARGE  = 0x2
+};
+
+// Cells of one region and the map changes its objects made, merged back by MapRegionUpdater after the parallel part
+struct MapUpdateRegion
+{
+    Map* Owner{ nullptr };
+    std::vector<std::pair<uint32 /*cellId*/, uint8 /*MapRegionCellVisit*/>> Cells;
+
+    std::vector<Creature*> CreaturesToMove;
+    std::vector<GameObject*> GameObjectsToMove;
+    std::vector<DynamicObject*> DynamicObjectsToMove;
+    std::vector<std::pair<Object*, bool /*add*/>> UpdateObjects;
+    std::vector<std::pair<WorldObject*, bool /*on*/>> ObjectsToSwitch;
+    std::vector<WorldObject*> ObjectsToRemove;
+    std::vector<Unit*> ObjectsForDelayedVisibility;
+
+    void Clear();
+};
+
+// Opt-in parallel object update of a continent (MapUpdate.Parallel.Maps).
+// Players are updated serially first, then the cells around them and around active objects are grouped
+// into regions at least MapUpdate.Parallel.RegionGap apart, creatures in combat with a player always join the region
+// of that player. The creatures, gameobjects and dynamic objects of every region are updated on the MapUpdater workers. Cell moves, removals, switches, visibility and
+// update fields are queued per region and merged serially; other shared map data is guarded by Map::LockForRegionUpdate.
+class WH_GAME_API MapRegionUpdater
+{
+public:
+    MapRegionUpdater(Map& map, float regionGap);
+
+    void Update(uint32 diff, uint32 s_diff);
+
+    [[nodiscard]] std::size_t GetLastRegionCount() const { return _regionCount; }
+
+    // Region updated by the current thread, if it belongs to this map
+    static MapUpdateRegion* GetCurrentRegion(Map const* map);
+
+private:
+    struct Activator
+    {
+        CellArea Area;
+        bool LargeOnly;
+        std::size_t Parent;
+        std::size_t Region;
+    };
+
+    // Returns the index of the new activator, NO_ACTIVATOR if the object activates nothing
+    std::size_t AddActivator(WorldObject* obj, float range, bool largeOnly);
+    std::size_t FindRoot(std::size_t index);
+    void JoinActivators(std::size_t left, std::size_t right);
+    void BuildRegions();
+    void UpdateRegion(MapUpdateRegion& region, uint32 diff);
+    void Merge(MapUpdateRegion& region);
+
+    static constexpr std::size_t NO_ACTIVATOR = std::numeric_limits<std::size_t>::max();
+
+    Map& _map;
+    uint32 _gapCells;
+
+    std::vector<Activator> _activators;
+    std::array<int32, MAX_NUMBER_OF_GRIDS * MAX_NUMBER_OF_GRIDS> _gridOwners;
+    std::vector<MapUpdateRegion> _regions;
+    std::vector<std::size_t> _regionOrder;
+    std::size_t _regionCount{};
+    uint32 _diff{};
+
+    MapUpdaterTaskBatch _batch;
+    MetricGauge _regionsMetric;
+};
+
+#endif
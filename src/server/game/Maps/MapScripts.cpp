@@ -39,6 +39,8 @@ void Map::ScriptsStart(ScriptMapMap const& scripts, uint32 id, Object* source, O
     if (s == scripts.end())
         return;
 
+    auto guard = LockForRegionUpdate();
+
     // prepare static data
     ObjectGuid sourceGUID = source ? source->GetGUID() : ObjectGuid::Empty; //some script commands doesn't have source
     ObjectGuid targetGUID = target ? target->GetGUID() : ObjectGuid::Empty;
@@ -62,7 +64,8 @@ void Map::ScriptsStart(ScriptMapMap const& scripts, uint32 id, Object* source, O
         sMapMgr->IncreaseScheduledScriptsCount();
     }
     ///- If one of the effects should be immediate, launch the script execution
-    if (/*start &&*/ immedScript && !_scriptLock)
+    ///- Scripts can reach the whole map, while regions are updated they wait for Map::Update
+    if (/*start &&*/ immedScript && !_scriptLock && !GetUpdateRegion())
     {
         _scriptLock = true;
         ScriptsProcess();
@@ -74,6 +77,8 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
 {
     // NOTE: script record _must_ exist until command executed
 
+    auto guard = LockForRegionUpdate();
+
     // prepare static data
     ObjectGuid sourceGUID = source ? source->GetGUID() : ObjectGuid::Empty;
     ObjectGuid targetGUID = target ? target->GetGUID() : ObjectGuid::Empty;
@@ -90,7 +95,7 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
     sMapMgr->IncreaseScheduledScriptsCount();
 
     ///- If effects should be immediate, launch the script execution
-    if (delay == 0 && !_scriptLock)
+    if (delay == 0 && !_scriptLock && !GetUpdateRegion())
     {
         _scriptLock = true;
         ScriptsProcess();
@@ -270,6 +275,7 @@ inline void Map::_ScriptProcessDoor(Object* source, Object* target, const Script
 
 inline GameObject* Map::_FindGameObject(WorldObject* searchObject, ObjectGuid::LowType guid) const
 {
+    auto guard = searchObject->GetMap()->LockForRegionUpdate();
     auto bounds = searchObject->GetMap()->GetGameObjectBySpawnIdStore().equal_range(guid);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -23,66 +23,43 @@
 #include "LFGMgr.h"
 #include "Map.h"
 #include "Metric.h"
+#include <algorithm>
+#include <limits>
 
-class UpdateRequest
+namespace
 {
-public:
-    UpdateRequest() = default;
-    virtual ~UpdateRequest() = default;
+    // Lets requests scheduled from inside a worker (MapInstanced -> instances) go to that worker's own queue
+    thread_local MapUpdater* CurrentUpdater{ nullptr };
+    thread_local std::size_t CurrentWorkerIndex{};
 
-    virtual void UpdateMap() = 0;
-};
-
-class MapUpdateRequest : public UpdateRequest
-{
-public:
-    MapUpdateRequest(Map& m, MapUpdater& u, uint32 d, uint32 sd) :
-        _map(m), _updater(u), _mapDiff(d), _sDiff(sd) { }
-
-    void UpdateMap() override
-    {
-        METRIC_TIMER("map_update_time_diff", METRIC_TAG("map_id", std::to_string(_map.GetId())));
-        _map.Update(_mapDiff, _sDiff);
-        _updater.FinishUpdate();
-    }
-
-private:
-    Map& _map;
-    MapUpdater& _updater;
-    uint32 _mapDiff;
-    uint32 _sDiff;
-};
+    constexpr std::size_t WORKER_QUEUE_RESERVE = 64;
+}
 
-class LFGUpdateRequest : public UpdateRequest
+void MapUpdater::InitThreads(std::size_t num_threads)
 {
-public:
-    LFGUpdateRequest(MapUpdater& u, uint32 d) : _updater(u), _diff(d) {}
+    _workerQueues.reserve(num_threads);
+    _workerThreads.reserve(num_threads);
 
-    void UpdateMap() override
+    for (std::size_t i = 0; i < num_threads; ++i)
     {
-        sLFGMgr->Update(_diff, 1);
-        _updater.FinishUpdate();
+        _workerQueues.emplace_back(std::make_unique<WorkerQueue>());
+        _workerQueues.back()->Requests.reserve(WORKER_QUEUE_RESERVE);
     }
 
-private:
-    MapUpdater& _updater;
-    uint32 _diff;
-};
-
-void MapUpdater::InitThreads(std::size_t num_threads)
-{
-    _workerThreads.reserve(num_threads);
-
     for (std::size_t i = 0; i < num_threads; ++i)
-        _workerThreads.emplace_back(&MapUpdater::InitializeThread, this);
+        _workerThreads.emplace_back(&MapUpdater::WorkerThread, this, i);
 }
 
 void MapUpdater::Stop()
 {
-    _cancelationToken = true;
-
     WaitThreads();
-    _queue.Cancel();
+
+    {
+        std::lock_guard<std::mutex> guard(_queueLock);
+        _cancelationToken = true;
+    }
+
+    _queueCondition.notify_all();
 
     for (auto& thread : _workerThreads)
         if (thread.joinable())
@@ -96,21 +73,21 @@ void MapUpdater::WaitThreads()
     while (pending_requests)
         _condition.wait(guard);
 
-    guard.unlock();
+    if (_tickStarted)
+    {
+        _tickStarted = false;
+        CollectTickStats();
+    }
 }
 
 void MapUpdater::ScheduleUpdate(Map& map, uint32 diff, uint32 s_diff)
 {
-    std::lock_guard<std::mutex> guard(_lock);
-    ++pending_requests;
-    _queue.Push(new MapUpdateRequest(map, *this, diff, s_diff));
+    Schedule({ &map, nullptr, diff, s_diff, map.GetLastUpdateCost() });
 }
 
 void MapUpdater::ScheduleLfgUpdate(uint32 diff)
 {
-    std::lock_guard<std::mutex> guard(_lock);
-    ++pending_requests;
-    _queue.Push(new LFGUpdateRequest(*this, diff));
+    Schedule({ nullptr, nullptr, diff, 0, _lfgUpdateCost });
 }
 
 bool MapUpdater::IsActive()
@@ -118,6 +95,159 @@ bool MapUpdater::IsActive()
     return !_workerThreads.empty();
 }
 
+void MapUpdater::RunTaskBatch(MapUpdaterTaskBatch& batch, Microseconds cost)
+{
+    batch.Next = 0;
+    batch.Done = 0;
+
+    if (!batch.Count)
+        return;
+
+    // Helpers are sorted like a map as expensive as the caller, so they start before cheap instances
+    std::size_t const helpers = std::min(batch.Count, _workerQueues.size()) - 1;
+    for (std::size_t i = 0; i < helpers; ++i)
+        Schedule({ nullptr, &batch, 0, 0, cost });
+
+    ProcessTaskBatch(batch);
+
+    for (std::size_t done = batch.Done; done < batch.Count; done = batch.Done)
+        batch.Done.wait(done);
+}
+
+void MapUpdater::Schedule(UpdateRequest const& request)
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        ++pending_requests;
+
+        if (!_tickStarted)
+        {
+            _tickStarted = true;
+            _tickStart = std::chrono::steady_clock::now();
+        }
+    }
+
+    std::size_t workerIndex = 0;
+
+    if (CurrentUpdater == this)
+        workerIndex = CurrentWorkerIndex;
+    else
+    {
+        // Longest expected update goes to the least loaded worker, ties are rotated
+        std::size_t const workerCount = _workerQueues.size();
+        int64 minLoad = std::numeric_limits<int64>::max();
+
+        for (std::size_t i = 0; i < workerCount; ++i)
+        {
+            std::size_t const index = (_nextWorker + i) % workerCount;
+            int64 const load = _workerQueues[index]->Load;
+
+            if (load < minLoad)
+            {
+                minLoad = load;
+                workerIndex = index;
+            }
+        }
+
+        _nextWorker = workerIndex + 1;
+    }
+
+    WorkerQueue& worker = *_workerQueues[workerIndex];
+    worker.Load += std::max<int64>(request.Cost.count(), 1);
+
+    {
+        std::lock_guard<std::mutex> guard(worker.Lock);
+
+        if (worker.Head == worker.Requests.size())
+        {
+            worker.Requests.clear();
+            worker.Head = 0;
+        }
+
+        auto itr = std::upper_bound(worker.Requests.begin() + worker.Head, worker.Requests.end(), request, [](UpdateRequest const& left, UpdateRequest const& right)
+        {
+            return left.Cost > right.Cost;
+        });
+
+        worker.Requests.insert(itr, request);
+    }
+
+    // Counted only once it can be popped
+    {
+        std::lock_guard<std::mutex> guard(_queueLock);
+        ++_queuedRequests;
+    }
+
+    _queueCondition.notify_one();
+}
+
+bool MapUpdater::PopRequest(std::size_t workerIndex, UpdateRequest& request)
+{
+    std::size_t const workerCount = _workerQueues.size();
+
+    // Own queue first, then steal from the others
+    for (std::size_t i = 0; i < workerCount; ++i)
+    {
+        WorkerQueue& queue = *_workerQueues[(workerIndex + i) % workerCount];
+
+        {
+            std::lock_guard<std::mutex> guard(queue.Lock);
+
+            if (queue.Head == queue.Requests.size())
+                continue;
+
+            request = queue.Requests[queue.Head++];
+
+            if (queue.Head == queue.Requests.size())
+            {
+                queue.Requests.clear();
+                queue.Head = 0;
+            }
+        }
+
+        queue.Load -= std::max<int64>(request.Cost.count(), 1);
+
+        if (i)
+            ++_workerQueues[workerIndex]->Steals;
+
+        return true;
+    }
+
+    return false;
+}
+
+void MapUpdater::ProcessRequest(WorkerQueue& worker, UpdateRequest const& request)
+{
+    int64 const expectedCost = std::max<int64>(request.Cost.count(), 1);
+    worker.Load += expectedCost;
+
+    TimePoint const start = std::chrono::steady_clock::now();
+
+    if (request.Batch)
+        ProcessTaskBatch(*request.Batch);
+    else if (Map* map = request.MapToUpdate)
+        map->Update(request.Diff, request.SDiff);
+    else
+        sLFGMgr->Update(request.Diff, 1);
+
+    auto const cost = std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - start);
+
+    if (request.MapToUpdate)
+    {
+        request.MapToUpdate->SetLastUpdateCost(cost);
+        request.MapToUpdate->GetUpdateTimeMetric().Record(cost);
+    }
+    else if (!request.Batch)
+        _lfgUpdateCost = cost;
+
+    worker.Load -= expectedCost;
+    worker.Busy += cost;
+    worker.Longest = std::max(worker.Longest, cost);
+    ++worker.Processed;
+
+    FinishUpdate();
+}
+
 void MapUpdater::FinishUpdate()
 {
     std::lock_guard<std::mutex> lock(_lock);
@@ -125,21 +255,74 @@ void MapUpdater::FinishUpdate()
     _condition.notify_all();
 }
 
-void MapUpdater::InitializeThread()
+void MapUpdater::ProcessTaskBatch(MapUpdaterTaskBatch& batch)
+{
+    for (std::size_t index = batch.Next++; index < batch.Count; index = batch.Next++)
+    {
+        batch.Task(index);
+
+        if (++batch.Done == batch.Count)
+            batch.Done.notify_all();
+    }
+}
+
+void MapUpdater::CollectTickStats()
+{
+    MapUpdaterTickStats stats;
+    stats.Elapsed = std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - _tickStart);
+
+    for (auto& worker : _workerQueues)
+    {
+        stats.Busy += worker->Busy;
+        stats.CriticalPath = std::max(stats.CriticalPath, worker->Longest);
+        stats.Requests += worker->Processed;
+        stats.Steals += worker->Steals;
+
+        worker->Busy = 0us;
+        worker->Longest = 0us;
+        worker->Processed = 0;
+        worker->Steals = 0;
+    }
+
+    Microseconds const capacity = stats.Elapsed * static_cast<int64>(_workerQueues.size());
+    stats.Idle = capacity > stats.Busy ? capacity - stats.Busy : 0us;
+
+    _lastTickStats = stats;
+
+    METRIC_VALUE("map_updater_time", uint64(stats.Elapsed.count()), METRIC_TAG("type", "Elapsed"));
+    METRIC_VALUE("map_updater_time", uint64(stats.CriticalPath.count()), METRIC_TAG("type", "Critical path"));
+    METRIC_VALUE("map_updater_time", uint64(stats.Idle.count()), METRIC_TAG("type", "Idle"));
+    METRIC_VALUE("map_updater_steals", stats.Steals);
+}
+
+void MapUpdater::WorkerThread(std::size_t workerIndex)
 {
     AuthDatabase.WarnAboutSyncQueries(true);
     CharacterDatabase.WarnAboutSyncQueries(true);
     WorldDatabase.WarnAboutSyncQueries(true);
 
+    CurrentUpdater = this;
+    CurrentWorkerIndex = workerIndex;
+
+    WorkerQueue& worker = *_workerQueues[workerIndex];
+
     for (;;)
     {
-        UpdateRequest* request = nullptr;
+        {
+            std::unique_lock<std::mutex> guard(_queueLock);
+            _queueCondition.wait(guard, [this] { return _queuedRequests || _cancelationToken; });
+
+            if (_cancelationToken)
+                return;
+
+            --_queuedRequests;
+        }
 
-        _queue.WaitAndPop(request);
-        if (_cancelationToken)
-            return;
+        // The request taken off the count is in one of the queues. A scan can still miss it when other workers pop
+        // behind it, but each of them took its own count, so the next scan finds one.
+        UpdateRequest request;
+        while (!PopRequest(workerIndex, request)) { }
 
-        request->UpdateMap();
-        delete request;
+        ProcessRequest(worker, request);
     }
 }
@@ -19,11 +19,36 @@
 #define MAP_UPDATER_H_
 
 #include "Define.h"
-#include "PCQueue.h"
+#include "Duration.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 class Map;
-class UpdateRequest;
+
+// Timings of the last completed batch of map updates (one WaitThreads() cycle)
+struct MapUpdaterTickStats
+{
+    Microseconds Elapsed{};      // from the first scheduled request to the last finished one
+    Microseconds CriticalPath{}; // longest single request, no thread count can make the tick shorter
+    Microseconds Busy{};         // time all workers spent inside requests
+    Microseconds Idle{};         // threads * elapsed - busy
+    uint32 Requests{};
+    uint32 Steals{};
+};
+
+// Tasks of one map spread over the other workers, see MapUpdater::RunTaskBatch
+struct MapUpdaterTaskBatch
+{
+    std::function<void(std::size_t)> Task;
+    std::size_t Count{};
+    std::atomic<std::size_t> Next{};
+    std::atomic<std::size_t> Done{};
+};
 
 class WH_GAME_API MapUpdater
 {
@@ -37,19 +62,67 @@ public:
     void InitThreads(std::size_t num_threads);
     void Stop();
     bool IsActive();
-    void FinishUpdate();
+
+    // Runs batch.Task for every index below batch.Count on the calling worker and on the idle ones, returns when all are done.
+    // The batch must outlive the current tick, helpers that start after the batch is finished find nothing left to do.
+    void RunTaskBatch(MapUpdaterTaskBatch& batch, Microseconds cost);
+
+    [[nodiscard]] MapUpdaterTickStats const& GetLastTickStats() const { return _lastTickStats; }
 
 private:
-    void InitializeThread();
+    // Stored by value in the worker queues, no map and no batch is the lfg update
+    struct UpdateRequest
+    {
+        Map* MapToUpdate{ nullptr };
+        MapUpdaterTaskBatch* Batch{ nullptr };
+        uint32 Diff{};
+        uint32 SDiff{};
+        Microseconds Cost{};
+    };
 
-    ProducerConsumerQueue<UpdateRequest*> _queue;
+    // Per thread request queue sorted by expected cost, most expensive first.
+    // The owner and thieves both take from the front so heavy maps start as early as possible.
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex Lock;
+        std::vector<UpdateRequest> Requests;
+        std::size_t Head{};
+        std::atomic<int64> Load{}; // expected cost of queued + running requests, in microseconds
 
+        // Written by the owning thread only, read and reset in WaitThreads() once all requests are finished
+        Microseconds Busy{};
+        Microseconds Longest{};
+        uint32 Processed{};
+        uint32 Steals{};
+    };
+
+    void Schedule(UpdateRequest const& request);
+    bool PopRequest(std::size_t workerIndex, UpdateRequest& request);
+    void ProcessRequest(WorkerQueue& worker, UpdateRequest const& request);
+    void FinishUpdate();
+    static void ProcessTaskBatch(MapUpdaterTaskBatch& batch);
+    void CollectTickStats();
+    void WorkerThread(std::size_t workerIndex);
+
+    std::vector<std::unique_ptr<WorkerQueue>> _workerQueues;
     std::vector<std::thread> _workerThreads;
-    std::atomic<bool> _cancelationToken;
+    std::atomic<bool> _cancelationToken{};
+    std::size_t _nextWorker{};
+
+    // Sleeping workers wait here until something is queued. A request is counted once it is in a worker queue
+    // and a worker takes one off the count before popping, so every taken count has a request to pop.
+    std::mutex _queueLock;
+    std::condition_variable _queueCondition;
+    std::size_t _queuedRequests{};
 
     std::mutex _lock;
     std::condition_variable _condition;
     std::size_t pending_requests{};
+
+    bool _tickStarted{};
+    TimePoint _tickStart;
+    Microseconds _lfgUpdateCost{};
+    MapUpdaterTickStats _lastTickStats;
 };
 
 #endif
@@ -41,6 +41,7 @@ void FleeingMovementGenerator<T>::DoInitialize(T* owner)
     }
 
     _path = nullptr;
+    _pathRequest = nullptr;
     owner->SetUnitFlag(UNIT_FLAG_FLEEING);
     owner->AddUnitState(UNIT_STATE_FLEEING);
     SetTargetLocation(owner);
@@ -88,6 +89,7 @@ bool FleeingMovementGenerator<T>::DoUpdate(T* owner, uint32 diff)
     if (owner->HasUnitState(UNIT_STATE_NOT_MOVE) || owner->IsMovementPreventedByCasting())
     {
         _path = nullptr;
+        _pathRequest = nullptr;
         _interrupt = true;
         owner->StopMoving();
         return true;
@@ -115,11 +117,24 @@ void FleeingMovementGenerator<T>::SetTargetLocation(T* owner)
     if (owner->HasUnitState(UNIT_STATE_NOT_MOVE) || owner->IsMovementPreventedByCasting())
     {
         _path = nullptr;
+        _pathRequest = nullptr;
         _interrupt = true;
         owner->StopMoving();
         return;
     }
 
+    // path requested during the previous update of the map
+    if (_pathRequest)
+    {
+        if (!_pathRequest->Done)
+            return;
+
+        PathRequestPtr request = std::move(_pathRequest);
+        _path = std::move(request->Path);
+        MoveAlongPath(owner, request->Result);
+        return;
+    }
+
     owner->AddUnitState(UNIT_STATE_FLEEING_MOVE);
 
     Position destination = owner->GetPosition();
@@ -142,8 +157,20 @@ void FleeingMovementGenerator<T>::SetTargetLocation(T* owner)
     }
 
     _path->SetPathLengthLimit(30.0f);
-    bool result = _path->CalculatePath(destination.GetPositionX(), destination.GetPositionY(), destination.GetPositionZ());
-    if (!result || (_path->GetPathType() & PathType(PATHFIND_NOPATH | PATHFIND_SHORTCUT | PATHFIND_FARFROMPOLY)))
+
+    if (PathRequestQueue::IsEnabled())
+    {
+        _pathRequest = owner->GetMap()->GetPathRequests().Submit(std::move(_path), G3D::Vector3(destination.GetPositionX(), destination.GetPositionY(), destination.GetPositionZ()), false);
+        return;
+    }
+
+    MoveAlongPath(owner, _path->CalculatePath(destination.GetPositionX(), destination.GetPositionY(), destination.GetPositionZ()));
+}
+
+template<class T>
+void FleeingMovementGenerator<T>::MoveAlongPath(T* owner, bool calculated)
+{
+    if (!calculated || (_path->GetPathType() & PathType(PATHFIND_NOPATH | PATHFIND_SHORTCUT | PATHFIND_FARFROMPOLY)))
     {
         _timer.Reset(100);
         return;
@@ -19,6 +19,7 @@
 #define WARHEAD_FLEEINGMOVEMENTGENERATOR_H
 
 #include "MovementGenerator.h"
+#include "PathRequestQueue.h"
 
 template<class T>
 class FleeingMovementGenerator : public MovementGeneratorMedium< T, FleeingMovementGenerator<T> >
@@ -36,8 +37,10 @@ class FleeingMovementGenerator : public MovementGeneratorMedium< T, FleeingMovem
     private:
         void SetTargetLocation(T*);
         void GetPoint(T*, Position& position);
+        void MoveAlongPath(T*, bool calculated);
 
         std::unique_ptr<PathGenerator> _path;
+        PathRequestPtr _pathRequest; // Pathfinding.Async, _path is owned by the request meanwhile
         ObjectGuid _fleeTargetGUID;
         TimeTracker _timer;
         bool _interrupt;
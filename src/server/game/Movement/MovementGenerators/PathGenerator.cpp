@@ -37,12 +37,7 @@ PathGenerator::PathGenerator(WorldObject const* owner) :
 {
     memset(_pathPolyRefs, 0, sizeof(_pathPolyRefs));
 
-    uint32 mapId = _source->GetMapId();
-    {
-        MMAP::MMapMgr* mmap = MMAP::MMapFactory::createOrGetMMapMgr();
-        _navMesh = mmap->GetNavMesh(mapId);
-        _navMeshQuery = mmap->GetNavMeshQuery(mapId, _source->GetInstanceId());
-    }
+    _navMesh = MMAP::MMapFactory::createOrGetMMapMgr()->GetNavMesh(_source->GetMapId());
 
     CreateFilter();
 }
@@ -74,6 +69,10 @@ bool PathGenerator::CalculatePath(float x, float y, float z, float destX, float
 
     _forceDestination = forceDest;
 
+    // the query belongs to the calculating thread, generators are moved between map update threads
+    if (_navMesh)
+        _navMeshQuery = MMAP::MMapFactory::createOrGetMMapMgr()->GetNavMeshQuery(_source->GetMapId());
+
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
     Unit const* _sourceUnit = _source->ToUnit();
@@ -91,6 +90,18 @@ bool PathGenerator::CalculatePath(float x, float y, float z, float destX, float
     return true;
 }
 
+void PathGenerator::CopyPathFrom(PathGenerator const& other)
+{
+    memcpy(_pathPolyRefs, other._pathPolyRefs, sizeof(_pathPolyRefs));
+    _polyLength = other._polyLength;
+    _pathPoints = other._pathPoints;
+    _type = other._type;
+    _forceDestination = other._forceDestination;
+    _startPosition = other._startPosition;
+    _endPosition = other._endPosition;
+    _actualEndPosition = other._actualEndPosition;
+}
+
 dtPolyRef PathGenerator::GetPathPolyByPosition(dtPolyRef const* polyPath, uint32 polyPathSize, float const* point, float* distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -128,6 +139,8 @@ dtPolyRef PathGenerator::GetPathPolyByPosition(dtPolyRef const* polyPath, uint32
 
 dtPolyRef PathGenerator::GetPolyByLocation(float const* point, float* distance) const
 {
+    auto tilesGuard = LockTiles();
+
     // first we check the current path
     // if the current path doesn't contain the current poly,
     // we need to use the expensive navMesh.findNearestPoly
@@ -243,6 +256,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         {
             float closestPoint[VERTEX_SIZE];
             // we may want to use closestPointOnPolyBoundary instead
+            auto tilesGuard = LockTiles();
             if (dtStatusSucceed(_navMeshQuery->closestPointOnPoly(endPoly, endPoint, closestPoint, nullptr)))
             {
                 dtVcopy(endPoint, closestPoint);
@@ -341,6 +355,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
 
         // we need any point on our suffix start poly to generate poly-path, so we need last poly in prefix data
         float suffixEndPoint[VERTEX_SIZE];
+        auto tilesGuard = LockTiles();
         if (dtStatusFailed(_navMeshQuery->closestPointOnPoly(suffixStartPoly, endPoint, suffixEndPoint, nullptr)))
         {
             // we can hit offmesh connection as last poly - closestPointOnPoly() don't like that
@@ -350,6 +365,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
             if (dtStatusFailed(_navMeshQuery->closestPointOnPoly(suffixStartPoly, endPoint, suffixEndPoint, nullptr)))
             {
                 // suffixStartPoly is still invalid, error state
+                tilesGuard.unlock();
                 BuildShortcut();
                 _type = PATHFIND_NOPATH;
                 return;
@@ -362,6 +378,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         dtStatus dtResult;
         if (_useRaycast)
         {
+            tilesGuard.unlock();
             BuildShortcut();
             _type = PATHFIND_NOPATH;
             return;
@@ -379,6 +396,8 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                 MAX_PATH_LENGTH - prefixPolyLength); // max number of polygons in output path
         }
 
+        tilesGuard.unlock();
+
         if (!suffixPolyLength || dtStatusFailed(dtResult))
         {
             // this is probably an error state, but we'll leave it
@@ -400,6 +419,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         Clear();
 
         dtStatus dtResult;
+        auto tilesGuard = LockTiles();
         if (_useRaycast)
         {
             float hit = 0;
@@ -419,6 +439,7 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
 
             if (!_polyLength || dtStatusFailed(dtResult))
             {
+                tilesGuard.unlock();
                 BuildShortcut();
                 _type = PATHFIND_NOPATH;
                 AddFarFromPolyFlags(startFarFromPoly, endFarFromPoly);
@@ -438,6 +459,8 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                 if (dtStatusFailed(_navMeshQuery->getPolyHeight(_pathPolyRefs[_polyLength - 1], hitPos, &hitPos[1])))
                     _navMeshQuery->closestPointOnPolyBoundary(_pathPolyRefs[_polyLength - 1], hitPos, hitPos);
 
+                tilesGuard.unlock();
+
                 _pathPoints.resize(2);
                 _pathPoints[0] = GetStartPosition();
                 _pathPoints[1] = G3D::Vector3(hitPos[2], hitPos[0], hitPos[1]);
@@ -453,6 +476,8 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                 if (dtStatusFailed(_navMeshQuery->getPolyHeight(_pathPolyRefs[_polyLength - 1], endPoint, &endPoint[1])))
                     _navMeshQuery->closestPointOnPolyBoundary(_pathPolyRefs[_polyLength - 1], endPoint, endPoint);
 
+                tilesGuard.unlock();
+
                 _pathPoints.resize(2);
                 _pathPoints[0] = GetStartPosition();
                 _pathPoints[1] = G3D::Vector3(endPoint[2], endPoint[0], endPoint[1]);
@@ -482,6 +507,8 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
                 MAX_PATH_LENGTH);   // max number of polygons in output path
         }
 
+        tilesGuard.unlock();
+
         if (!_polyLength || dtStatusFailed(dtResult))
         {
             // only happens if we passed bad data to findPath(), or navmesh is messed up
@@ -531,6 +558,7 @@ void PathGenerator::BuildPointPath(const float* startPoint, const float* endPoin
     }
     else if (_useStraightPath)
     {
+        auto tilesGuard = LockTiles();
         dtResult = _navMeshQuery->findStraightPath(
             startPoint,         // start position
             endPoint,           // end position
@@ -544,6 +572,7 @@ void PathGenerator::BuildPointPath(const float* startPoint, const float* endPoin
     }
     else
     {
+        auto tilesGuard = LockTiles();
         dtResult = FindSmoothPath(
             startPoint,         // start position
             endPoint,           // end position
@@ -712,9 +741,17 @@ bool PathGenerator::HaveTile(const G3D::Vector3& p) const
     if (tx < 0 || ty < 0)
         return false;
 
+    auto tilesGuard = LockTiles();
     return (_navMesh->getTileAt(tx, ty, 0) != nullptr);
 }
 
+std::shared_lock<std::shared_mutex> PathGenerator::LockTiles() const
+{
+    // held only around navmesh queries: map height and liquid queries may create grids,
+    // which load mmap tiles and take this lock exclusively
+    return MMAP::MMapFactory::createOrGetMMapMgr()->LockNavMeshTiles(_source->GetMapId());
+}
+
 uint32 PathGenerator::FixupCorridor(dtPolyRef* path, uint32 npath, uint32 maxPath, dtPolyRef const* visited, uint32 nvisited)
 {
     int32 furthestPath = -1;
@@ -127,7 +127,12 @@ class WH_GAME_API PathGenerator
             _pathPoints.clear();
         }
 
+        // takes over the result calculated by another generator for a unit of the same kind
+        void CopyPathFrom(PathGenerator const& other);
+
     private:
+        friend class PathRequestQueue;
+
         dtPolyRef _pathPolyRefs[MAX_PATH_LENGTH];   // array of detour polygon references
         uint32 _polyLength;                         // number of polygons in the path
 
@@ -146,7 +151,7 @@ class WH_GAME_API PathGenerator
 
         WorldObject const* const _source;       // the object that is moving
         dtNavMesh const* _navMesh;              // the nav mesh
-        dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query used to find the path
+        dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query of the thread calculating the path
 
         dtQueryFilterExt _filter;  // use single filter for all movements, update it when needed
 
@@ -162,6 +167,7 @@ class WH_GAME_API PathGenerator
         dtPolyRef GetPathPolyByPosition(dtPolyRef const* polyPath, uint32 polyPathSize, float const* Point, float* Distance = nullptr) const;
         dtPolyRef GetPolyByLocation(float const* Point, float* Distance) const;
         [[nodiscard]] bool HaveTile(G3D::Vector3 const& p) const;
+        [[nodiscard]] std::shared_lock<std::shared_mutex> LockTiles() const;
 
         void BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos);
         void BuildPointPath(float const* startPoint, float const* endPoint);
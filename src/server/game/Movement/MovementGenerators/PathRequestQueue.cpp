@@ -0,0 +1,190 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "PathRequestQueue.h"
+#include "Creature.h"
+#include "GameConfig.h"
+#include "Map.h"
+#include "MapMgr.h"
+#include <cmath>
+#include <iterator>
+#include <unordered_map>
+
+namespace
+{
+    // Half a yard, creatures of a pack standing that close share their path
+    int32 QuantizePathPoint(float value)
+    {
+        return int32(std::floor(value * 2.0f));
+    }
+}
+
+PathRequestQueue::PathRequestQueue(Map& map) : _map(map),
+    _calculatedMetric("map_path_requests", { METRIC_TAG("map_id", std::to_string(map.GetId())), METRIC_TAG("type", "Calculated") }),
+    _mergedMetric("map_path_requests", { METRIC_TAG("map_id", std::to_string(map.GetId())), METRIC_TAG("type", "Merged") }),
+    _pendingMetric("map_path_requests_pending", { METRIC_TAG("map_id", std::to_string(map.GetId())), METRIC_TAG("map_instanceid", std::to_string(map.GetInstanceId())) })
+{
+    _batch.Task = [this](std::size_t index)
+    {
+        Calculate(*_calculated[index]);
+    };
+}
+
+bool PathRequestQueue::IsEnabled()
+{
+    return CONF_GET_BOOL("Pathfinding.Async");
+}
+
+PathRequestPtr PathRequestQueue::Submit(std::unique_ptr<PathGenerator> path, G3D::Vector3 const& destination, bool forceDest)
+{
+    ASSERT(path);
+
+    PathRequestPtr request = std::make_shared<PathRequest>();
+    request->Path = std::move(path);
+    request->Destination = destination;
+    request->ForceDest = forceDest;
+
+    std::lock_guard<std::mutex> guard(_pendingLock);
+    _pending.push_back(request);
+    return request;
+}
+
+void PathRequestQueue::Process()
+{
+    // loading a grid below may spawn creatures submitting paths, don't hold the lock meanwhile
+    std::deque<PathRequestPtr> pending;
+    {
+        std::lock_guard<std::mutex> guard(_pendingLock);
+        pending.swap(_pending);
+    }
+
+    _pendingMetric.Set(int64(pending.size()));
+
+    if (pending.empty())
+        return;
+
+    uint32 const maxPaths = CONF_GET_UINT("Pathfinding.Async.MaxPathsPerUpdate");
+    std::unordered_map<MergeKey, std::size_t, MergeKeyHash> calculatedByKey;
+
+    while (!pending.empty() && (!maxPaths || _calculated.size() < maxPaths))
+    {
+        PathRequestPtr request = std::move(pending.front());
+        pending.pop_front();
+
+        // the generator dropped it (new destination, movement stopped or generator removed)
+        if (request.use_count() == 1)
+            continue;
+
+        // the owner changed map since, its new map can't be read from here
+        if (request->Path->_source->FindMap() != &_map)
+        {
+            request->Done = true;
+            continue;
+        }
+
+        if (Optional<MergeKey> key = MakeMergeKey(*request))
+        {
+            auto [itr, inserted] = calculatedByKey.emplace(*key, _calculated.size());
+            if (!inserted)
+            {
+                _merged.emplace_back(std::move(request), itr->second);
+                continue;
+            }
+        }
+
+        // Grid and mmap tile loading isn't thread safe, load both ends before the workers read them
+        G3D::Vector3 const& destination = request->Destination;
+        if (Warhead::IsValidMapCoord(destination.x, destination.y))
+            _map.GetGrid(destination.x, destination.y);
+
+        _calculated.push_back(std::move(request));
+    }
+
+    // the rest waits for the next update, ahead of the requests submitted meanwhile
+    if (!pending.empty())
+    {
+        std::lock_guard<std::mutex> guard(_pendingLock);
+        _pending.insert(_pending.begin(), std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.end()));
+    }
+
+    MapUpdater* mapUpdater = sMapMgr->GetMapUpdater();
+    if (_calculated.size() < 2 || !mapUpdater->IsActive())
+    {
+        for (PathRequestPtr const& request : _calculated)
+            Calculate(*request);
+    }
+    else
+    {
+        _batch.Count = _calculated.size();
+        mapUpdater->RunTaskBatch(_batch, _map.GetLastUpdateCost());
+    }
+
+    for (auto& [request, index] : _merged)
+    {
+        PathRequest const& calculated = *_calculated[index];
+        request->Path->CopyPathFrom(*calculated.Path);
+        request->Result = calculated.Result;
+        request->Done = true;
+    }
+
+    _calculatedMetric.Add(_calculated.size());
+    _mergedMetric.Add(_merged.size());
+
+    _calculated.clear();
+    _merged.clear();
+}
+
+Optional<PathRequestQueue::MergeKey> PathRequestQueue::MakeMergeKey(PathRequest const& request)
+{
+    PathGenerator const& path = *request.Path;
+
+    // Only creatures of the same template move alike, players and pets get their own paths
+    Creature const* creature = path._source->ToCreature();
+    if (!creature || creature->IsPet())
+        return {};
+
+    uint32 state = (request.ForceDest ? 0x1 : 0) | (path._useStraightPath ? 0x2 : 0) | (path._slopeCheck ? 0x4 : 0) | (path._useRaycast ? 0x8 : 0) |
+        (creature->CanFly() ? 0x10 : 0) | (creature->CanSwim() ? 0x20 : 0) | (creature->IsHovering() ? 0x40 : 0) | (creature->IsFalling() ? 0x80 : 0) |
+        (creature->HasUnitState(UNIT_STATE_IGNORE_PATHFINDING) ? 0x100 : 0) | (path._pointPathLimit << 16);
+
+    return MergeKey{ creature->GetEntry(), state, creature->GetPhaseMask(),
+        { QuantizePathPoint(creature->GetPositionX()), QuantizePathPoint(creature->GetPositionY()), QuantizePathPoint(creature->GetPositionZ()),
+          QuantizePathPoint(request.Destination.x), QuantizePathPoint(request.Destination.y), QuantizePathPoint(request.Destination.z) } };
+}
+
+std::size_t PathRequestQueue::MergeKeyHash::operator()(MergeKey const& key) const
+{
+    // FNV-1a over the key fields
+    uint64 hash = 14695981039346656037ULL;
+    hash = (hash ^ key.Entry) * 1099511628211ULL;
+    hash = (hash ^ key.State) * 1099511628211ULL;
+    hash = (hash ^ key.PhaseMask) * 1099511628211ULL;
+
+    for (int32 point : key.Points)
+        hash = (hash ^ uint32(point)) * 1099511628211ULL;
+
+    return std::size_t(hash ^ (hash >> 32));
+}
+
+void PathRequestQueue::Calculate(PathRequest& request)
+{
+    request.Result = request.Path->CalculatePath(request.Destination.x, request.Destination.y, request.Destination.z, request.ForceDest);
+    request.Done = true;
+}
@@ -0,0 +1,96 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATH_REQUEST_QUEUE_H_
+#define PATH_REQUEST_QUEUE_H_
+
+#include "MapUpdater.h"
+#include "Metric.h"
+#include "Optional.h"
+#include "PathGenerator.h"
+#include <array>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Map;
+
+// Path calculated by PathRequestQueue, shared by the queue and the movement generator that submitted it
+struct PathRequest
+{
+    std::unique_ptr<PathGenerator> Path;
+    G3D::Vector3 Destination;
+    bool ForceDest{};
+    bool Result{}; // return value of PathGenerator::CalculatePath
+    bool Done{};
+};
+
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
+// Opt-in (Pathfinding.Async) batched path calculation of a map.
+// Movement generators submit requests during an update of the map. At the start of the next update the requests are
+// calculated on the MapUpdater workers, each worker with its own dtNavMeshQuery (see MMapMgr::GetNavMeshQuery), and the
+// generators pick up the results during that update. Requests of creatures of the same entry between the same points
+// are calculated once, requests dropped by their generator are skipped and at most Pathfinding.Async.MaxPathsPerUpdate
+// paths are calculated per update, the rest waits for the next one.
+class WH_GAME_API PathRequestQueue
+{
+public:
+    explicit PathRequestQueue(Map& map);
+
+    [[nodiscard]] static bool IsEnabled();
+
+    // path keeps the options set by the generator, it is handed back through the request once calculated
+    PathRequestPtr Submit(std::unique_ptr<PathGenerator> path, G3D::Vector3 const& destination, bool forceDest);
+
+    // Start of a map update, before any object is updated
+    void Process();
+
+private:
+    struct MergeKey
+    {
+        uint32 Entry;
+        uint32 State;
+        uint32 PhaseMask;
+        std::array<int32, 6> Points;
+
+        bool operator==(MergeKey const& right) const = default;
+    };
+
+    struct MergeKeyHash
+    {
+        std::size_t operator()(MergeKey const& key) const;
+    };
+
+    [[nodiscard]] static Optional<MergeKey> MakeMergeKey(PathRequest const& request);
+    static void Calculate(PathRequest& request);
+
+    Map& _map;
+    std::deque<PathRequestPtr> _pending;
+    std::mutex _pendingLock; // creatures of different regions submit concurrently
+    std::vector<PathRequestPtr> _calculated;
+    std::vector<std::pair<PathRequestPtr, std::size_t /*index in _calculated*/>> _merged;
+
+    MapUpdaterTaskBatch _batch;
+
+    MetricCounter _calculatedMetric;
+    MetricCounter _mergedMetric;
+    MetricGauge _pendingMetric;
+};
+
+#endif
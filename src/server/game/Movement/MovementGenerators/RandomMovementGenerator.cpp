@@ -38,12 +38,111 @@ RandomMovementGenerator<Creature>::~RandomMovementGenerator()
     delete _pathGenerator;
 }
 
+template<>
+bool RandomMovementGenerator<Creature>::_validateGroundPath(Creature* creature, bool calculated, G3D::Vector3 const& destination, Movement::PointsArray& finalPath)
+{
+    if (!calculated || (_pathGenerator->GetPathType() & PATHFIND_NOPATH))
+        return false;
+
+    // generated path is too long
+    float pathLen = _pathGenerator->getPathLength();
+    if (pathLen * pathLen > creature->GetExactDistSq(destination.x, destination.y, destination.z) * MAX_PATH_LENGHT_FACTOR * MAX_PATH_LENGHT_FACTOR)
+        return false;
+
+    finalPath = _pathGenerator->GetPath();
+    Map* map = creature->GetMap();
+    Movement::PointsArray::iterator itr = finalPath.begin();
+    Movement::PointsArray::iterator itrNext = finalPath.begin() + 1;
+    float zDiff, distDiff;
+
+    for (; itrNext != finalPath.end(); ++itr, ++itrNext)
+    {
+        distDiff = std::sqrt(((*itr).x - (*itrNext).x) * ((*itr).x - (*itrNext).x) + ((*itr).y - (*itrNext).y) * ((*itr).y - (*itrNext).y));
+        zDiff = std::fabs((*itr).z - (*itrNext).z);
+
+        // Xinef: tree climbing, cut as much as we can
+        if (zDiff > 2.0f ||
+                (G3D::fuzzyNe(zDiff, 0.0f) && distDiff / zDiff < 2.15f)) // ~25˚
+            return false;
+
+        if (!map->isInLineOfSight((*itr).x, (*itr).y, (*itr).z + 2.f, (*itrNext).x, (*itrNext).y, (*itrNext).z + 2.f, creature->GetPhaseMask(),
+            LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::Nothing))
+            return false;
+    }
+
+    // no valid path
+    return finalPath.size() >= 2;
+}
+
+template<>
+void RandomMovementGenerator<Creature>::_moveToPoint(Creature* creature, uint8 newPoint, uint16 pathIdx)
+{
+    Movement::PointsArray& finalPath = _preComputedPaths[pathIdx];
+    _currentPoint = newPoint;
+    G3D::Vector3& finalPoint = finalPath[finalPath.size() - 1];
+    _currDestPosition.Relocate(finalPoint.x, finalPoint.y, finalPoint.z);
+
+    creature->AddUnitState(UNIT_STATE_ROAMING_MOVE);
+    bool walk = true;
+    switch (creature->GetMovementTemplate().GetRandom())
+    {
+    case CreatureRandomMovementType::CanRun:
+        walk = creature->IsWalking();
+        break;
+    case CreatureRandomMovementType::AlwaysRun:
+        walk = false;
+        break;
+    default:
+        break;
+    }
+
+    Movement::MoveSplineInit init(creature);
+    init.MovebyPath(finalPath);
+    init.SetWalk(walk);
+    init.Launch();
+
+    ++_moveCount;
+    if (roll_chance_i((int32) _moveCount * 25 + 10))
+    {
+        _moveCount = 0;
+        _nextMoveTime.Reset(urand(4000, 8000));
+    }
+    if (CONF_GET_BOOL("DontCacheRandomMovementPaths"))
+        _preComputedPaths.erase(pathIdx);
+
+    //Call for creature group update
+    if (creature->GetFormation() && creature->GetFormation()->GetLeader() == creature)
+        creature->GetFormation()->LeaderMoveTo(finalPoint.x, finalPoint.y, finalPoint.z, false);
+}
+
 template<>
 void RandomMovementGenerator<Creature>::_setRandomLocation(Creature* creature)
 {
     if (creature->_moveState != MAP_OBJECT_CELL_MOVE_NONE)
         return;
 
+    // path requested during the previous update of the map
+    if (_pathRequest)
+    {
+        if (!_pathRequest->Done)
+            return;
+
+        PathRequestPtr request = std::move(_pathRequest);
+        _pathGenerator = request->Path.release();
+
+        uint8 newPoint = _pathRequestPoint;
+        uint16 pathIdx = uint16(_currentPoint * RANDOM_POINTS_NUMBER + newPoint);
+        if (!_validateGroundPath(creature, request->Result, request->Destination, _preComputedPaths[pathIdx]))
+        {
+            std::erase(_validPointsVector[_currentPoint], newPoint);
+            _preComputedPaths.erase(pathIdx);
+            return;
+        }
+
+        _moveToPoint(creature, newPoint, pathIdx);
+        return;
+    }
+
     if (_validPointsVector[_currentPoint].empty())
     {
         if (_currentPoint == RANDOM_POINTS_NUMBER) // cant go anywhere from initial position, lets stay
@@ -137,55 +236,19 @@ void RandomMovementGenerator<Creature>::_setRandomLocation(Creature* creature)
         }
         else // ground
         {
-            bool result = _pathGenerator->CalculatePath(x, y, levelZ, false);
-            if (result && !(_pathGenerator->GetPathType() & PATHFIND_NOPATH))
+            // generator is handed back when a pending request gets cancelled
+            if (!_pathGenerator)
+                _pathGenerator = new PathGenerator(creature);
+
+            if (PathRequestQueue::IsEnabled())
             {
-                // generated path is too long
-                float pathLen = _pathGenerator->getPathLength();
-                if (pathLen * pathLen > creature->GetExactDistSq(x, y, levelZ) * MAX_PATH_LENGHT_FACTOR * MAX_PATH_LENGHT_FACTOR)
-                {
-                    _validPointsVector[_currentPoint].erase(randomIter);
-                    _preComputedPaths.erase(pathIdx);
-                    return;
-                }
-
-                finalPath = _pathGenerator->GetPath();
-                Movement::PointsArray::iterator itr = finalPath.begin();
-                Movement::PointsArray::iterator itrNext = finalPath.begin() + 1;
-                float zDiff, distDiff;
-
-                for (; itrNext != finalPath.end(); ++itr, ++itrNext)
-                {
-                    distDiff = std::sqrt(((*itr).x - (*itrNext).x) * ((*itr).x - (*itrNext).x) + ((*itr).y - (*itrNext).y) * ((*itr).y - (*itrNext).y));
-                    zDiff = std::fabs((*itr).z - (*itrNext).z);
-
-                    // Xinef: tree climbing, cut as much as we can
-                    if (zDiff > 2.0f ||
-                            (G3D::fuzzyNe(zDiff, 0.0f) && distDiff / zDiff < 2.15f)) // ~25˚
-                    {
-                        _validPointsVector[_currentPoint].erase(randomIter);
-                        _preComputedPaths.erase(pathIdx);
-                        return;
-                    }
-
-                    if (!map->isInLineOfSight((*itr).x, (*itr).y, (*itr).z + 2.f, (*itrNext).x, (*itrNext).y, (*itrNext).z + 2.f, creature->GetPhaseMask(),
-                        LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::Nothing))
-                    {
-                        _validPointsVector[_currentPoint].erase(randomIter);
-                        _preComputedPaths.erase(pathIdx);
-                        return;
-                    }
-                }
-
-                // no valid path
-                if (finalPath.size() < 2)
-                {
-                    _validPointsVector[_currentPoint].erase(randomIter);
-                    _preComputedPaths.erase(pathIdx);
-                    return;
-                }
+                _preComputedPaths.erase(pathIdx);
+                _pathRequest = map->GetPathRequests().Submit(std::unique_ptr<PathGenerator>(std::exchange(_pathGenerator, nullptr)), G3D::Vector3(x, y, levelZ), false);
+                _pathRequestPoint = newPoint;
+                return;
             }
-            else
+
+            if (!_validateGroundPath(creature, _pathGenerator->CalculatePath(x, y, levelZ, false), G3D::Vector3(x, y, levelZ), finalPath))
             {
                 _validPointsVector[_currentPoint].erase(randomIter);
                 _preComputedPaths.erase(pathIdx);
@@ -194,41 +257,7 @@ void RandomMovementGenerator<Creature>::_setRandomLocation(Creature* creature)
         }
     }
 
-    _currentPoint = newPoint;
-    G3D::Vector3& finalPoint = finalPath[finalPath.size() - 1];
-    _currDestPosition.Relocate(finalPoint.x, finalPoint.y, finalPoint.z);
-
-    creature->AddUnitState(UNIT_STATE_ROAMING_MOVE);
-    bool walk = true;
-    switch (creature->GetMovementTemplate().GetRandom())
-    {
-    case CreatureRandomMovementType::CanRun:
-        walk = creature->IsWalking();
-        break;
-    case CreatureRandomMovementType::AlwaysRun:
-        walk = false;
-        break;
-    default:
-        break;
-    }
-
-    Movement::MoveSplineInit init(creature);
-    init.MovebyPath(finalPath);
-    init.SetWalk(walk);
-    init.Launch();
-
-    ++_moveCount;
-    if (roll_chance_i((int32) _moveCount * 25 + 10))
-    {
-        _moveCount = 0;
-        _nextMoveTime.Reset(urand(4000, 8000));
-    }
-    if (CONF_GET_BOOL("DontCacheRandomMovementPaths"))
-        _preComputedPaths.erase(pathIdx);
-
-    //Call for creature group update
-    if (creature->GetFormation() && creature->GetFormation()->GetLeader() == creature)
-        creature->GetFormation()->LeaderMoveTo(finalPoint.x, finalPoint.y, finalPoint.z, false);
+    _moveToPoint(creature, newPoint, pathIdx);
 }
 
 template<>
@@ -255,6 +284,7 @@ void RandomMovementGenerator<Creature>::DoInitialize(Creature* creature)
         }
     }
 
+    _pathRequest = nullptr;
     if (!_pathGenerator)
         _pathGenerator = new PathGenerator(creature);
     creature->AddUnitState(UNIT_STATE_ROAMING | UNIT_STATE_ROAMING_MOVE);
@@ -279,6 +309,7 @@ bool RandomMovementGenerator<Creature>::DoUpdate(Creature* creature, const uint3
     if (creature->HasUnitState(UNIT_STATE_NOT_MOVE) || creature->IsMovementPreventedByCasting())
     {
         _nextMoveTime.Reset(0);  // Expire the timer
+        _pathRequest = nullptr;
         creature->StopMoving();
         return true;
     }
@@ -20,6 +20,7 @@
 
 #include "MovementGenerator.h"
 #include "PathGenerator.h"
+#include "PathRequestQueue.h"
 
 #define RANDOM_POINTS_NUMBER        12
 #define RANDOM_LINKS_COUNT          7
@@ -58,6 +59,9 @@ public:
     MovementGeneratorType GetMovementGeneratorType() { return RANDOM_MOTION_TYPE; }
 
 private:
+    bool _validateGroundPath(T*, bool calculated, G3D::Vector3 const& destination, Movement::PointsArray& finalPath);
+    void _moveToPoint(T*, uint8 newPoint, uint16 pathIdx);
+
     TimeTrackerSmall _nextMoveTime;
     uint8 _moveCount;
     float _wanderDistance;
@@ -67,5 +71,7 @@ private:
     uint8 _currentPoint;
     std::map<uint16, Movement::PointsArray> _preComputedPaths;
     Position _initialPosition, _currDestPosition;
+    PathRequestPtr _pathRequest;
+    uint8 _pathRequestPoint{};
 };
 #endif
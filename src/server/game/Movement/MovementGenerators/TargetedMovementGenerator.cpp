@@ -21,6 +21,7 @@
 #include "TargetedMovementGenerator.h"
 #include "Creature.h"
 #include "CreatureAI.h"
+#include "Map.h"
 #include "MoveSplineInit.h"
 #include "Pet.h"
 #include "Player.h"
@@ -64,6 +65,7 @@ bool ChaseMovementGenerator<T>::DoUpdate(T* owner, uint32 time_diff)
     {
         owner->StopMoving();
         _lastTargetPosition.reset();
+        _pathRequest = nullptr;
         if (Creature* cOwner2 = owner->ToCreature())
         {
             cOwner2->SetCannotReachTarget();
@@ -101,6 +103,7 @@ bool ChaseMovementGenerator<T>::DoUpdate(T* owner, uint32 time_diff)
 
             i_recalculateTravel = false;
             i_path = nullptr;
+            _pathRequest = nullptr;
 
             owner->StopMoving();
             owner->SetInFront(target);
@@ -135,6 +138,18 @@ bool ChaseMovementGenerator<T>::DoUpdate(T* owner, uint32 time_diff)
         i_path = nullptr;
     }
 
+    // path requested during the previous update of the map
+    if (_pathRequest)
+    {
+        if (!_pathRequest->Done)
+            return true;
+
+        PathRequestPtr request = std::move(_pathRequest);
+        i_path = std::move(request->Path);
+        MoveAlongPath(owner, target, request->Result, _pathRequestShortens, maxTarget);
+        return true;
+    }
+
     if (_lastTargetPosition && i_target->GetPosition() == _lastTargetPosition.value() && mutualChase == _mutualChase)
         return true;
 
@@ -167,6 +182,7 @@ bool ChaseMovementGenerator<T>::DoUpdate(T* owner, uint32 time_diff)
             cOwner->SetCannotReachTarget(target->GetGUID());
             cOwner->StopMoving();
             i_path = nullptr;
+            _pathRequest = nullptr;
             return true;
         }
     }
@@ -197,15 +213,30 @@ bool ChaseMovementGenerator<T>::DoUpdate(T* owner, uint32 time_diff)
 
     i_recalculateTravel = true;
 
-    bool success = i_path->CalculatePath(x, y, z, forceDest);
-    if (!success || i_path->GetPathType() & PATHFIND_NOPATH)
+    if (PathRequestQueue::IsEnabled())
+    {
+        _pathRequest = owner->GetMap()->GetPathRequests().Submit(std::move(i_path), G3D::Vector3(x, y, z), forceDest);
+        _pathRequestShortens = shortenPath;
+        return true;
+    }
+
+    MoveAlongPath(owner, target, i_path->CalculatePath(x, y, z, forceDest), shortenPath, maxTarget);
+    return true;
+}
+
+template<class T>
+void ChaseMovementGenerator<T>::MoveAlongPath(T* owner, Unit* target, bool calculated, bool shortenPath, float maxTarget)
+{
+    Creature* cOwner = owner->ToCreature();
+
+    if (!calculated || i_path->GetPathType() & PATHFIND_NOPATH)
     {
         if (cOwner)
         {
             cOwner->SetCannotReachTarget(target->GetGUID());
         }
 
-        return true;
+        return;
     }
 
     if (shortenPath)
@@ -240,8 +271,6 @@ bool ChaseMovementGenerator<T>::DoUpdate(T* owner, uint32 time_diff)
     init.SetFacing(target);
     init.SetWalk(walk);
     init.Launch();
-
-    return true;
 }
 
 //-----------------------------------------------//
@@ -249,6 +278,7 @@ template<>
 void ChaseMovementGenerator<Player>::DoInitialize(Player* owner)
 {
     i_path = nullptr;
+    _pathRequest = nullptr;
     _lastTargetPosition.reset();
     owner->StopMoving();
     owner->AddUnitState(UNIT_STATE_CHASE);
@@ -258,6 +288,7 @@ template<>
 void ChaseMovementGenerator<Creature>::DoInitialize(Creature* owner)
 {
     i_path = nullptr;
+    _pathRequest = nullptr;
     _lastTargetPosition.reset();
     owner->SetWalk(false);
     owner->StopMoving();
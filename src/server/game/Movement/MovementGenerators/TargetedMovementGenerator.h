@@ -22,6 +22,7 @@
 #include "MovementGenerator.h"
 #include "Optional.h"
 #include "PathGenerator.h"
+#include "PathRequestQueue.h"
 #include "Timer.h"
 #include "Unit.h"
 
@@ -59,7 +60,11 @@ public:
     bool HasLostTarget(Unit* unit) const { return unit->GetVictim() != this->GetTarget(); }
 
 private:
+    void MoveAlongPath(T* owner, Unit* target, bool calculated, bool shortenPath, float maxTarget);
+
     std::unique_ptr<PathGenerator> i_path;
+    PathRequestPtr _pathRequest;         // Pathfinding.Async, i_path is owned by the request meanwhile
+    bool _pathRequestShortens = false;
     TimeTrackerSmall i_recheckDistance;
     bool i_recalculateTravel;
 
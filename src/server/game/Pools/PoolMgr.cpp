@@ -203,6 +203,7 @@ void PoolGroup<Creature>::Despawn1Object(ObjectGuid::LowType guid)
         Map* map = sMapMgr->CreateBaseMap(data->mapid);
         if (!map->Instanceable())
         {
+            auto guard = map->LockForRegionUpdate();
             auto creatureBounds = map->GetCreatureBySpawnIdStore().equal_range(guid);
             for (auto itr = creatureBounds.first; itr != creatureBounds.second;)
             {
@@ -225,6 +226,7 @@ void PoolGroup<GameObject>::Despawn1Object(ObjectGuid::LowType guid)
         Map* map = sMapMgr->CreateBaseMap(data->mapid);
         if (!map->Instanceable())
         {
+            auto guard = map->LockForRegionUpdate();
             auto gameobjectBounds = map->GetGameObjectBySpawnIdStore().equal_range(guid);
             for (auto itr = gameobjectBounds.first; itr != gameobjectBounds.second;)
             {
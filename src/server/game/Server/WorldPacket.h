@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "Duration.h"
 #include "Opcodes.h"
+#include <memory>
 
 class WorldPacket : public ByteBuffer
 {
@@ -77,10 +78,14 @@ public:
     void SetOpcode(uint16 opcode) { m_opcode = opcode; }
 
     [[nodiscard]] TimePoint GetReceivedTime() const { return m_receivedTime; }
+    void SetReceivedTime(TimePoint receivedTime) { m_receivedTime = receivedTime; }
 
 protected:
     uint16 m_opcode{NULL_OPCODE};
     TimePoint m_receivedTime; // only set for a specific set of opcodes, for performance reasons.
 };
 
+/// Immutable packet built once and sent to many sessions, the sockets only reference its payload
+typedef std::shared_ptr<WorldPacket const> SharedWorldPacket;
+
 #endif
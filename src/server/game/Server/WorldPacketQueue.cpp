@@ -0,0 +1,150 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "WorldPacketQueue.h"
+#include "Metric.h"
+#include "Opcodes.h"
+#include "WorldPacket.h"
+#include "WorldSession.h"
+#include <array>
+
+namespace
+{
+    MetricHistogram const& GetQueueWaitHistogram(uint16 opcode)
+    {
+        static std::array<MetricHistogram, NUM_OPCODE_HANDLERS> const histograms = []()
+        {
+            std::array<MetricHistogram, NUM_OPCODE_HANDLERS> result;
+
+            for (uint32 i = 0; i < NUM_OPCODE_HANDLERS; ++i)
+                if (ClientOpcodeHandler const* handler = opcodeTable[static_cast<OpcodeClient>(i)])
+                    result[i] = MetricHistogram("worldsession_queue_wait_time", { METRIC_TAG("opcode", handler->Name) });
+
+            return result;
+        }();
+
+        return histograms[opcode];
+    }
+}
+
+WorldPacketQueue::~WorldPacketQueue()
+{
+    WorldPacket* packet = nullptr;
+    while (Next(packet))
+        delete packet;
+
+    while (_pool.Dequeue(packet))
+        delete packet;
+}
+
+void WorldPacketQueue::Add(uint16 opcode, uint8 const* data, std::size_t size, TimePoint receivedTime)
+{
+    Entry entry;
+    if (!_pool.Dequeue(entry.Packet))
+        entry.Packet = new WorldPacket();
+
+    entry.Packet->Initialize(opcode, size);
+    entry.Packet->SetReceivedTime(receivedTime);
+
+    if (size)
+        entry.Packet->append(data, size);
+
+    if (sMetric->IsEnabled())
+        entry.QueueTime = std::chrono::steady_clock::now();
+
+    // once a packet went to the overflow all following ones must go there too, to keep them ordered
+    if (!_overflowSize.load(std::memory_order_acquire) && _queue.Enqueue(entry))
+        return;
+
+    std::lock_guard<std::mutex> guard(_overflowLock);
+    _overflow.push_back(entry);
+    _overflowSize.fetch_add(1, std::memory_order_release);
+}
+
+WorldPacketQueue::Entry* WorldPacketQueue::Front()
+{
+    if (Entry* entry = _queue.Peek())
+        return entry;
+
+    if (!_overflowSize.load(std::memory_order_acquire))
+        return nullptr;
+
+    // only the consumer removes elements, the front stays valid after unlocking
+    std::lock_guard<std::mutex> guard(_overflowLock);
+    return &_overflow.front();
+}
+
+void WorldPacketQueue::PopFront()
+{
+    if (Entry* entry = _queue.Peek())
+    {
+        if (entry->QueueTime != TimePoint())
+            GetQueueWaitHistogram(entry->Packet->GetOpcode()).Record(std::chrono::steady_clock::now() - entry->QueueTime);
+
+        _queue.Pop();
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(_overflowLock);
+
+    Entry const& entry = _overflow.front();
+    if (entry.QueueTime != TimePoint())
+        GetQueueWaitHistogram(entry.Packet->GetOpcode()).Record(std::chrono::steady_clock::now() - entry.QueueTime);
+
+    _overflow.pop_front();
+    _overflowSize.fetch_sub(1, std::memory_order_release);
+}
+
+bool WorldPacketQueue::Next(WorldPacket*& packet)
+{
+    Entry* entry = Front();
+    if (!entry)
+        return false;
+
+    packet = entry->Packet;
+    PopFront();
+    return true;
+}
+
+bool WorldPacketQueue::Next(WorldPacket*& packet, PacketFilter& filter)
+{
+    Entry* entry = Front();
+    if (!entry)
+        return false;
+
+    packet = entry->Packet;
+    if (!filter.Process(packet))
+        return false;
+
+    PopFront();
+    return true;
+}
+
+void WorldPacketQueue::Release(WorldPacket* packet)
+{
+    // big buffers are not kept around, most client packets are small
+    if (packet->size() > MAX_POOLED_PACKET_SIZE || !_pool.Enqueue(packet))
+        delete packet;
+}
+
+std::size_t WorldPacketQueue::Size() const
+{
+    return _queue.Size() + _overflowSize.load(std::memory_order_acquire);
+}
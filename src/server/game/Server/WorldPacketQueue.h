@@ -0,0 +1,80 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WORLD_PACKET_QUEUE_H_
+#define _WORLD_PACKET_QUEUE_H_
+
+#include "Define.h"
+#include "Duration.h"
+#include "SPSCQueue.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+class PacketFilter;
+class WorldPacket;
+
+/**
+    Packets received for a session. The network thread of its socket is the only producer, the session update
+    (world thread or map thread of the player, never both at the same time) is the only consumer.
+    Processed packets go back to the network thread and keep their storage for the next received ones.
+*/
+class WH_GAME_API WorldPacketQueue
+{
+public:
+    WorldPacketQueue() = default;
+    ~WorldPacketQueue();
+
+    // network thread
+    void Add(uint16 opcode, uint8 const* data, std::size_t size, TimePoint receivedTime);
+
+    // session update
+    bool Next(WorldPacket*& packet);
+    bool Next(WorldPacket*& packet, PacketFilter& filter);
+    void Release(WorldPacket* packet);
+
+    std::size_t Size() const;
+
+private:
+    struct Entry
+    {
+        WorldPacket* Packet{ nullptr };
+        TimePoint QueueTime;
+    };
+
+    Entry* Front();
+    void PopFront();
+
+    static constexpr std::size_t QUEUE_SIZE = 256;
+    static constexpr std::size_t POOL_SIZE = 32;
+    static constexpr std::size_t MAX_POOLED_PACKET_SIZE = 4096;
+
+    SPSCQueue<Entry, QUEUE_SIZE> _queue;
+
+    // takes the packets once the ring is full, until the session update drained it
+    std::mutex _overflowLock;
+    std::deque<Entry> _overflow;
+    std::atomic<std::size_t> _overflowSize{ 0 };
+
+    // processed packets, from the session update back to the network thread
+    SPSCQueue<WorldPacket*, POOL_SIZE> _pool;
+
+    WorldPacketQueue(WorldPacketQueue const&) = delete;
+    WorldPacketQueue& operator=(WorldPacketQueue const&) = delete;
+};
+
+#endif
@@ -179,7 +179,7 @@ WorldSession::~WorldSession()
 
     ///- empty incoming packet queue
     WorldPacket* packet = nullptr;
-    while (_recvQueue.next(packet))
+    while (_recvQueue.Next(packet))
         delete packet;
 
     if (GetShouldSetOfflineInDB())
@@ -214,16 +214,16 @@ ObjectGuid::LowType WorldSession::GetGuidLow() const
 }
 
 /// Send a packet to the client
-void WorldSession::SendPacket(WorldPacket const* packet)
+bool WorldSession::CanSendPacket(WorldPacket const& packet)
 {
-    if (packet->GetOpcode() == NULL_OPCODE)
+    if (packet.GetOpcode() == NULL_OPCODE)
     {
         LOG_ERROR("network.opcode", "{} send NULL_OPCODE", GetPlayerInfo());
-        return;
+        return false;
     }
 
     if (!m_Socket)
-        return;
+        return false;
 
 #if defined(ENABLE_EXTRAS) && defined(ENABLE_EXTRA_LOGS) && defined(WARHEAD_DEBUG)
     // Code for network use statistic
@@ -241,10 +241,10 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     if ((cur_time - lastTime) < 60)
     {
         sendPacketCount += 1;
-        sendPacketBytes += packet->size();
+        sendPacketBytes += packet.size();
 
         sendLastPacketCount += 1;
-        sendLastPacketBytes += packet->size();
+        sendLastPacketBytes += packet.size();
     }
     else
     {
@@ -257,23 +257,35 @@ void WorldSession::SendPacket(WorldPacket const* packet)
 
         lastTime = cur_time;
         sendLastPacketCount = 1;
-        sendLastPacketBytes = packet->wpos();               // wpos is real written size
+        sendLastPacketBytes = packet.wpos();               // wpos is real written size
     }
 #endif                                                      // !WARHEAD_DEBUG
 
-    if (!sScriptMgr->CanPacketSend(this, *packet))
+    if (!sScriptMgr->CanPacketSend(this, packet))
     {
-        return;
+        return false;
     }
 
-    LOG_TRACE("network.opcode", "S->C: {} {}", GetPlayerInfo(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())));
-    m_Socket->SendPacket(*packet);
+    LOG_TRACE("network.opcode", "S->C: {} {}", GetPlayerInfo(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet.GetOpcode())));
+    return true;
+}
+
+void WorldSession::SendPacket(WorldPacket const* packet)
+{
+    if (CanSendPacket(*packet))
+        m_Socket->SendPacket(*packet);
+}
+
+void WorldSession::SendPacket(SharedWorldPacket const& packet)
+{
+    if (CanSendPacket(*packet))
+        m_Socket->SendPacket(packet);
 }
 
-/// Add an incoming packet to the queue
-void WorldSession::QueuePacket(WorldPacket* new_packet)
+/// Add an incoming packet to the queue, the payload is copied into a recycled packet
+void WorldSession::QueuePacket(uint16 opcode, uint8 const* data, std::size_t size, TimePoint receivedTime)
 {
-    _recvQueue.add(new_packet);
+    _recvQueue.Add(opcode, data, size, receivedTime);
 }
 
 /// Logging helper for unexpected opcodes
@@ -315,15 +327,14 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 
     //! Delete packet after processing by default
     bool deletePacket = true;
-    std::vector<WorldPacket*> requeuePackets;
     uint32 processedPackets = 0;
     time_t currentTime = GameTime::GetGameTime().count();
-    auto queueSize{ _recvQueue.size() };
+    auto queueSize{ _recvQueue.Size() };
 
     if (queueSize >= MAX_PROCESSED_PACKETS_IN_SAME_WORLDSESSION_UPDATE)
         LOG_WARN("network", "Found potential packet flood from: {}. Queue size: {}", GetPlayerInfo(), queueSize);
 
-    while (m_Socket && _recvQueue.next(packet, updater))
+    while (m_Socket && _recvQueue.Next(packet, updater))
     {
         OpcodeClient opcode = static_cast<OpcodeClient>(packet->GetOpcode());
         ClientOpcodeHandler const* opHandle = opcodeTable[opcode];
@@ -443,7 +454,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         }
 
         if (deletePacket)
-            delete packet;
+            _recvQueue.Release(packet);
 
         deletePacket = true;
 
@@ -453,8 +464,6 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
             break;
     }
 
-    _recvQueue.readd(requeuePackets.begin(), requeuePackets.end());
-
     METRIC_VALUE("processed_packets", processedPackets);
     METRIC_VALUE("addon_messages", _addonMessageReceiveCount.load());
     _addonMessageReceiveCount = 0;
@@ -31,6 +31,7 @@
 #include "Packet.h"
 #include "SharedDefines.h"
 #include "World.h"
+#include "WorldPacketQueue.h"
 #include <map>
 #include <utility>
 
@@ -355,6 +356,7 @@ public:
     void WriteMovementInfo(WorldPacket* data, MovementInfo* mi);
 
     void SendPacket(WorldPacket const* packet);
+    void SendPacket(SharedWorldPacket const& packet); // for broadcasts, the payload is shared instead of copied
 
     void SendPetNameInvalid(uint32 error, std::string const& name, DeclinedName* declinedName);
     void SendPartyResult(PartyOperation operation, std::string const& member, PartyResult res, uint32 val = 0);
@@ -414,7 +416,7 @@ public:
     // May kick player on false depending on world config (handler should abort)
     bool DisallowHyperlinksAndMaybeKick(std::string_view str);
 
-    void QueuePacket(WorldPacket* new_packet);
+    void QueuePacket(uint16 opcode, uint8 const* data, std::size_t size, TimePoint receivedTime);
     bool Update(uint32 diff, PacketFilter& updater);
 
     /// Handle the authentication waiting queue (to be completed)
@@ -1126,6 +1128,8 @@ private:
 
     bool recoveryItem(Item* pItem);
 
+    bool CanSendPacket(WorldPacket const& packet);
+
     // logging helper
     void LogUnexpectedOpcode(WorldPacket* packet, char const* status, const char* reason);
     void LogUnprocessedTail(WorldPacket* packet);
@@ -1171,7 +1175,7 @@ private:
     AddonsList m_addonsList;
     uint32 recruiterId;
     bool isRecruiter;
-    LockedQueue<WorldPacket*> _recvQueue;
+    WorldPacketQueue _recvQueue;
     uint32 m_currentVendorEntry;
     ObjectGuid m_currentBankerGUID;
     uint32 _offlineTime;
@@ -40,7 +40,7 @@
 using boost::asio::ip::tcp;
 
 WorldSocket::WorldSocket(tcp::socket&& socket)
-    : Socket(std::move(socket)), _OverSpeedPings(0), _worldSession(nullptr), _authed(false), _sendBufferSize(4096)
+    : Socket(std::move(socket)), _OverSpeedPings(0), _worldSession(nullptr), _authed(false)
 {
     Warhead::Crypto::GetRandomBytes(_authSeed);
     _headerBuffer.Resize(sizeof(ClientPktHeader));
@@ -107,41 +107,20 @@ void WorldSocket::CheckIpCallback(PreparedQueryResult result)
 bool WorldSocket::Update()
 {
     EncryptablePacket* queued;
-    MessageBuffer buffer(_sendBufferSize);
     while (_bufferQueue.Dequeue(queued))
     {
-        ServerPktHeader header(queued->size() + 2, queued->GetOpcode());
+        WorldPacket const& packet = *queued->GetPacket();
+
+        ServerPktHeader header(packet.size() + 2, packet.GetOpcode());
         if (queued->NeedsEncryption())
             _authCrypt.EncryptSend(header.header, header.getHeaderLength());
 
-        if (buffer.GetRemainingSpace() < queued->size() + header.getHeaderLength())
-        {
-            QueuePacket(std::move(buffer));
-            buffer.Resize(_sendBufferSize);
-        }
-
-        if (buffer.GetRemainingSpace() >= queued->size() + header.getHeaderLength())
-        {
-            buffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                buffer.Write(queued->contents(), queued->size());
-        }
-        else    // single packet larger than 4096 bytes
-        {
-            MessageBuffer packetBuffer(queued->size() + header.getHeaderLength());
-            packetBuffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                packetBuffer.Write(queued->contents(), queued->size());
-
-            QueuePacket(std::move(packetBuffer));
-        }
+        // Only the header belongs to this socket, the payload may be shared with other receivers
+        QueuePacket(header.header, header.getHeaderLength(), queued->GetPacket(), packet.empty() ? nullptr : packet.contents(), packet.size());
 
         delete queued;
     }
 
-    if (buffer.GetActiveSize() > 0)
-        QueuePacket(std::move(buffer));
-
     if (!BaseSocket::Update())
         return false;
 
@@ -217,6 +196,7 @@ void WorldSocket::ReadHandler()
         // just received fresh new payload
         ReadDataHandlerResult result = ReadDataHandler();
         _headerBuffer.Reset();
+        _packetBuffer.Reset();
         if (result != ReadDataHandlerResult::Ok)
         {
             if (result != ReadDataHandlerResult::WaitingForQuery)
@@ -326,18 +306,17 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
     ClientPktHeader* header = reinterpret_cast<ClientPktHeader*>(_headerBuffer.GetReadPointer());
     OpcodeClient opcode = static_cast<OpcodeClient>(header->cmd);
 
-    WorldPacket packet(opcode, std::move(_packetBuffer));
-    WorldPacket* packetToQueue;
-
     if (sPacketLog->CanLogPacket())
-        sPacketLog->LogPacket(packet, CLIENT_TO_SERVER, GetRemoteIpAddress(), GetRemotePort());
+        sPacketLog->LogPacket(WorldPacket(opcode, MessageBuffer(_packetBuffer)), CLIENT_TO_SERVER, GetRemoteIpAddress(), GetRemotePort());
 
     std::unique_lock<std::mutex> sessionGuard(_worldSessionLock, std::defer_lock);
+    TimePoint receivedTime;
 
     switch (opcode)
     {
         case CMSG_PING:
         {
+            WorldPacket packet(opcode, std::move(_packetBuffer));
             LogOpcodeText(opcode, sessionGuard);
             try
             {
@@ -351,6 +330,7 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
         }
         case CMSG_AUTH_SESSION:
         {
+            WorldPacket packet(opcode, std::move(_packetBuffer));
             LogOpcodeText(opcode, sessionGuard);
             if (_authed)
             {
@@ -377,10 +357,9 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
                 _worldSession->ResetTimeOutTime(true);
             return ReadDataHandlerResult::Ok;
         case CMSG_TIME_SYNC_RESP:
-            packetToQueue = new WorldPacket(std::move(packet), GameTime::Now());
+            receivedTime = GameTime::Now();
             break;
         default:
-            packetToQueue = new WorldPacket(std::move(packet));
             break;
     }
 
@@ -391,23 +370,21 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
     if (!_worldSession)
     {
         LOG_ERROR("network.opcode", "ProcessIncoming: Client not authed opcode = {}", uint32(opcode));
-        delete packetToQueue;
         return ReadDataHandlerResult::Error;
     }
 
     OpcodeHandler const* handler = opcodeTable[opcode];
     if (!handler)
     {
-        LOG_ERROR("network.opcode", "No defined handler for opcode {} sent by {}", GetOpcodeNameForLogging(static_cast<OpcodeClient>(packet.GetOpcode())), _worldSession->GetPlayerInfo());
-        delete packetToQueue;
+        LOG_ERROR("network.opcode", "No defined handler for opcode {} sent by {}", GetOpcodeNameForLogging(opcode), _worldSession->GetPlayerInfo());
         return ReadDataHandlerResult::Error;
     }
 
     // Our Idle timer will reset on any non PING opcodes on login screen, allowing us to catch people idling.
     _worldSession->ResetTimeOutTime(false);
 
-    // Copy the packet to the heap before enqueuing
-    _worldSession->QueuePacket(packetToQueue);
+    // The payload is copied into a packet recycled by the session, _packetBuffer keeps its storage for the next one
+    _worldSession->QueuePacket(opcode, _packetBuffer.GetReadPointer(), _packetBuffer.GetActiveSize(), receivedTime);
 
     return ReadDataHandlerResult::Ok;
 }
@@ -432,14 +409,22 @@ void WorldSocket::SendPacketAndLogOpcode(WorldPacket const& packet)
 }
 
 void WorldSocket::SendPacket(WorldPacket const& packet)
+{
+    if (!IsOpen())
+        return;
+
+    SendPacket(std::make_shared<WorldPacket const>(packet));
+}
+
+void WorldSocket::SendPacket(SharedWorldPacket packet)
 {
     if (!IsOpen())
         return;
 
     if (sPacketLog->CanLogPacket())
-        sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+        sPacketLog->LogPacket(*packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
 
-    _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
+    _bufferQueue.Enqueue(new EncryptablePacket(std::move(packet), _authCrypt.IsInitialized()));
 }
 
 void WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
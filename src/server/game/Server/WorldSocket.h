@@ -29,19 +29,21 @@
 
 using boost::asio::ip::tcp;
 
-class EncryptablePacket : public WorldPacket
+class EncryptablePacket
 {
 public:
-    EncryptablePacket(WorldPacket const& packet, bool encrypt) : WorldPacket(packet), _encrypt(encrypt)
+    EncryptablePacket(SharedWorldPacket packet, bool encrypt) : _packet(std::move(packet)), _encrypt(encrypt)
     {
         SocketQueueLink.store(nullptr, std::memory_order_relaxed);
     }
 
+    SharedWorldPacket const& GetPacket() const { return _packet; }
     bool NeedsEncryption() const { return _encrypt; }
 
     std::atomic<EncryptablePacket*> SocketQueueLink;
 
 private:
+    SharedWorldPacket _packet;
     bool _encrypt;
 };
 
@@ -79,8 +81,7 @@ public:
     bool Update() override;
 
     void SendPacket(WorldPacket const& packet);
-
-    void SetSendBufferSize(std::size_t sendBufferSize) { _sendBufferSize = sendBufferSize; }
+    void SendPacket(SharedWorldPacket packet);
 
 protected:
     void OnClose() override;
@@ -126,7 +127,6 @@ private:
     MessageBuffer _headerBuffer;
     MessageBuffer _packetBuffer;
     MPSCQueue<EncryptablePacket, &EncryptablePacket::SocketQueueLink> _bufferQueue;
-    std::size_t _sendBufferSize;
 
     QueryCallbackProcessor _queryProcessor;
     std::string _ipCountry;
@@ -46,6 +46,7 @@
 #include "Player.h"
 #include "ScriptMgr.h"
 #include "SharedDefines.h"
+#include "SpellAreaTargetSnapshot.h"
 #include "SpellAuraEffects.h"
 #include "SpellInfo.h"
 #include "SpellMgr.h"
@@ -1221,9 +1222,20 @@ void Spell::SelectImplicitConeTargets(SpellEffIndex effIndex, SpellImplicitTarge
 
     if (uint32 containerTypeMask = GetSearcherTypeMask(objectType, condList))
     {
+        SpellAreaTargetSnapshot snapshot;
+        Warhead::SpellAreaTargetCollector collector(snapshot, containerTypeMask);
+        SearchTargets<Warhead::SpellAreaTargetCollector>(collector, containerTypeMask, m_caster, m_caster, radius);
+
+        snapshot.FilterRadius(*m_caster, radius);
+        if (m_spellInfo->HasAttribute(SPELL_ATTR0_CU_CONE_BACK))
+            snapshot.FilterArc(*m_caster, coneAngle, true);
+        else if (m_spellInfo->HasAttribute(SPELL_ATTR0_CU_CONE_LINE))
+            snapshot.FilterLine(*m_caster, m_caster->GetObjectSize());
+        else
+            snapshot.FilterArc(*m_caster, coneAngle, false);
+
         Warhead::WorldObjectSpellConeTargetCheck check(coneAngle, radius, m_caster, m_spellInfo, selectionType, condList);
-        Warhead::WorldObjectListSearcher<Warhead::WorldObjectSpellConeTargetCheck> searcher(m_caster, targets, check, containerTypeMask);
-        SearchTargets<Warhead::WorldObjectListSearcher<Warhead::WorldObjectSpellConeTargetCheck> >(searcher, containerTypeMask, m_caster, m_caster, radius);
+        snapshot.Select(targets, check);
 
         CallScriptObjectAreaTargetSelectHandlers(targets, effIndex, targetType);
 
@@ -1866,9 +1878,14 @@ void Spell::SelectImplicitTrajTargets(SpellEffIndex effIndex, SpellImplicitTarge
     // xinef: supply correct target type, DEST_DEST and similar are ALWAYS undefined
     // xinef: correct target is stored in TRIGGERED SPELL, however as far as i noticed, all checks are ENTRY, ENEMY
     std::list<WorldObject*> targets;
+    SpellAreaTargetSnapshot snapshot;
+    Warhead::SpellAreaTargetCollector collector(snapshot, GRID_MAP_TYPE_MASK_ALL);
+    SearchTargets<Warhead::SpellAreaTargetCollector>(collector, GRID_MAP_TYPE_MASK_ALL, m_caster, m_targets.GetSrcPos(), dist2d);
+    snapshot.FilterRadius(*m_targets.GetSrcPos(), dist2d);
+    snapshot.FilterLine(*m_caster, 0.0f);
+
     Warhead::WorldObjectSpellTrajTargetCheck check(dist2d, m_targets.GetSrcPos(), m_caster, m_spellInfo, TARGET_CHECK_ENEMY /*targetCheckType*/, m_spellInfo->Effects[effIndex].ImplicitTargetConditions);
-    Warhead::WorldObjectListSearcher<Warhead::WorldObjectSpellTrajTargetCheck> searcher(m_caster, targets, check, GRID_MAP_TYPE_MASK_ALL);
-    SearchTargets<Warhead::WorldObjectListSearcher<Warhead::WorldObjectSpellTrajTargetCheck> > (searcher, GRID_MAP_TYPE_MASK_ALL, m_caster, m_targets.GetSrcPos(), dist2d);
+    snapshot.Select(targets, check);
     if (targets.empty())
         return;
 
@@ -2176,9 +2193,13 @@ void Spell::SearchAreaTargets(std::list<WorldObject*>& targets, float range, Pos
     uint32 containerTypeMask = GetSearcherTypeMask(objectType, condList);
     if (!containerTypeMask)
         return;
+    SpellAreaTargetSnapshot snapshot;
+    Warhead::SpellAreaTargetCollector collector(snapshot, containerTypeMask);
+    SearchTargets<Warhead::SpellAreaTargetCollector>(collector, containerTypeMask, m_caster, position, range);
+    snapshot.FilterRadius(*position, range);
+
     Warhead::WorldObjectSpellAreaTargetCheck check(range, position, m_caster, referer, m_spellInfo, selectionType, condList);
-    Warhead::WorldObjectListSearcher<Warhead::WorldObjectSpellAreaTargetCheck> searcher(m_caster, targets, check, containerTypeMask);
-    SearchTargets<Warhead::WorldObjectListSearcher<Warhead::WorldObjectSpellAreaTargetCheck> > (searcher, containerTypeMask, m_caster, position, range);
+    snapshot.Select(targets, check);
 }
 
 void Spell::SearchChainTargets(std::list<WorldObject*>& targets, uint32 chainTargets, WorldObject* target, SpellTargetObjectTypes objectType, SpellTargetCheckTypes selectType, SpellTargetSelectionCategories  /*selectCategory*/, ConditionList* condList, bool isChainHeal)
@@ -8990,18 +9011,22 @@ namespace Warhead
 
     bool WorldObjectSpellAreaTargetCheck::operator()(WorldObject* target)
     {
-        if (target->GetTypeId() == TYPEID_GAMEOBJECT)
-        {
-            if (!target->ToGameObject()->IsInRange(_position->GetPositionX(), _position->GetPositionY(), _position->GetPositionZ(), _range))
-                return false;
-        }
-        else if (!target->IsWithinDist3d(_position, _range))
-            return false;
-        else if (target->GetTypeId() == TYPEID_UNIT && target->ToCreature()->IsAvoidingAOE()) // pussywizard
+        if (!IsInArea(target))
             return false;
         return WorldObjectSpellTargetCheck::operator ()(target);
     }
 
+    bool WorldObjectSpellAreaTargetCheck::IsInArea(WorldObject* target) const
+    {
+        if (target->GetTypeId() == TYPEID_GAMEOBJECT)
+            return target->ToGameObject()->IsInRange(_position->GetPositionX(), _position->GetPositionY(), _position->GetPositionZ(), _range);
+
+        if (!target->IsWithinDist3d(_position, _range))
+            return false;
+
+        return target->GetTypeId() != TYPEID_UNIT || !target->ToCreature()->IsAvoidingAOE(); // pussywizard
+    }
+
     WorldObjectSpellConeTargetCheck::WorldObjectSpellConeTargetCheck(float coneAngle, float range, Unit* caster,
             SpellInfo const* spellInfo, SpellTargetCheckTypes selectionType, ConditionList* condList)
         : WorldObjectSpellAreaTargetCheck(range, caster, caster, caster, spellInfo, selectionType, condList), _coneAngle(coneAngle)
@@ -9010,6 +9035,10 @@ namespace Warhead
 
     bool WorldObjectSpellConeTargetCheck::operator()(WorldObject* target)
     {
+        // most of the visited objects are out of range, reject them before the arc math
+        if (!IsInArea(target))
+            return false;
+
         if (_spellInfo->HasAttribute(SPELL_ATTR0_CU_CONE_BACK))
         {
             if (!_caster->isInBack(target, _coneAngle))
@@ -9025,7 +9054,7 @@ namespace Warhead
             if (!_caster->isInFront(target, _coneAngle))
                 return false;
         }
-        return WorldObjectSpellAreaTargetCheck::operator ()(target);
+        return WorldObjectSpellTargetCheck::operator ()(target);
     }
 
     WorldObjectSpellTrajTargetCheck::WorldObjectSpellTrajTargetCheck(float range, Position const* position, Unit* caster,
@@ -9036,10 +9065,13 @@ namespace Warhead
 
     bool WorldObjectSpellTrajTargetCheck::operator()(WorldObject* target)
     {
+        if (!IsInArea(target))
+            return false;
+
         // return all targets on missile trajectory (0 - size of a missile)
         if (!_caster->HasInLine(target, target->GetObjectSize()))
             return false;
-        return WorldObjectSpellAreaTargetCheck::operator ()(target);
+        return WorldObjectSpellTargetCheck::operator ()(target);
     }
 
 } //namespace Warhead
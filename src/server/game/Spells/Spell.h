@@ -822,6 +822,9 @@ namespace Warhead
         WorldObjectSpellAreaTargetCheck(float range, Position const* position, Unit* caster,
                                         Unit* referer, SpellInfo const* spellInfo, SpellTargetCheckTypes selectionType, ConditionList* condList);
         bool operator()(WorldObject* target);
+
+        // geometry only, checked before the expensive target checks
+        bool IsInArea(WorldObject* target) const;
     };
 
     struct WH_GAME_API WorldObjectSpellConeTargetCheck : public WorldObjectSpellAreaTargetCheck
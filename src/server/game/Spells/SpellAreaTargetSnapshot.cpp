@@ -0,0 +1,203 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "SpellAreaTargetSnapshot.h"
+#include "Corpse.h"
+#include "Creature.h"
+#include "DynamicObject.h"
+#include "GameObject.h"
+#include "Player.h"
+#include <cmath>
+
+namespace
+{
+    // Relative and absolute slack of the filters, they must never drop an object the exact check accepts
+    constexpr float FILTER_MARGIN = 0.001f;
+
+    inline float Widen(float distance)
+    {
+        return distance * (1.0f + FILTER_MARGIN) + FILTER_MARGIN;
+    }
+}
+
+void SpellAreaTargetSnapshot::Add(WorldObject* object)
+{
+    Add(object, object->GetPositionX(), object->GetPositionY(), object->GetPositionZ(), object->GetObjectSize(), object->GetTypeId() == TYPEID_GAMEOBJECT);
+}
+
+void SpellAreaTargetSnapshot::Add(WorldObject* object, float x, float y, float z, float size, bool ownRange)
+{
+    _x.push_back(x);
+    _y.push_back(y);
+    _z.push_back(z);
+    _size.push_back(size);
+    _ownRange.push_back(ownRange ? 1 : 0);
+    _candidates.push_back(1);
+    _objects.push_back(object);
+}
+
+void SpellAreaTargetSnapshot::FilterRadius(Position const& center, float range)
+{
+    float const centerX = center.GetPositionX();
+    float const centerY = center.GetPositionY();
+    float const centerZ = center.GetPositionZ();
+
+    // through raw pointers, the uint8 stores may alias the vectors themselves and would reload them on every object
+    float const* x = _x.data();
+    float const* y = _y.data();
+    float const* z = _z.data();
+    float const* size = _size.data();
+    uint8 const* ownRange = _ownRange.data();
+    uint8* candidates = _candidates.data();
+
+    std::size_t const count = _objects.size();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float const dx = x[i] - centerX;
+        float const dy = y[i] - centerY;
+        float const dz = z[i] - centerZ;
+        float const limit = Widen(range + size[i]);
+        uint8 const inRange = uint8(dx * dx + dy * dy + dz * dz <= limit * limit);
+        candidates[i] &= inRange | ownRange[i];
+    }
+}
+
+void SpellAreaTargetSnapshot::FilterArc(Position const& origin, float arc, bool back)
+{
+    // same arc as HasInArc, isInBack accepts what is out of the front arc 2 * pi - arc
+    float halfArc;
+    if (back)
+        halfArc = float(M_PI) - Position::NormalizeOrientation(2.0f * float(M_PI) - arc) / 2.0f;
+    else
+        halfArc = Position::NormalizeOrientation(arc) / 2.0f;
+
+    halfArc += FILTER_MARGIN;
+    if (halfArc >= float(M_PI))
+        return;
+
+    // the angle to the direction is at most halfArc while dot >= |d| * cos(halfArc), compared squared to skip the sqrt
+    float const directionX = std::cos(origin.GetOrientation()) * (back ? -1.0f : 1.0f);
+    float const directionY = std::sin(origin.GetOrientation()) * (back ? -1.0f : 1.0f);
+    float const cosArc = std::cos(halfArc);
+    float const cosArcSq = cosArc * cosArc;
+    float const originX = origin.GetPositionX();
+    float const originY = origin.GetPositionY();
+    float const* x = _x.data();
+    float const* y = _y.data();
+    uint8* candidates = _candidates.data();
+
+    std::size_t const count = _objects.size();
+    if (cosArc >= 0.0f)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            float const dx = x[i] - originX;
+            float const dy = y[i] - originY;
+            float const dot = directionX * dx + directionY * dy;
+            uint8 const inArc = uint8(dot >= 0.0f) & uint8(dot * dot >= cosArcSq * (dx * dx + dy * dy));
+            candidates[i] &= inArc;
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            float const dx = x[i] - originX;
+            float const dy = y[i] - originY;
+            float const dot = directionX * dx + directionY * dy;
+            uint8 const inArc = uint8(dot >= 0.0f) | uint8(dot * dot <= cosArcSq * (dx * dx + dy * dy));
+            candidates[i] &= inArc;
+        }
+    }
+}
+
+void SpellAreaTargetSnapshot::FilterLine(Position const& origin, float width)
+{
+    // HasInLine only accepts the half plane in front
+    FilterArc(origin, float(M_PI), false);
+
+    // |sin(angle)| * distance is the distance to the line, the cross product of the direction and the offset
+    float const directionX = std::cos(origin.GetOrientation());
+    float const directionY = std::sin(origin.GetOrientation());
+    float const originX = origin.GetPositionX();
+    float const originY = origin.GetPositionY();
+    float const* x = _x.data();
+    float const* y = _y.data();
+    float const* size = _size.data();
+    uint8* candidates = _candidates.data();
+
+    std::size_t const count = _objects.size();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float const dx = x[i] - originX;
+        float const dy = y[i] - originY;
+        float const cross = directionX * dy - directionY * dx;
+        uint8 const inLine = uint8(std::fabs(cross) <= Widen(width + size[i]));
+        candidates[i] &= inLine;
+    }
+}
+
+namespace Warhead
+{
+    void SpellAreaTargetCollector::Visit(PlayerMapType& m)
+    {
+        if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_PLAYER))
+            return;
+
+        for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+            i_snapshot.Add(itr->GetSource());
+    }
+
+    void SpellAreaTargetCollector::Visit(CreatureMapType& m)
+    {
+        if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_CREATURE))
+            return;
+
+        for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+            i_snapshot.Add(itr->GetSource());
+    }
+
+    void SpellAreaTargetCollector::Visit(CorpseMapType& m)
+    {
+        if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_CORPSE))
+            return;
+
+        for (CorpseMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+            i_snapshot.Add(itr->GetSource());
+    }
+
+    void SpellAreaTargetCollector::Visit(GameObjectMapType& m)
+    {
+        if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_GAMEOBJECT))
+            return;
+
+        for (GameObjectMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+            i_snapshot.Add(itr->GetSource());
+    }
+
+    void SpellAreaTargetCollector::Visit(DynamicObjectMapType& m)
+    {
+        if (!(i_mapTypeMask & GRID_MAP_TYPE_MASK_DYNAMICOBJECT))
+            return;
+
+        for (DynamicObjectMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+            i_snapshot.Add(itr->GetSource());
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPELL_AREA_TARGET_SNAPSHOT_H_
+#define SPELL_AREA_TARGET_SNAPSHOT_H_
+
+#include "Define.h"
+#include "GridDefines.h"
+#include <list>
+#include <vector>
+
+class Position;
+class WorldObject;
+
+// Positions of the objects visited by one spell area target search, one array per coordinate.
+// It is filled right before the query, so it can't go stale when the objects move. The filters run branch free
+// over the arrays so the compiler vectorizes them. They only drop the objects that are out of the area by more
+// than a rounding margin, the exact target check still runs on the rest and decides.
+class WH_GAME_API SpellAreaTargetSnapshot
+{
+public:
+    void Add(WorldObject* object);
+    // ownRange: not dropped by FilterRadius, the exact check has its own range test (gameobject model bounds)
+    void Add(WorldObject* object, float x, float y, float z, float size, bool ownRange);
+
+    // drops the objects whose bounding sphere is out of range of center, see WorldObject::IsWithinDist3d
+    void FilterRadius(Position const& center, float range);
+    // drops the objects out of the arc in front of origin (back: behind it), see WorldObject::isInFront and isInBack
+    void FilterArc(Position const& origin, float arc, bool back);
+    // drops the objects farther than width plus their size from the line in front of origin, see Position::HasInLine
+    void FilterLine(Position const& origin, float width);
+
+    // adds the objects left that pass check, in the order they were visited
+    template<class Check>
+    void Select(std::list<WorldObject*>& targets, Check& check) const
+    {
+        for (std::size_t i = 0; i < _objects.size(); ++i)
+            if (_candidates[i] && check(_objects[i]))
+                targets.push_back(_objects[i]);
+    }
+
+    [[nodiscard]] std::size_t GetSize() const { return _objects.size(); }
+    [[nodiscard]] bool IsCandidate(std::size_t index) const { return _candidates[index] != 0; }
+
+private:
+    std::vector<float> _x;
+    std::vector<float> _y;
+    std::vector<float> _z;
+    std::vector<float> _size;
+    std::vector<uint8> _ownRange;
+    std::vector<uint8> _candidates;
+    std::vector<WorldObject*> _objects;
+};
+
+namespace Warhead
+{
+    // Fills a SpellAreaTargetSnapshot with the objects of the visited cells, see WorldObjectListSearcher
+    struct WH_GAME_API SpellAreaTargetCollector
+    {
+        SpellAreaTargetSnapshot& i_snapshot;
+        uint32 i_mapTypeMask;
+
+        SpellAreaTargetCollector(SpellAreaTargetSnapshot& snapshot, uint32 mapTypeMask)
+            : i_snapshot(snapshot), i_mapTypeMask(mapTypeMask) { }
+
+        void Visit(PlayerMapType& m);
+        void Visit(CreatureMapType& m);
+        void Visit(CorpseMapType& m);
+        void Visit(GameObjectMapType& m);
+        void Visit(DynamicObjectMapType& m);
+
+        template<class NOT_INTERESTED> void Visit(GridRefMgr<NOT_INTERESTED>&) {}
+    };
+}
+
+#endif
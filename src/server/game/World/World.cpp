@@ -91,6 +91,7 @@
 #include "SmartAI.h"
 #include "SpellMgr.h"
 #include "StopWatch.h"
+#include "TaskGraph.h"
 #include "TaskScheduler.h"
 #include "TicketMgr.h"
 #include "Tokenize.h"
@@ -686,53 +687,107 @@ void World::SetInitialWorldSettings()
     LOG_INFO("server.loading", "Loading Instances...");
     sInstanceSaveMgr->LoadInstances();
 
-    LOG_INFO("server.loading", "Loading Game locale texts...");
-    sGameLocale->LoadAllLocales();
+    // Tables below only depend on the stores loaded above and on the explicit dependencies,
+    // so they are fetched and parsed in parallel when DBCache.LoadThreads is above 1
+    Warhead::TaskGraph loaders;
 
-    LOG_INFO("server", "Loading Page Texts...");
-    sObjectMgr->LoadPageTexts();
+    loaders.Add("GameLocale", []()
+    {
+        LOG_INFO("server.loading", "Loading Game locale texts...");
+        sGameLocale->LoadAllLocales();
+    });
 
-    LOG_INFO("server.loading", "Loading Game Object Templates...");         // must be after LoadPageTexts
-    sObjectMgr->LoadGameObjectTemplate();
+    auto pageTexts = loaders.Add("PageTexts", []()
+    {
+        LOG_INFO("server", "Loading Page Texts...");
+        sObjectMgr->LoadPageTexts();
+    });
 
-    LOG_INFO("server.loading", "Loading Game Object Template Addons...");
-    sObjectMgr->LoadGameObjectTemplateAddons();
+    auto gameObjectTemplates = loaders.Add("GameObjectTemplates", []()
+    {
+        LOG_INFO("server.loading", "Loading Game Object Templates...");
+        sObjectMgr->LoadGameObjectTemplate();
+    }, { pageTexts });
 
-    LOG_INFO("server.loading", "Loading Transport Templates...");
-    sTransportMgr->LoadTransportTemplates();
+    auto gameObjectTemplateAddons = loaders.Add("GameObjectTemplateAddons", []()
+    {
+        LOG_INFO("server.loading", "Loading Game Object Template Addons...");
+        sObjectMgr->LoadGameObjectTemplateAddons();
+    }, { gameObjectTemplates });
 
-    LOG_INFO("server.loading", "Loading Spell Required Data...");
-    sSpellMgr->LoadSpellRequired();
+    loaders.Add("TransportTemplates", []()
+    {
+        LOG_INFO("server.loading", "Loading Transport Templates...");
+        sTransportMgr->LoadTransportTemplates();
+    }, { gameObjectTemplateAddons });
 
-    LOG_INFO("server.loading", "Loading Spell Group Types...");
-    sSpellMgr->LoadSpellGroups();
+    loaders.Add("SpellRequired", []()
+    {
+        LOG_INFO("server.loading", "Loading Spell Required Data...");
+        sSpellMgr->LoadSpellRequired();
+    });
 
-    LOG_INFO("server.loading", "Loading Spell Learn Skills...");
-    sSpellMgr->LoadSpellLearnSkills();                           // must be after LoadSpellRanks
+    auto spellGroups = loaders.Add("SpellGroups", []()
+    {
+        LOG_INFO("server.loading", "Loading Spell Group Types...");
+        sSpellMgr->LoadSpellGroups();
+    });
 
-    LOG_INFO("server.loading", "Loading Spell Proc Event Conditions...");
-    sSpellMgr->LoadSpellProcEvents();
+    loaders.Add("SpellLearnSkills", []()
+    {
+        LOG_INFO("server.loading", "Loading Spell Learn Skills...");
+        sSpellMgr->LoadSpellLearnSkills();                       // must be after LoadSpellRanks
+    });
 
-    LOG_INFO("server.loading", "Loading Spell Proc Conditions and Data...");
-    sSpellMgr->LoadSpellProcs();
+    loaders.Add("SpellProcEvents", []()
+    {
+        LOG_INFO("server.loading", "Loading Spell Proc Event Conditions...");
+        sSpellMgr->LoadSpellProcEvents();
+    });
 
-    LOG_INFO("server.loading", "Loading Spell Bonus Data...");
-    sSpellMgr->LoadSpellBonuses();
+    loaders.Add("SpellProcs", []()
+    {
+        LOG_INFO("server.loading", "Loading Spell Proc Conditions and Data...");
+        sSpellMgr->LoadSpellProcs();
+    });
 
-    LOG_INFO("server.loading", "Loading Aggro Spells Definitions...");
-    sSpellMgr->LoadSpellThreats();
+    loaders.Add("SpellBonuses", []()
+    {
+        LOG_INFO("server.loading", "Loading Spell Bonus Data...");
+        sSpellMgr->LoadSpellBonuses();
+    });
 
-    LOG_INFO("server.loading", "Loading Mixology Bonuses...");
-    sSpellMgr->LoadSpellMixology();
+    loaders.Add("SpellThreats", []()
+    {
+        LOG_INFO("server.loading", "Loading Aggro Spells Definitions...");
+        sSpellMgr->LoadSpellThreats();
+    });
+
+    loaders.Add("SpellMixology", []()
+    {
+        LOG_INFO("server.loading", "Loading Mixology Bonuses...");
+        sSpellMgr->LoadSpellMixology();
+    });
+
+    loaders.Add("SpellGroupStackRules", []()
+    {
+        LOG_INFO("server.loading", "Loading Spell Group Stack Rules...");
+        sSpellMgr->LoadSpellGroupStackRules();
+    }, { spellGroups });
 
-    LOG_INFO("server.loading", "Loading Spell Group Stack Rules...");
-    sSpellMgr->LoadSpellGroupStackRules();
+    loaders.Add("GossipText", []()
+    {
+        LOG_INFO("server.loading", "Loading NPC Texts...");
+        sObjectMgr->LoadGossipText();
+    });
 
-    LOG_INFO("server.loading", "Loading NPC Texts...");
-    sObjectMgr->LoadGossipText();
+    loaders.Add("SpellEnchantProcData", []()
+    {
+        LOG_INFO("server.loading", "Loading Enchant Spells Proc Datas...");
+        sSpellMgr->LoadSpellEnchantProcData();
+    });
 
-    LOG_INFO("server.loading", "Loading Enchant Spells Proc Datas...");
-    sSpellMgr->LoadSpellEnchantProcData();
+    loaders.Run(std::max<int32>(1, CONF_GET_INT("DBCache.LoadThreads")));
 
     LOG_INFO("server.loading", "Loading Item Random Enchantments Table...");
     LoadRandomEnchantmentsTable();
@@ -1213,6 +1268,8 @@ void World::SetInitialWorldSettings()
     sAsyncAuctionMgr->Initialize();
     sAuctionBot->Initialize();
 
+    sDBCacheMgr->FinishLoading();
+
     auto elapsed = sw.Elapsed();
     std::string startupDuration = Warhead::Time::ToTimeString(elapsed, sw.GetOutCount());
 
@@ -1363,7 +1420,7 @@ void World::Update(uint32 diff)
     }
 
     {
-        std::lock_guard<std::mutex> guard(sAsyncAuctionMgr->GetLock());
+        std::lock_guard<AsyncAuctionMgr::SharedMutex> guard(sAsyncAuctionMgr->GetLock());
 
         // pussywizard: handle auctions when the timer has passed
         if (m_timers[WUPDATE_AUCTIONS].Passed())
@@ -1547,6 +1604,8 @@ void World::ForceGameEventUpdate()
 /// Send a packet to all players (except self if mentioned)
 void World::SendGlobalMessage(WorldPacket const* packet, WorldSession* self, TeamId teamId)
 {
+    SharedWorldPacket sharedPacket = std::make_shared<WorldPacket const>(*packet);
+
     SessionMap::const_iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -1556,7 +1615,7 @@ void World::SendGlobalMessage(WorldPacket const* packet, WorldSession* self, Tea
                 itr->second != self &&
                 (teamId == TEAM_NEUTRAL || itr->second->GetPlayer()->GetTeamId() == teamId))
         {
-            itr->second->SendPacket(packet);
+            itr->second->SendPacket(sharedPacket);
         }
     }
 }
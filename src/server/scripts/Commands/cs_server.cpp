@@ -31,7 +31,10 @@
 #include "GameConfig.h"
 #include "GameTime.h"
 #include "GitRevision.h"
+#include "GridMapStore.h"
 #include "Language.h"
+#include "MapMgr.h"
+#include "MapUpdater.h"
 #include "ModuleMgr.h"
 #include "Player.h"
 #include "Realm.h"
@@ -255,6 +258,15 @@ public:
         handler->PSendSysMessage(LANG_UPTIME, uptime);
         handler->PSendSysMessage("Update time diff: {}ms, Average: {}ms", sWorldUpdateTime.GetLastUpdateTime(), sWorldUpdateTime.GetAverageUpdateTime());
 
+        if (MapUpdater* mapUpdater = sMapMgr->GetMapUpdater(); mapUpdater && mapUpdater->IsActive())
+        {
+            auto const& stats = mapUpdater->GetLastTickStats();
+            handler->PSendSysMessage("Map update: {} requests, {} stolen. Elapsed: {}, critical path: {}, threads idle: {}",
+                stats.Requests, stats.Steals, Warhead::Time::ToTimeString(stats.Elapsed), Warhead::Time::ToTimeString(stats.CriticalPath), Warhead::Time::ToTimeString(stats.Idle));
+        }
+
+        handler->PSendSysMessage("Terrain: {} grids mapped, {} KB", sGridMapStore->GetLoadedCount(), sGridMapStore->GetMappedSize() / 1024);
+
         //! Can't use sWorld->ShutdownMsg here in case of console command
         if (sWorld->IsShuttingDown())
             handler->PSendSysMessage(LANG_SHUTDOWN_TIMELEFT, Warhead::Time::ToTimeString(sWorld->GetShutDownTimeLeft()));
@@ -18,14 +18,18 @@
 #ifndef __SOCKET_H__
 #define __SOCKET_H__
 
+#include "Errors.h"
 #include "Log.h"
 #include "MessageBuffer.h"
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <boost/asio/ip/tcp.hpp>
+#include <deque>
 #include <functional>
 #include <memory>
-#include <queue>
 #include <type_traits>
+#include <vector>
 
 using boost::asio::ip::tcp;
 
@@ -34,14 +38,91 @@ using boost::asio::ip::tcp;
 #define WH_SOCKET_USE_IOCP
 #endif
 
+// Max number of buffers handed to one (vectored) write call
+#define WRITE_GATHER_BUFFERS 64
+
+// Queued outgoing data. Either an owned buffer, or a small header followed by a payload that is
+// shared with other sockets - a broadcast payload is referenced by every receiver, never copied
+class SocketWriteEntry
+{
+public:
+    explicit SocketWriteEntry(MessageBuffer&& buffer) : _buffer(std::move(buffer)) { }
+
+    SocketWriteEntry(uint8 const* header, std::size_t headerSize, std::shared_ptr<void const> payloadOwner, uint8 const* payload, std::size_t payloadSize)
+        : _buffer(0), _headerSize(headerSize), _payloadOwner(std::move(payloadOwner)), _payload(payload), _payloadSize(payloadSize)
+    {
+        ASSERT(headerSize <= _header.size());
+        std::copy_n(header, headerSize, _header.begin());
+    }
+
+    // Appends the unsent parts, returns their size
+    std::size_t Gather(std::vector<boost::asio::const_buffer>& buffers)
+    {
+        std::size_t size = 0;
+
+        if (std::size_t bufferSize = _buffer.GetActiveSize())
+        {
+            buffers.emplace_back(_buffer.GetReadPointer(), bufferSize);
+            size += bufferSize;
+        }
+
+        if (_headerPos < _headerSize)
+        {
+            buffers.emplace_back(_header.data() + _headerPos, _headerSize - _headerPos);
+            size += _headerSize - _headerPos;
+        }
+
+        if (_payloadPos < _payloadSize)
+        {
+            buffers.emplace_back(_payload + _payloadPos, _payloadSize - _payloadPos);
+            size += _payloadSize - _payloadPos;
+        }
+
+        return size;
+    }
+
+    // Marks up to bytes as sent, returns the bytes which belong to the following entries
+    std::size_t Consume(std::size_t bytes)
+    {
+        std::size_t bufferBytes = std::min(bytes, std::size_t(_buffer.GetActiveSize()));
+        _buffer.ReadCompleted(bufferBytes);
+        bytes -= bufferBytes;
+
+        std::size_t headerBytes = std::min(bytes, _headerSize - _headerPos);
+        _headerPos += headerBytes;
+        bytes -= headerBytes;
+
+        std::size_t payloadBytes = std::min(bytes, _payloadSize - _payloadPos);
+        _payloadPos += payloadBytes;
+        return bytes - payloadBytes;
+    }
+
+    bool IsSent() const { return !_buffer.GetActiveSize() && _headerPos == _headerSize && _payloadPos == _payloadSize; }
+
+    static constexpr std::size_t MAX_BUFFERS = 3;
+
+private:
+    MessageBuffer _buffer;
+
+    std::array<uint8, 8> _header{};
+    std::size_t _headerSize{};
+    std::size_t _headerPos{};
+
+    std::shared_ptr<void const> _payloadOwner;
+    uint8 const* _payload{};
+    std::size_t _payloadSize{};
+    std::size_t _payloadPos{};
+};
+
 template<class T>
 class Socket : public std::enable_shared_from_this<T>
 {
 public:
     explicit Socket(tcp::socket&& socket) : _socket(std::move(socket)), _remoteAddress(_socket.remote_endpoint().address()),
-        _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _closed(false), _closing(false), _isWritingAsync(false)
+        _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _sendBufferSize(65536), _closed(false), _closing(false), _isWritingAsync(false)
     {
         _readBuffer.Resize(READ_BLOCK_SIZE);
+        _gatherBuffers.reserve(WRITE_GATHER_BUFFERS);
     }
 
     virtual ~Socket()
@@ -103,13 +184,26 @@ public:
 
     void QueuePacket(MessageBuffer&& buffer)
     {
-        _writeQueue.push(std::move(buffer));
+        _writeQueue.emplace_back(std::move(buffer));
 
 #ifdef WH_SOCKET_USE_IOCP
         AsyncProcessQueue();
 #endif
     }
 
+    // The payload isn't copied, payloadOwner keeps it alive until it is sent
+    void QueuePacket(uint8 const* header, std::size_t headerSize, std::shared_ptr<void const> payloadOwner, uint8 const* payload, std::size_t payloadSize)
+    {
+        _writeQueue.emplace_back(header, headerSize, std::move(payloadOwner), payload, payloadSize);
+
+#ifdef WH_SOCKET_USE_IOCP
+        AsyncProcessQueue();
+#endif
+    }
+
+    /// Max amount of queued bytes handed to one write call
+    void SetSendBufferSize(std::size_t sendBufferSize) { _sendBufferSize = sendBufferSize; }
+
     bool IsOpen() const { return !_closed && !_closing; }
 
     void CloseSocket()
@@ -144,8 +238,8 @@ protected:
         _isWritingAsync = true;
 
 #ifdef WH_SOCKET_USE_IOCP
-        MessageBuffer& buffer = _writeQueue.front();
-        _socket.async_write_some(boost::asio::buffer(buffer.GetReadPointer(), buffer.GetActiveSize()), std::bind(&Socket<T>::WriteHandler,
+        GatherQueue();
+        _socket.async_write_some(_gatherBuffers, std::bind(&Socket<T>::WriteHandler,
             this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
 #else
         _socket.async_write_some(boost::asio::null_buffers(), std::bind(&Socket<T>::WriteHandlerWrapper,
@@ -166,6 +260,36 @@ protected:
     }
 
 private:
+    // Collects the unsent parts of the queued messages for one vectored write, returns their size
+    std::size_t GatherQueue()
+    {
+        _gatherBuffers.clear();
+
+        std::size_t bytes = 0;
+        for (auto itr = _writeQueue.begin(); itr != _writeQueue.end() && bytes < _sendBufferSize; ++itr)
+        {
+            if (_gatherBuffers.size() + SocketWriteEntry::MAX_BUFFERS > WRITE_GATHER_BUFFERS)
+                break;
+
+            bytes += itr->Gather(_gatherBuffers);
+        }
+
+        return bytes;
+    }
+
+    // Drops the fully sent messages, the first unsent one keeps its position
+    void ConsumeQueue(std::size_t bytes)
+    {
+        while (!_writeQueue.empty())
+        {
+            bytes = _writeQueue.front().Consume(bytes);
+            if (!_writeQueue.front().IsSent())
+                break;
+
+            _writeQueue.pop_front();
+        }
+    }
+
     void ReadHandlerInternal(boost::system::error_code error, size_t transferredBytes)
     {
         if (error)
@@ -185,10 +309,7 @@ private:
         if (!error)
         {
             _isWritingAsync = false;
-            _writeQueue.front().ReadCompleted(transferedBytes);
-
-            if (!_writeQueue.front().GetActiveSize())
-                _writeQueue.pop();
+            ConsumeQueue(transferedBytes);
 
             if (!_writeQueue.empty())
                 AsyncProcessQueue();
@@ -212,19 +333,17 @@ private:
         if (_writeQueue.empty())
             return false;
 
-        MessageBuffer& queuedMessage = _writeQueue.front();
-
-        std::size_t bytesToSend = queuedMessage.GetActiveSize();
+        std::size_t bytesToSend = GatherQueue();
 
         boost::system::error_code error;
-        std::size_t bytesSent = _socket.write_some(boost::asio::buffer(queuedMessage.GetReadPointer(), bytesToSend), error);
+        std::size_t bytesSent = _socket.write_some(_gatherBuffers, error);
 
         if (error)
         {
             if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
                 return AsyncProcessQueue();
 
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
 
@@ -232,19 +351,18 @@ private:
         }
         else if (bytesSent == 0)
         {
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
 
             return false;
         }
-        else if (bytesSent < bytesToSend) // now n > 0
-        {
-            queuedMessage.ReadCompleted(bytesSent);
+
+        ConsumeQueue(bytesSent);
+
+        if (bytesSent < bytesToSend) // now n > 0
             return AsyncProcessQueue();
-        }
 
-        _writeQueue.pop();
         if (_closing && _writeQueue.empty())
             CloseSocket();
 
@@ -259,7 +377,9 @@ private:
     uint16 _remotePort;
 
     MessageBuffer _readBuffer;
-    std::queue<MessageBuffer> _writeQueue;
+    std::deque<SocketWriteEntry> _writeQueue;
+    std::vector<boost::asio::const_buffer> _gatherBuffers;
+    std::size_t _sendBufferSize;
 
     std::atomic<bool> _closed;
     std::atomic<bool> _closing;
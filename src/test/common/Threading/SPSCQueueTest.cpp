@@ -0,0 +1,148 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SPSCQueue.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <thread>
+
+TEST(SPSCQueueTest, FirstInFirstOut)
+{
+    SPSCQueue<int, 8> queue;
+    int value = 0;
+
+    EXPECT_FALSE(queue.Dequeue(value));
+    EXPECT_EQ(queue.Peek(), nullptr);
+
+    for (int i = 1; i <= 5; ++i)
+        EXPECT_TRUE(queue.Enqueue(i));
+
+    EXPECT_EQ(queue.Size(), 5u);
+
+    for (int i = 1; i <= 5; ++i)
+    {
+        ASSERT_TRUE(queue.Dequeue(value));
+        EXPECT_EQ(value, i);
+    }
+
+    EXPECT_FALSE(queue.Dequeue(value));
+    EXPECT_EQ(queue.Size(), 0u);
+}
+
+TEST(SPSCQueueTest, Full)
+{
+    SPSCQueue<int, 4> queue;
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(queue.Enqueue(i));
+
+    EXPECT_FALSE(queue.Enqueue(4));
+    EXPECT_EQ(queue.Size(), 4u);
+
+    // the failed element didn't take a slot, the freed one is usable again
+    int value = -1;
+    ASSERT_TRUE(queue.Dequeue(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(queue.Enqueue(5));
+    EXPECT_FALSE(queue.Enqueue(6));
+
+    for (int expected : { 1, 2, 3, 5 })
+    {
+        ASSERT_TRUE(queue.Dequeue(value));
+        EXPECT_EQ(value, expected);
+    }
+
+    EXPECT_FALSE(queue.Dequeue(value));
+}
+
+TEST(SPSCQueueTest, Wraparound)
+{
+    SPSCQueue<int, 4> queue;
+    int next = 0;
+    int expected = 0;
+
+    // the indices run far past the capacity, every round starts at another slot
+    for (int round = 0; round < 100; ++round)
+    {
+        for (int i = 0; i < 3; ++i)
+            ASSERT_TRUE(queue.Enqueue(next++));
+
+        ASSERT_EQ(queue.Size(), 3u);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            int value = -1;
+            ASSERT_TRUE(queue.Dequeue(value));
+            ASSERT_EQ(value, expected++);
+        }
+    }
+
+    // filling up to the capacity after the wraparound
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(queue.Enqueue(next++));
+    EXPECT_FALSE(queue.Enqueue(next));
+}
+
+TEST(SPSCQueueTest, PeekKeepsFront)
+{
+    SPSCQueue<std::unique_ptr<int>, 4> queue;
+    queue.Enqueue(std::make_unique<int>(1));
+    queue.Enqueue(std::make_unique<int>(2));
+
+    std::unique_ptr<int>* front = queue.Peek();
+    ASSERT_NE(front, nullptr);
+    EXPECT_EQ(**front, 1);
+    EXPECT_EQ(queue.Peek(), front);
+
+    queue.Pop();
+    front = queue.Peek();
+    ASSERT_NE(front, nullptr);
+    EXPECT_EQ(**front, 2);
+}
+
+TEST(SPSCQueueTest, ProducerAndConsumerThreads)
+{
+    constexpr int COUNT = 200000;
+    SPSCQueue<int, 64> queue;
+
+    std::thread producer([&queue]()
+    {
+        for (int i = 0; i < COUNT;)
+            if (queue.Enqueue(i))
+                ++i;
+            else
+                std::this_thread::yield();
+    });
+
+    // keeps consuming on a mismatch, the producer must be joined
+    bool ordered = true;
+    for (int expected = 0; expected < COUNT;)
+    {
+        int value = -1;
+        if (!queue.Dequeue(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ordered &= value == expected;
+        ++expected;
+    }
+
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(queue.Size(), 0u);
+}
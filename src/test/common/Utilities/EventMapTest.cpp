@@ -0,0 +1,563 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EventMap.h"
+#include "EventProcessor.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // The former multimap based EventMap, kept as the reference for the randomized comparison
+    class LegacyEventMap
+    {
+    public:
+        void Update(uint32 time) { _time += time; }
+        [[nodiscard]] uint32 GetTimer() const { return _time; }
+        [[nodiscard]] bool Empty() const { return _eventMap.empty(); }
+        [[nodiscard]] uint8 GetPhaseMask() const { return _phase; }
+
+        void SetPhase(uint8 phase)
+        {
+            if (!phase)
+                _phase = 0;
+            else if (phase <= 8)
+                _phase = (1 << (phase - 1));
+        }
+
+        void AddPhase(uint8 phase)
+        {
+            if (phase && phase <= 8)
+                _phase |= (1 << (phase - 1));
+        }
+
+        void RemovePhase(uint8 phase)
+        {
+            if (phase && phase <= 8)
+                _phase &= ~(1 << (phase - 1));
+        }
+
+        void ScheduleEvent(uint32 eventId, uint32 time, uint32 group = 0, uint32 phase = 0)
+        {
+            if (group && group <= 8)
+                eventId |= (1 << (group + 15));
+
+            if (phase && phase <= 8)
+                eventId |= (1 << (phase + 23));
+
+            _eventMap.emplace(_time + time, eventId);
+        }
+
+        void RescheduleEvent(uint32 eventId, uint32 time, uint32 group = 0, uint32 phase = 0)
+        {
+            CancelEvent(eventId);
+            ScheduleEvent(eventId, time, group, phase);
+        }
+
+        void RepeatEvent(uint32 time) { _eventMap.emplace(_time + time, _lastEvent); }
+
+        uint32 ExecuteEvent()
+        {
+            while (!Empty())
+            {
+                auto itr = _eventMap.begin();
+
+                if (itr->first > _time)
+                    return 0;
+                else if (_phase && (itr->second & 0xFF000000) && !((itr->second >> 24) & _phase))
+                    _eventMap.erase(itr);
+                else
+                {
+                    uint32 eventId = (itr->second & 0x0000FFFF);
+                    _lastEvent = itr->second;
+                    _eventMap.erase(itr);
+                    return eventId;
+                }
+            }
+
+            return 0;
+        }
+
+        void DelayEvents(uint32 delay) { _time = delay < _time ? _time - delay : 0; }
+
+        void DelayEvents(uint32 delay, uint32 group)
+        {
+            if (group > 8 || Empty())
+                return;
+
+            EventStore delayed;
+            for (auto itr = _eventMap.begin(); itr != _eventMap.end();)
+            {
+                if (!group || (itr->second & (1 << (group + 15))))
+                {
+                    delayed.insert(EventStore::value_type(itr->first + delay, itr->second));
+                    itr = _eventMap.erase(itr);
+                    continue;
+                }
+
+                ++itr;
+            }
+
+            _eventMap.insert(delayed.begin(), delayed.end());
+        }
+
+        void DelayEventsToMax(uint32 delay, uint32 group)
+        {
+            for (auto itr = _eventMap.begin(); itr != _eventMap.end();)
+            {
+                if (itr->first < _time + delay && (group == 0 || ((1 << (group + 15)) & itr->second)))
+                {
+                    ScheduleEvent(itr->second, delay);
+                    _eventMap.erase(itr);
+                    itr = _eventMap.begin();
+                    continue;
+                }
+
+                ++itr;
+            }
+        }
+
+        void CancelEvent(uint32 eventId)
+        {
+            for (auto itr = _eventMap.begin(); itr != _eventMap.end();)
+            {
+                if (eventId == (itr->second & 0x0000FFFF))
+                {
+                    itr = _eventMap.erase(itr);
+                    continue;
+                }
+
+                ++itr;
+            }
+        }
+
+        void CancelEventGroup(uint32 group)
+        {
+            if (!group || group > 8)
+                return;
+
+            uint32 groupMask = (1 << (group + 15));
+            for (auto itr = _eventMap.begin(); itr != _eventMap.end();)
+            {
+                if (itr->second & groupMask)
+                {
+                    itr = _eventMap.erase(itr);
+                    continue;
+                }
+
+                ++itr;
+            }
+        }
+
+        [[nodiscard]] uint32 GetNextEventTime(uint32 eventId) const
+        {
+            for (auto const& itr : _eventMap)
+                if (eventId == (itr.second & 0x0000FFFF))
+                    return itr.first;
+
+            return 0;
+        }
+
+        [[nodiscard]] uint32 GetNextEventTime() const { return Empty() ? 0 : _eventMap.begin()->first; }
+
+        [[nodiscard]] Milliseconds GetTimeUntilEvent(uint32 eventId) const
+        {
+            for (auto const& itr : _eventMap)
+                if (eventId == (itr.second & 0x0000FFFF))
+                    return Milliseconds(itr.first) - Milliseconds(_time);
+
+            return Milliseconds::max();
+        }
+
+    private:
+        typedef std::multimap<uint32, uint32> EventStore;
+
+        uint32 _time{ 0 };
+        uint32 _phase{ 0 };
+        uint32 _lastEvent{ 0 };
+        EventStore _eventMap;
+    };
+
+    // Executes every due event, the order matters as much as the ids
+    template<class Map>
+    std::vector<uint32> ExecuteAll(Map& events)
+    {
+        std::vector<uint32> executed;
+        while (uint32 eventId = events.ExecuteEvent())
+            executed.push_back(eventId);
+
+        return executed;
+    }
+
+    struct TestEvent : public BasicEvent
+    {
+        TestEvent(std::vector<uint32>& log, uint32 id, bool deletable = true) : Log(log), Id(id), Deletable(deletable) { ++Alive; }
+        ~TestEvent() override { --Alive; }
+
+        bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+        {
+            Log.push_back(Id);
+            return true;
+        }
+
+        [[nodiscard]] bool IsDeletable() const override { return Deletable; }
+        void Abort(uint64 /*e_time*/) override { ++Aborted; }
+
+        std::vector<uint32>& Log;
+        uint32 Id;
+        bool Deletable;
+
+        static inline int32 Alive = 0;
+        static inline int32 Aborted = 0;
+    };
+}
+
+TEST(EventMapTest, ExecutesInTimeThenScheduleOrder)
+{
+    EventMap events;
+    events.ScheduleEvent(1, 200);
+    events.ScheduleEvent(2, 100);
+    events.ScheduleEvent(3, 100);
+    events.ScheduleEvent(4, 100);
+
+    EXPECT_EQ(events.GetNextEventTime(), 100u);
+    EXPECT_EQ(events.ExecuteEvent(), 0u);
+
+    events.Update(150);
+    EXPECT_EQ(ExecuteAll(events), (std::vector<uint32>{ 2, 3, 4 }));
+
+    events.Update(50);
+    EXPECT_EQ(ExecuteAll(events), (std::vector<uint32>{ 1 }));
+    EXPECT_TRUE(events.Empty());
+}
+
+TEST(EventMapTest, Delay)
+{
+    EventMap events;
+    events.ScheduleEvent(1, 100, 1);
+    events.ScheduleEvent(2, 100, 2);
+    events.ScheduleEvent(3, 300);
+
+    events.DelayEvents(50, 1);
+    EXPECT_EQ(events.GetNextEventTime(1), 150u);
+    EXPECT_EQ(events.GetNextEventTime(2), 100u);
+
+    events.Update(100);
+    EXPECT_EQ(ExecuteAll(events), (std::vector<uint32>{ 2 }));
+
+    // delaying everything moves the timer back
+    events.DelayEvents(100);
+    EXPECT_EQ(events.GetTimer(), 0u);
+    EXPECT_EQ(events.GetTimeUntilEvent(1), 150ms);
+
+    events.DelayEventsToMax(400, 0);
+    EXPECT_EQ(events.GetNextEventTime(1), 400u);
+    EXPECT_EQ(events.GetNextEventTime(3), 400u);
+
+    events.Update(400);
+    EXPECT_EQ(ExecuteAll(events), (std::vector<uint32>{ 1, 3 }));
+}
+
+TEST(EventMapTest, DelayToMaxOfGroup)
+{
+    EventMap events;
+    events.ScheduleEvent(1, 100, 1);
+    events.ScheduleEvent(2, 100, 2);
+    events.ScheduleEvent(3, 500, 1);
+
+    events.DelayEventsToMax(300, 1);
+    EXPECT_EQ(events.GetNextEventTime(1), 300u);
+    EXPECT_EQ(events.GetNextEventTime(2), 100u);
+    EXPECT_EQ(events.GetNextEventTime(3), 500u);
+}
+
+TEST(EventMapTest, Cancel)
+{
+    EventMap events;
+    events.ScheduleEvent(1, 100, 1);
+    events.ScheduleEvent(1, 200);
+    events.ScheduleEvent(2, 100, 1);
+    events.ScheduleEvent(3, 100, 2);
+
+    events.CancelEvent(1);
+    EXPECT_EQ(events.GetNextEventTime(1), 0u);
+    EXPECT_EQ(events.GetTimeUntilEvent(1), Milliseconds::max());
+
+    events.CancelEventGroup(1);
+    events.Update(200);
+    EXPECT_EQ(ExecuteAll(events), (std::vector<uint32>{ 3 }));
+}
+
+TEST(EventMapTest, Repeat)
+{
+    EventMap events;
+    events.ScheduleEvent(1, 100, 2, 3);
+
+    events.Update(100);
+    EXPECT_EQ(events.ExecuteEvent(), 1u);
+
+    // the repeated event keeps its group and phase
+    events.RepeatEvent(100);
+    events.CancelEventGroup(2);
+    EXPECT_TRUE(events.Empty());
+
+    events.ScheduleEvent(2, 0);
+    EXPECT_EQ(events.ExecuteEvent(), 2u);
+    events.Repeat(50ms);
+    EXPECT_EQ(events.GetTimeUntilEvent(2), 50ms);
+}
+
+TEST(EventMapTest, Phase)
+{
+    EventMap events;
+    events.SetPhase(1);
+    events.ScheduleEvent(1, 100, 0, 1);
+    events.ScheduleEvent(2, 100, 0, 2);
+    events.ScheduleEvent(3, 100);
+
+    EXPECT_TRUE(events.IsInPhase(1));
+    EXPECT_FALSE(events.IsInPhase(2));
+
+    // events of other phases are dropped when they are due
+    events.Update(100);
+    EXPECT_EQ(ExecuteAll(events), (std::vector<uint32>{ 1, 3 }));
+    EXPECT_TRUE(events.Empty());
+
+    events.AddPhase(2);
+    EXPECT_EQ(events.GetPhaseMask(), 3);
+    events.RemovePhase(1);
+    EXPECT_EQ(events.GetPhaseMask(), 2);
+}
+
+TEST(EventMapTest, MatchesLegacyEventMap)
+{
+    std::mt19937 random(42);
+    auto roll = [&random](uint32 max) { return uint32(random() % (max + 1)); };
+
+    for (uint32 run = 0; run < 50; ++run)
+    {
+        EventMap events;
+        LegacyEventMap legacy;
+        bool canRepeat = false;
+
+        for (uint32 step = 0; step < 2000; ++step)
+        {
+            uint32 eventId = roll(9) + 1;
+            uint32 group = roll(3);
+
+            switch (roll(12))
+            {
+                case 0:
+                case 1:
+                case 2:
+                {
+                    uint32 time = roll(4) * 250;
+                    uint32 phase = roll(3);
+                    events.ScheduleEvent(eventId, time, group, phase);
+                    legacy.ScheduleEvent(eventId, time, group, phase);
+                    break;
+                }
+                case 3:
+                {
+                    uint32 time = roll(1000);
+                    events.RescheduleEvent(eventId, time, group);
+                    legacy.RescheduleEvent(eventId, time, group);
+                    break;
+                }
+                case 4:
+                {
+                    uint32 diff = roll(600);
+                    events.Update(diff);
+                    legacy.Update(diff);
+                    break;
+                }
+                case 5:
+                {
+                    uint32 executed = events.ExecuteEvent();
+                    ASSERT_EQ(executed, legacy.ExecuteEvent());
+                    canRepeat = executed != 0;
+                    break;
+                }
+                case 6:
+                    if (canRepeat)
+                    {
+                        uint32 time = roll(500);
+                        events.RepeatEvent(time);
+                        legacy.RepeatEvent(time);
+                        canRepeat = false;
+                    }
+                    break;
+                case 7:
+                {
+                    uint32 delay = roll(300);
+                    if (roll(1))
+                    {
+                        events.DelayEvents(delay);
+                        legacy.DelayEvents(delay);
+                    }
+                    else
+                    {
+                        events.DelayEvents(delay, group);
+                        legacy.DelayEvents(delay, group);
+                    }
+                    break;
+                }
+                case 8:
+                {
+                    uint32 delay = roll(800);
+                    events.DelayEventsToMax(delay, group);
+                    legacy.DelayEventsToMax(delay, group);
+                    break;
+                }
+                case 9:
+                    events.CancelEvent(eventId);
+                    legacy.CancelEvent(eventId);
+                    break;
+                case 10:
+                    events.CancelEventGroup(group);
+                    legacy.CancelEventGroup(group);
+                    break;
+                case 11:
+                {
+                    uint8 phase = roll(3);
+                    switch (roll(2))
+                    {
+                        case 0: events.SetPhase(phase); legacy.SetPhase(phase); break;
+                        case 1: events.AddPhase(phase); legacy.AddPhase(phase); break;
+                        default: events.RemovePhase(phase); legacy.RemovePhase(phase); break;
+                    }
+                    break;
+                }
+                default:
+                    ASSERT_EQ(ExecuteAll(events), ExecuteAll(legacy));
+                    canRepeat = false;
+                    break;
+            }
+
+            ASSERT_EQ(events.Empty(), legacy.Empty());
+            ASSERT_EQ(events.GetTimer(), legacy.GetTimer());
+            ASSERT_EQ(events.GetPhaseMask(), legacy.GetPhaseMask());
+            ASSERT_EQ(events.GetNextEventTime(), legacy.GetNextEventTime());
+            ASSERT_EQ(events.GetNextEventTime(eventId), legacy.GetNextEventTime(eventId));
+            ASSERT_EQ(events.GetTimeUntilEvent(eventId), legacy.GetTimeUntilEvent(eventId));
+        }
+
+        ASSERT_EQ(ExecuteAll(events), ExecuteAll(legacy));
+    }
+}
+
+TEST(EventProcessorTest, ExecutesInTimeThenAddOrder)
+{
+    std::vector<uint32> log;
+    {
+        EventProcessor events;
+        events.AddEventAtOffset(new TestEvent(log, 1), 200ms);
+        events.AddEventAtOffset(new TestEvent(log, 2), 100ms);
+        events.AddEventAtOffset(new TestEvent(log, 3), 100ms);
+        events.AddEventAtOffset([&log]() { log.push_back(4); }, 100ms);
+
+        events.Update(99);
+        EXPECT_TRUE(log.empty());
+
+        events.Update(1);
+        EXPECT_EQ(log, (std::vector<uint32>{ 2, 3, 4 }));
+
+        events.Update(100);
+        EXPECT_EQ(log, (std::vector<uint32>{ 2, 3, 4, 1 }));
+    }
+
+    EXPECT_EQ(TestEvent::Alive, 0);
+}
+
+TEST(EventProcessorTest, ModifyEventTime)
+{
+    std::vector<uint32> log;
+    EventProcessor events;
+
+    TestEvent* late = new TestEvent(log, 1);
+    events.AddEventAtOffset(late, 500ms);
+    events.AddEventAtOffset(new TestEvent(log, 2), 100ms);
+
+    events.ModifyEventTime(late, 50ms);
+    events.Update(100);
+    EXPECT_EQ(log, (std::vector<uint32>{ 1, 2 }));
+}
+
+TEST(EventProcessorTest, ScheduledAbort)
+{
+    std::vector<uint32> log;
+    TestEvent::Aborted = 0;
+
+    EventProcessor events;
+    TestEvent* aborted = new TestEvent(log, 1);
+    events.AddEventAtOffset(aborted, 100ms);
+    events.AddEventAtOffset(new TestEvent(log, 2), 100ms);
+
+    aborted->ScheduleAbort();
+    events.Update(100);
+
+    EXPECT_EQ(log, (std::vector<uint32>{ 2 }));
+    EXPECT_EQ(TestEvent::Aborted, 1);
+    EXPECT_EQ(TestEvent::Alive, 0);
+}
+
+TEST(EventProcessorTest, KillAllEvents)
+{
+    std::vector<uint32> log;
+    TestEvent::Aborted = 0;
+
+    EventProcessor events;
+    events.AddEventAtOffset(new TestEvent(log, 1), 100ms);
+    events.AddEventAtOffset(new TestEvent(log, 2, false), 100ms);
+    events.AddEventAtOffset(new TestEvent(log, 3), 200ms);
+
+    // non deletable events survive a soft kill, they are aborted and never execute
+    events.KillAllEvents(false);
+    EXPECT_EQ(TestEvent::Aborted, 3);
+    EXPECT_EQ(TestEvent::Alive, 1);
+
+    events.Update(300);
+    EXPECT_TRUE(log.empty());
+    EXPECT_EQ(TestEvent::Alive, 1);
+
+    events.KillAllEvents(true);
+    EXPECT_EQ(TestEvent::Alive, 0);
+    EXPECT_EQ(TestEvent::Aborted, 3);
+}
+
+TEST(EventProcessorTest, MatchesEventMapOrder)
+{
+    // both containers promise the same order for events of the same time
+    std::mt19937 random(7);
+    std::vector<uint32> log;
+    EventProcessor events;
+    LegacyEventMap legacy;
+
+    for (uint32 id = 1; id <= 500; ++id)
+    {
+        uint32 time = (random() % 20) * 10;
+        events.AddEventAtOffset(new TestEvent(log, id), Milliseconds(time));
+        legacy.ScheduleEvent(id, time);
+    }
+
+    events.Update(200);
+    legacy.Update(200);
+    EXPECT_EQ(log, ExecuteAll(legacy));
+    EXPECT_EQ(TestEvent::Alive, 0);
+}
@@ -0,0 +1,463 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TaskScheduler.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <optional>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+    class LegacyTaskContext;
+
+    // The former multiset based TaskScheduler, kept as the reference for the randomized comparison.
+    // Trimmed to what the comparison uses: no validator, no asyncs and no consumed context assertion.
+    class LegacyTaskScheduler
+    {
+        friend class LegacyTaskContext;
+
+    public:
+        typedef std::chrono::steady_clock::time_point timepoint_t;
+        typedef std::chrono::steady_clock::duration duration_t;
+        typedef std::function<void(LegacyTaskContext)> task_handler_t;
+
+        LegacyTaskScheduler() : _selfReference(this, [](LegacyTaskScheduler const*) { }), _now(std::chrono::steady_clock::now()) { }
+
+        LegacyTaskScheduler& Update(Milliseconds difftime);
+
+        LegacyTaskScheduler& Schedule(Milliseconds time, task_handler_t const& task)
+        {
+            return ScheduleAt(_now, time, std::nullopt, task);
+        }
+
+        LegacyTaskScheduler& Schedule(Milliseconds time, uint32 group, task_handler_t const& task)
+        {
+            return ScheduleAt(_now, time, group, task);
+        }
+
+        LegacyTaskScheduler& CancelAll()
+        {
+            _tasks.clear();
+            return *this;
+        }
+
+        LegacyTaskScheduler& CancelGroup(uint32 group)
+        {
+            std::erase_if(_tasks, [group](TaskContainer const& task) { return task->Group == group; });
+            return *this;
+        }
+
+        LegacyTaskScheduler& DelayAll(Milliseconds duration)
+        {
+            return ModifyIf([duration](Task& task) { task.End += duration; return true; });
+        }
+
+        LegacyTaskScheduler& DelayGroup(uint32 group, Milliseconds duration)
+        {
+            return ModifyIf([group, duration](Task& task)
+            {
+                if (task.Group != group)
+                    return false;
+
+                task.End += duration;
+                return true;
+            });
+        }
+
+        LegacyTaskScheduler& RescheduleAll(Milliseconds duration)
+        {
+            timepoint_t const end = _now + duration;
+            return ModifyIf([end](Task& task) { task.End = end; return true; });
+        }
+
+        LegacyTaskScheduler& RescheduleGroup(uint32 group, Milliseconds duration)
+        {
+            timepoint_t const end = _now + duration;
+            return ModifyIf([group, end](Task& task)
+            {
+                if (task.Group != group)
+                    return false;
+
+                task.End = end;
+                return true;
+            });
+        }
+
+    private:
+        struct Task
+        {
+            timepoint_t End;
+            duration_t Duration;
+            std::optional<uint32> Group;
+            uint32 Repeated;
+            task_handler_t Handler;
+        };
+
+        typedef std::shared_ptr<Task> TaskContainer;
+
+        struct Compare
+        {
+            bool operator()(TaskContainer const& left, TaskContainer const& right) const { return left->End < right->End; }
+        };
+
+        LegacyTaskScheduler& ScheduleAt(timepoint_t const& end, Milliseconds time, std::optional<uint32> group, task_handler_t const& task)
+        {
+            _tasks.insert(std::make_shared<Task>(Task{ end + time, time, group, 0, task }));
+            return *this;
+        }
+
+        // modified tasks are reinserted after the unmodified ones ending at the same time
+        template<class Modify>
+        LegacyTaskScheduler& ModifyIf(Modify modify)
+        {
+            std::vector<TaskContainer> cache;
+            for (auto itr = _tasks.begin(); itr != _tasks.end();)
+            {
+                if (modify(**itr))
+                {
+                    cache.push_back(*itr);
+                    itr = _tasks.erase(itr);
+                }
+                else
+                    ++itr;
+            }
+
+            _tasks.insert(cache.begin(), cache.end());
+            return *this;
+        }
+
+        std::shared_ptr<LegacyTaskScheduler> _selfReference;
+        timepoint_t _now;
+        std::multiset<TaskContainer, Compare> _tasks;
+    };
+
+    class LegacyTaskContext
+    {
+    public:
+        LegacyTaskContext(LegacyTaskScheduler::TaskContainer task, std::weak_ptr<LegacyTaskScheduler> owner)
+            : _task(std::move(task)), _owner(std::move(owner)) { }
+
+        [[nodiscard]] uint32 GetRepeatCounter() const { return _task->Repeated; }
+
+        LegacyTaskContext& SetGroup(uint32 group)
+        {
+            _task->Group = group;
+            return *this;
+        }
+
+        LegacyTaskContext& ClearGroup()
+        {
+            _task->Group = std::nullopt;
+            return *this;
+        }
+
+        LegacyTaskContext& Repeat(LegacyTaskScheduler::duration_t duration)
+        {
+            _task->Duration = duration;
+            _task->End += duration;
+            _task->Repeated += 1;
+
+            if (auto const owner = _owner.lock())
+                owner->_tasks.insert(_task);
+            return *this;
+        }
+
+        LegacyTaskContext& Repeat()
+        {
+            return Repeat(_task->Duration);
+        }
+
+        LegacyTaskContext& Schedule(Milliseconds time, LegacyTaskScheduler::task_handler_t const& task)
+        {
+            if (auto const owner = _owner.lock())
+                owner->ScheduleAt(_task->End, time, std::nullopt, task);
+            return *this;
+        }
+
+        LegacyTaskContext& Schedule(Milliseconds time, uint32 group, LegacyTaskScheduler::task_handler_t const& task)
+        {
+            if (auto const owner = _owner.lock())
+                owner->ScheduleAt(_task->End, time, group, task);
+            return *this;
+        }
+
+        LegacyTaskContext& CancelGroup(uint32 group)
+        {
+            if (auto const owner = _owner.lock())
+                owner->CancelGroup(group);
+            return *this;
+        }
+
+        LegacyTaskContext& DelayGroup(uint32 group, Milliseconds duration)
+        {
+            if (auto const owner = _owner.lock())
+                owner->DelayGroup(group, duration);
+            return *this;
+        }
+
+        LegacyTaskContext& RescheduleGroup(uint32 group, Milliseconds duration)
+        {
+            if (auto const owner = _owner.lock())
+                owner->RescheduleGroup(group, duration);
+            return *this;
+        }
+
+    private:
+        LegacyTaskScheduler::TaskContainer _task;
+        std::weak_ptr<LegacyTaskScheduler> _owner;
+    };
+
+    LegacyTaskScheduler& LegacyTaskScheduler::Update(Milliseconds difftime)
+    {
+        _now += difftime;
+
+        while (!_tasks.empty() && (*_tasks.begin())->End <= _now)
+        {
+            TaskContainer task = *_tasks.begin();
+            _tasks.erase(_tasks.begin());
+
+            LegacyTaskContext context(task, std::weak_ptr<LegacyTaskScheduler>(_selfReference));
+            task->Handler(context);
+        }
+
+        return *this;
+    }
+
+    // Schedules the same tasks on either scheduler and logs their invocations. What a task does when invoked only
+    // depends on its id and repeat counter, so both schedulers run the same script as long as they agree on the order.
+    template<class Scheduler, class Context>
+    class SchedulerScript
+    {
+    public:
+        Scheduler& GetScheduler() { return _scheduler; }
+        [[nodiscard]] std::vector<uint32> const& GetLog() const { return _log; }
+
+        void Schedule(Milliseconds time)
+        {
+            _scheduler.Schedule(time, MakeTask());
+        }
+
+        void Schedule(Milliseconds time, uint32 group)
+        {
+            _scheduler.Schedule(time, group, MakeTask());
+        }
+
+    private:
+        std::function<void(Context)> MakeTask()
+        {
+            uint32 const id = _nextId++;
+            return [this, id](Context context) { Run(id, context); };
+        }
+
+        void Run(uint32 id, Context& context)
+        {
+            uint32 const repeated = context.GetRepeatCounter();
+            _log.push_back(id * 1000 + repeated);
+
+            uint32 roll = id * 2654435761u ^ repeated * 40503u;
+            roll ^= roll >> 13;
+            roll *= 0x5bd1e995u;
+            roll ^= roll >> 15;
+
+            uint32 const group = (roll >> 8) % 3 + 1;
+            Milliseconds const time((roll >> 12) % 5 * 100 + 50);
+
+            switch (roll % 11)
+            {
+                case 0:
+                case 1:
+                    context.Repeat(time);
+                    break;
+                case 2:
+                    context.Repeat();
+                    break;
+                case 3:
+                    context.SetGroup(group).Repeat(time);
+                    break;
+                case 4:
+                    context.ClearGroup().Repeat(time);
+                    break;
+                case 5:
+                    context.Schedule(time, MakeTask()).Repeat();
+                    break;
+                case 6:
+                    context.Schedule(time, group, MakeTask());
+                    break;
+                case 7:
+                    context.CancelGroup(group);
+                    break;
+                case 8:
+                    context.DelayGroup(group, time);
+                    break;
+                case 9:
+                    context.RescheduleGroup(group, time).Repeat(time);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        Scheduler _scheduler;
+        std::vector<uint32> _log;
+        uint32 _nextId = 1;
+    };
+}
+
+TEST(TaskSchedulerTest, ExecutesInTimeThenScheduleOrder)
+{
+    TaskScheduler scheduler;
+    std::vector<uint32> executed;
+
+    scheduler.Schedule(Milliseconds(200), [&executed](TaskContext) { executed.push_back(1); });
+    scheduler.Schedule(Milliseconds(100), [&executed](TaskContext) { executed.push_back(2); });
+    scheduler.Schedule(Milliseconds(200), [&executed](TaskContext) { executed.push_back(3); });
+    scheduler.Schedule(Milliseconds(100), [&executed](TaskContext) { executed.push_back(4); });
+
+    scheduler.Update(Milliseconds(150));
+    EXPECT_EQ(executed, std::vector<uint32>({ 2, 4 }));
+
+    scheduler.Update(Milliseconds(50));
+    EXPECT_EQ(executed, std::vector<uint32>({ 2, 4, 1, 3 }));
+}
+
+TEST(TaskSchedulerTest, Repeat)
+{
+    TaskScheduler scheduler;
+    std::vector<uint32> repeated;
+
+    scheduler.Schedule(Milliseconds(100), [&repeated](TaskContext context)
+    {
+        repeated.push_back(context.GetRepeatCounter());
+        if (context.GetRepeatCounter() < 2)
+            context.Repeat();
+    });
+
+    scheduler.Update(Milliseconds(350));
+    EXPECT_EQ(repeated, std::vector<uint32>({ 0, 1, 2 }));
+}
+
+TEST(TaskSchedulerTest, ScheduleFromTaskCountsFromItsEnd)
+{
+    TaskScheduler scheduler;
+    bool nested = false;
+
+    scheduler.Schedule(Milliseconds(100), [&nested](TaskContext context)
+    {
+        context.Schedule(Milliseconds(100), [&nested](TaskContext) { nested = true; });
+    });
+
+    // the task was due 50ms ago, so the nested one is due at 200ms and not at 250ms
+    scheduler.Update(Milliseconds(150));
+    EXPECT_FALSE(nested);
+    scheduler.Update(Milliseconds(50));
+    EXPECT_TRUE(nested);
+}
+
+TEST(TaskSchedulerTest, CancelAndDelayGroup)
+{
+    TaskScheduler scheduler;
+    std::vector<uint32> executed;
+
+    scheduler.Schedule(Milliseconds(100), 1, [&executed](TaskContext) { executed.push_back(1); });
+    scheduler.Schedule(Milliseconds(100), 2, [&executed](TaskContext) { executed.push_back(2); });
+    scheduler.Schedule(Milliseconds(100), 3, [&executed](TaskContext) { executed.push_back(3); });
+
+    scheduler.CancelGroup(1);
+    scheduler.DelayGroup(2, Milliseconds(100));
+
+    scheduler.Update(Milliseconds(100));
+    EXPECT_EQ(executed, std::vector<uint32>({ 3 }));
+
+    scheduler.Update(Milliseconds(100));
+    EXPECT_EQ(executed, std::vector<uint32>({ 3, 2 }));
+}
+
+TEST(TaskSchedulerTest, MatchesLegacyTaskScheduler)
+{
+    std::mt19937 random(42);
+    auto roll = [&random](uint32 max) { return uint32(random() % (max + 1)); };
+
+    for (uint32 run = 0; run < 50; ++run)
+    {
+        SchedulerScript<TaskScheduler, TaskContext> tasks;
+        SchedulerScript<LegacyTaskScheduler, LegacyTaskContext> legacy;
+
+        for (uint32 step = 0; step < 500; ++step)
+        {
+            uint32 const group = roll(2) + 1;
+            Milliseconds const time(roll(4) * 100);
+
+            switch (roll(12))
+            {
+                case 0:
+                case 1:
+                    tasks.Schedule(time);
+                    legacy.Schedule(time);
+                    break;
+                case 2:
+                case 3:
+                    tasks.Schedule(time, group);
+                    legacy.Schedule(time, group);
+                    break;
+                case 4:
+                case 5:
+                case 6:
+                {
+                    Milliseconds const diff(roll(300));
+                    tasks.GetScheduler().Update(diff);
+                    legacy.GetScheduler().Update(diff);
+                    ASSERT_EQ(tasks.GetLog(), legacy.GetLog());
+                    break;
+                }
+                case 7:
+                    tasks.GetScheduler().CancelGroup(group);
+                    legacy.GetScheduler().CancelGroup(group);
+                    break;
+                case 8:
+                    tasks.GetScheduler().DelayAll(time);
+                    legacy.GetScheduler().DelayAll(time);
+                    break;
+                case 9:
+                    tasks.GetScheduler().DelayGroup(group, time);
+                    legacy.GetScheduler().DelayGroup(group, time);
+                    break;
+                case 10:
+                    tasks.GetScheduler().RescheduleGroup(group, time);
+                    legacy.GetScheduler().RescheduleGroup(group, time);
+                    break;
+                case 11:
+                    tasks.GetScheduler().RescheduleAll(time);
+                    legacy.GetScheduler().RescheduleAll(time);
+                    break;
+                default:
+                    if (roll(9) == 0)
+                    {
+                        tasks.GetScheduler().CancelAll();
+                        legacy.GetScheduler().CancelAll();
+                    }
+                    break;
+            }
+        }
+
+        tasks.GetScheduler().Update(Milliseconds(5000));
+        legacy.GetScheduler().Update(Milliseconds(5000));
+        ASSERT_EQ(tasks.GetLog(), legacy.GetLog());
+        EXPECT_GT(tasks.GetLog().size(), 100u);
+    }
+}
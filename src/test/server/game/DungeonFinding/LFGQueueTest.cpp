@@ -0,0 +1,230 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Group.h"
+#include "LFGMgr.h"
+#include "LFGQueue.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using namespace lfg;
+
+namespace
+{
+    ObjectGuid PlayerGuid(uint32 counter)
+    {
+        return ObjectGuid(HighGuid::Player, counter);
+    }
+
+    uint32 RoleCount(uint32 roleMask, uint32 shift)
+    {
+        return (roleMask >> shift) & 0xF;
+    }
+
+    // Same checks as LFGQueue::CheckCompatibility does for more than one queued entry, minus ignores and found masks
+    bool IsMatch(std::vector<LfgQueueData const*> const& entries, bool pruneWithMasks)
+    {
+        uint32 roleMask = 0;
+        uint64 dungeonMask = ~uint64(0);
+        std::size_t numPlayers = 0;
+        for (LfgQueueData const* entry : entries)
+        {
+            roleMask += entry->roleMask;
+            dungeonMask &= entry->dungeonMask;
+            numPlayers += entry->roles.size();
+        }
+
+        if (numPlayers > MAXGROUPSIZE)
+            return false;
+
+        if (pruneWithMasks && (!LfgQueueData::CanFitRoles(roleMask) || !dungeonMask))
+            return false;
+
+        LfgRolesMap roles;
+        for (LfgQueueData const* entry : entries)
+            roles.insert(entry->roles.begin(), entry->roles.end());
+
+        if (!LFGMgr::CheckGroupRoles(roles))
+            return false;
+
+        LfgDungeonSet dungeons = entries.front()->dungeons;
+        for (std::size_t i = 1; i < entries.size(); ++i)
+        {
+            LfgDungeonSet temporal;
+            std::set_intersection(dungeons.begin(), dungeons.end(), entries[i]->dungeons.begin(), entries[i]->dungeons.end(), std::inserter(temporal, temporal.begin()));
+            dungeons = temporal;
+        }
+
+        return !dungeons.empty();
+    }
+
+    // Every combination of 2 to 5 queued entries, as FindNewGroups builds them
+    template<class Visitor>
+    void ForEachCombination(std::vector<LfgQueueData> const& queue, std::vector<LfgQueueData const*>& current, std::size_t first, Visitor const& visitor)
+    {
+        for (std::size_t i = first; i < queue.size(); ++i)
+        {
+            current.push_back(&queue[i]);
+            if (current.size() > 1)
+                visitor(current);
+
+            if (current.size() < MAXGROUPSIZE)
+                ForEachCombination(queue, current, i + 1, visitor);
+
+            current.pop_back();
+        }
+    }
+}
+
+TEST(LFGQueueTest, RoleMaskCountsSingleRolePlayers)
+{
+    LfgRolesMap roles;
+    roles[PlayerGuid(1)] = PLAYER_ROLE_TANK | PLAYER_ROLE_LEADER;
+    roles[PlayerGuid(2)] = PLAYER_ROLE_HEALER;
+    roles[PlayerGuid(3)] = PLAYER_ROLE_DAMAGE;
+    roles[PlayerGuid(4)] = PLAYER_ROLE_DAMAGE;
+    roles[PlayerGuid(5)] = PLAYER_ROLE_TANK | PLAYER_ROLE_HEALER | PLAYER_ROLE_DAMAGE;
+
+    uint32 roleMask = LfgQueueData::BuildRoleMask(roles);
+    EXPECT_EQ(RoleCount(roleMask, LfgQueueData::ROLE_MASK_TANK_SHIFT), 1u);
+    EXPECT_EQ(RoleCount(roleMask, LfgQueueData::ROLE_MASK_HEALER_SHIFT), 1u);
+    EXPECT_EQ(RoleCount(roleMask, LfgQueueData::ROLE_MASK_DPS_SHIFT), 2u);
+    EXPECT_EQ(RoleCount(roleMask, LfgQueueData::ROLE_MASK_NONE_SHIFT), 0u);
+    EXPECT_TRUE(LfgQueueData::CanFitRoles(roleMask));
+}
+
+TEST(LFGQueueTest, MultiRolePlayersAreNotCounted)
+{
+    LfgRolesMap roles;
+    roles[PlayerGuid(1)] = PLAYER_ROLE_TANK | PLAYER_ROLE_DAMAGE;
+    roles[PlayerGuid(2)] = PLAYER_ROLE_TANK | PLAYER_ROLE_HEALER | PLAYER_ROLE_LEADER;
+
+    EXPECT_EQ(LfgQueueData::BuildRoleMask(roles), 0u);
+}
+
+TEST(LFGQueueTest, LeaderFlagIsStripped)
+{
+    LfgRolesMap leader;
+    leader[PlayerGuid(1)] = PLAYER_ROLE_HEALER | PLAYER_ROLE_LEADER;
+
+    LfgRolesMap member;
+    member[PlayerGuid(1)] = PLAYER_ROLE_HEALER;
+
+    EXPECT_EQ(LfgQueueData::BuildRoleMask(leader), LfgQueueData::BuildRoleMask(member));
+
+    // a leader without any role still has no role
+    LfgRolesMap noRole;
+    noRole[PlayerGuid(1)] = PLAYER_ROLE_LEADER;
+    EXPECT_EQ(RoleCount(LfgQueueData::BuildRoleMask(noRole), LfgQueueData::ROLE_MASK_NONE_SHIFT), 1u);
+}
+
+TEST(LFGQueueTest, TwoTanksDoNotFit)
+{
+    LfgRolesMap first;
+    first[PlayerGuid(1)] = PLAYER_ROLE_TANK;
+
+    LfgRolesMap second;
+    second[PlayerGuid(2)] = PLAYER_ROLE_TANK | PLAYER_ROLE_LEADER;
+
+    // masks of different queued entries are summed by CheckCompatibility
+    uint32 roleMask = LfgQueueData::BuildRoleMask(first) + LfgQueueData::BuildRoleMask(second);
+    EXPECT_FALSE(LfgQueueData::CanFitRoles(roleMask));
+
+    LfgRolesMap both(first);
+    both.insert(second.begin(), second.end());
+    EXPECT_EQ(LFGMgr::CheckGroupRoles(both), 0);
+}
+
+TEST(LFGQueueTest, PlayerWithoutRoleDoesNotFit)
+{
+    LfgRolesMap roles;
+    roles[PlayerGuid(1)] = PLAYER_ROLE_NONE;
+    roles[PlayerGuid(2)] = PLAYER_ROLE_DAMAGE;
+
+    EXPECT_FALSE(LfgQueueData::CanFitRoles(LfgQueueData::BuildRoleMask(roles)));
+}
+
+TEST(LFGQueueTest, DungeonMaskOnlyRejectsDisjointDungeons)
+{
+    // 10, 74 and 138 share the same bit, a collision must never reject a possible match
+    uint64 first = LfgQueueData::BuildDungeonMask({ 10 });
+    uint64 second = LfgQueueData::BuildDungeonMask({ 74 });
+    uint64 third = LfgQueueData::BuildDungeonMask({ 138, 200 });
+    EXPECT_NE(first & second, 0u);
+    EXPECT_NE(first & second & third, 0u);
+
+    EXPECT_EQ(LfgQueueData::BuildDungeonMask({ 10 }) & LfgQueueData::BuildDungeonMask({ 11 }), 0u);
+    EXPECT_EQ(LfgQueueData::BuildDungeonMask({ }), 0u);
+}
+
+TEST(LFGQueueTest, MasksDoNotChangeMatches)
+{
+    static constexpr uint8 Roles[] =
+    {
+        PLAYER_ROLE_TANK, PLAYER_ROLE_HEALER, PLAYER_ROLE_DAMAGE, PLAYER_ROLE_DAMAGE, PLAYER_ROLE_DAMAGE,
+        PLAYER_ROLE_TANK | PLAYER_ROLE_DAMAGE, PLAYER_ROLE_HEALER | PLAYER_ROLE_DAMAGE,
+        PLAYER_ROLE_TANK | PLAYER_ROLE_HEALER, PLAYER_ROLE_TANK | PLAYER_ROLE_HEALER | PLAYER_ROLE_DAMAGE
+    };
+
+    // few ids, some of them colliding mod 64, so that both matches and collisions are frequent
+    static constexpr uint32 Dungeons[] = { 10, 74, 138, 11, 12, 75 };
+
+    std::mt19937 random(20);
+    uint32 playerCounter = 0;
+
+    for (uint32 run = 0; run < 5; ++run)
+    {
+        // a synthetic queue of solo players and premade groups
+        std::vector<LfgQueueData> queue;
+        for (uint32 i = 0; i < 22; ++i)
+        {
+            LfgRolesMap roles;
+            uint32 players = random() % 4 ? 1 : 2 + random() % 2;
+            for (uint32 j = 0; j < players; ++j)
+            {
+                uint8 role = random() % 40 ? Roles[random() % std::size(Roles)] : uint8(PLAYER_ROLE_NONE);
+                roles[PlayerGuid(++playerCounter)] = j ? role : role | PLAYER_ROLE_LEADER;
+            }
+
+            LfgDungeonSet dungeons;
+            do
+                dungeons.insert(Dungeons[random() % std::size(Dungeons)]);
+            while (random() % 3 == 0);
+
+            queue.emplace_back(0, dungeons, roles);
+        }
+
+        uint32 matches = 0;
+        uint32 pruned = 0;
+        std::vector<LfgQueueData const*> current;
+        ForEachCombination(queue, current, 0, [&](std::vector<LfgQueueData const*> const& combination)
+        {
+            bool isMatch = IsMatch(combination, false);
+            ASSERT_EQ(IsMatch(combination, true), isMatch);
+
+            matches += isMatch;
+            pruned += !isMatch && !IsMatch(combination, true);
+        });
+
+        // the queue has to exercise both outcomes to prove anything
+        EXPECT_GT(matches, 0u);
+        EXPECT_GT(pruned, 0u);
+    }
+}
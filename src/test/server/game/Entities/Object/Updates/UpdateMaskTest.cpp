@@ -0,0 +1,163 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UpdateMask.h"
+#include "gtest/gtest.h"
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Layout of the former one byte per field mask, the client reads the same blocks
+    std::vector<uint8> BuildPerBitBlocks(std::vector<uint8> const& bits, uint32 blockCount)
+    {
+        ByteBuffer data;
+        for (uint32 i = 0; i < blockCount; ++i)
+        {
+            UpdateMask::ClientUpdateMaskType maskPart = 0;
+            for (uint32 j = 0; j < UpdateMask::CLIENT_UPDATE_MASK_BITS; ++j)
+            {
+                uint32 index = UpdateMask::CLIENT_UPDATE_MASK_BITS * i + j;
+                if (index < bits.size() && bits[index])
+                    maskPart |= 1 << j;
+            }
+
+            data << maskPart;
+        }
+
+        return { data.contents(), data.contents() + data.size() };
+    }
+
+    std::vector<uint8> AppendToPacket(UpdateMask const& mask)
+    {
+        ByteBuffer data;
+        mask.AppendToPacket(&data);
+        return { data.contents(), data.contents() + data.size() };
+    }
+
+    void CheckFieldCount(uint32 fieldCount)
+    {
+        std::mt19937 random(fieldCount);
+        std::vector<uint8> bits(fieldCount, 0);
+
+        UpdateMask mask;
+        mask.SetCount(fieldCount);
+
+        EXPECT_EQ(mask.GetCount(), fieldCount);
+        EXPECT_EQ(mask.GetBlockCount(), (fieldCount + UpdateMask::CLIENT_UPDATE_MASK_BITS - 1) / UpdateMask::CLIENT_UPDATE_MASK_BITS);
+        EXPECT_TRUE(mask.IsEmpty());
+        EXPECT_EQ(mask.GetNextBit(0), fieldCount);
+
+        for (uint32 round = 0; round < 200; ++round)
+        {
+            uint32 index = random() % fieldCount;
+            if (random() % 3)
+            {
+                mask.SetBit(index);
+                bits[index] = 1;
+            }
+            else
+            {
+                mask.UnsetBit(index);
+                bits[index] = 0;
+            }
+
+            ASSERT_EQ(AppendToPacket(mask), BuildPerBitBlocks(bits, mask.GetBlockCount()));
+        }
+
+        // the first and last field sit at the edges of the first and last block
+        mask.SetBit(0);
+        bits[0] = 1;
+        mask.SetBit(fieldCount - 1);
+        bits[fieldCount - 1] = 1;
+        EXPECT_EQ(AppendToPacket(mask), BuildPerBitBlocks(bits, mask.GetBlockCount()));
+
+        std::vector<uint32> expected;
+        for (uint32 i = 0; i < fieldCount; ++i)
+        {
+            EXPECT_EQ(mask.GetBit(i), bits[i] != 0);
+            if (bits[i])
+                expected.push_back(i);
+        }
+
+        std::vector<uint32> visited;
+        for (uint32 index = mask.GetNextBit(0); index < mask.GetCount(); index = mask.GetNextBit(index + 1))
+            visited.push_back(index);
+
+        EXPECT_EQ(visited, expected);
+        EXPECT_EQ(mask.GetSetBitCount(), expected.size());
+        EXPECT_FALSE(mask.IsEmpty());
+
+        // copies keep the bits and the counts
+        UpdateMask copy(mask);
+        EXPECT_EQ(AppendToPacket(copy), AppendToPacket(mask));
+        EXPECT_EQ(copy.GetCount(), fieldCount);
+
+        mask.SetAll();
+        EXPECT_EQ(mask.GetSetBitCount(), fieldCount);
+        EXPECT_EQ(AppendToPacket(mask), BuildPerBitBlocks(std::vector<uint8>(fieldCount, 1), mask.GetBlockCount()));
+
+        mask.Clear();
+        EXPECT_TRUE(mask.IsEmpty());
+        EXPECT_EQ(AppendToPacket(mask), BuildPerBitBlocks(std::vector<uint8>(fieldCount, 0), mask.GetBlockCount()));
+    }
+}
+
+TEST(UpdateMaskTest, PlayerFields)
+{
+    CheckFieldCount(PLAYER_END);
+}
+
+TEST(UpdateMaskTest, CreatureFields)
+{
+    CheckFieldCount(UNIT_END);
+}
+
+TEST(UpdateMaskTest, ItemFields)
+{
+    CheckFieldCount(ITEM_END);
+    CheckFieldCount(CONTAINER_END);
+}
+
+TEST(UpdateMaskTest, Operators)
+{
+    UpdateMask unitMask;
+    unitMask.SetCount(UNIT_END);
+    unitMask.SetBit(UNIT_FIELD_HEALTH);
+    unitMask.SetBit(UNIT_FIELD_MAXHEALTH);
+
+    UpdateMask filter;
+    filter.SetCount(UNIT_END);
+    filter.SetBit(UNIT_FIELD_HEALTH);
+    filter.SetBit(UNIT_FIELD_FLAGS);
+
+    UpdateMask both = unitMask | filter;
+    EXPECT_EQ(both.GetSetBitCount(), 3u);
+
+    unitMask &= filter;
+    EXPECT_EQ(unitMask.GetSetBitCount(), 1u);
+    EXPECT_EQ(unitMask.GetNextBit(0), uint32(UNIT_FIELD_HEALTH));
+    EXPECT_EQ(unitMask.GetNextBit(UNIT_FIELD_HEALTH + 1), uint32(UNIT_END));
+
+    // a smaller mask only touches its own blocks
+    UpdateMask playerMask;
+    playerMask.SetCount(PLAYER_END);
+    playerMask.SetBit(PLAYER_END - 1);
+    playerMask |= filter;
+    EXPECT_EQ(playerMask.GetSetBitCount(), 3u);
+    EXPECT_TRUE(playerMask.GetBit(PLAYER_END - 1));
+}
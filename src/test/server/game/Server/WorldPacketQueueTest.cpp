@@ -0,0 +1,160 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "WorldPacketQueue.h"
+#include "WorldPacket.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void AddPacket(WorldPacketQueue& queue, uint32 index, std::size_t size = sizeof(uint32))
+    {
+        std::vector<uint8> data(size);
+        std::memcpy(data.data(), &index, sizeof(index));
+        queue.Add(uint16(index % 1000), data.data(), data.size(), TimePoint());
+    }
+
+    uint32 ReadIndex(WorldPacket const& packet)
+    {
+        uint32 index = 0;
+        std::memcpy(&index, packet.contents(), sizeof(index));
+        return index;
+    }
+}
+
+TEST(WorldPacketQueueTest, FirstInFirstOut)
+{
+    WorldPacketQueue queue;
+    WorldPacket* packet = nullptr;
+    EXPECT_FALSE(queue.Next(packet));
+
+    for (uint32 i = 0; i < 10; ++i)
+        AddPacket(queue, i);
+
+    EXPECT_EQ(queue.Size(), 10u);
+
+    for (uint32 i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(queue.Next(packet));
+        EXPECT_EQ(packet->GetOpcode(), i);
+        EXPECT_EQ(packet->size(), sizeof(uint32));
+        EXPECT_EQ(ReadIndex(*packet), i);
+        queue.Release(packet);
+    }
+
+    EXPECT_FALSE(queue.Next(packet));
+    EXPECT_EQ(queue.Size(), 0u);
+}
+
+TEST(WorldPacketQueueTest, OrderedThroughOverflow)
+{
+    WorldPacketQueue queue;
+    WorldPacket* packet = nullptr;
+    uint32 added = 0;
+    uint32 expected = 0;
+
+    // far more than the ring holds, the rest goes to the overflow
+    for (; added < 600; ++added)
+        AddPacket(queue, added);
+
+    EXPECT_EQ(queue.Size(), 600u);
+
+    // drain part of the ring, the packets added meanwhile must still queue up behind the overflow
+    for (; expected < 100; ++expected)
+    {
+        ASSERT_TRUE(queue.Next(packet));
+        ASSERT_EQ(ReadIndex(*packet), expected);
+        queue.Release(packet);
+    }
+
+    for (; added < 700; ++added)
+        AddPacket(queue, added);
+
+    // drain the ring and the overflow while adding, the ring is used again once the overflow is empty
+    while (queue.Next(packet))
+    {
+        ASSERT_EQ(ReadIndex(*packet), expected);
+        ++expected;
+        queue.Release(packet);
+
+        if (added < 1200 && expected % 3 == 0)
+            AddPacket(queue, added++);
+    }
+
+    EXPECT_EQ(expected, added);
+    EXPECT_EQ(queue.Size(), 0u);
+}
+
+TEST(WorldPacketQueueTest, ReleasedPacketsAreReused)
+{
+    WorldPacketQueue queue;
+    WorldPacket* first = nullptr;
+
+    AddPacket(queue, 1, 64);
+    ASSERT_TRUE(queue.Next(first));
+    queue.Release(first);
+
+    // the recycled packet holds the new opcode and payload only
+    WorldPacket* second = nullptr;
+    AddPacket(queue, 2);
+    ASSERT_TRUE(queue.Next(second));
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(second->GetOpcode(), 2);
+    EXPECT_EQ(second->size(), sizeof(uint32));
+    EXPECT_EQ(ReadIndex(*second), 2u);
+    queue.Release(second);
+}
+
+TEST(WorldPacketQueueTest, ProducerAndConsumerThreads)
+{
+    constexpr uint32 COUNT = 50000;
+    WorldPacketQueue queue;
+
+    std::thread producer([&queue]()
+    {
+        for (uint32 i = 0; i < COUNT; ++i)
+        {
+            AddPacket(queue, i);
+
+            // bursts fill the ring and spill to the overflow
+            if (i % 1000 == 999)
+                std::this_thread::yield();
+        }
+    });
+
+    // keeps consuming on a mismatch, the producer must be joined
+    bool ordered = true;
+    for (uint32 expected = 0; expected < COUNT;)
+    {
+        WorldPacket* packet = nullptr;
+        if (!queue.Next(packet))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ordered &= ReadIndex(*packet) == expected;
+        ++expected;
+        queue.Release(packet);
+    }
+
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(queue.Size(), 0u);
+}
@@ -0,0 +1,159 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SpellAreaTargetSnapshot.h"
+#include "Position.h"
+#include "gtest/gtest.h"
+#include <random>
+
+namespace
+{
+    constexpr std::size_t POINT_COUNT = 2000;
+
+    struct SnapshotTest : public ::testing::Test
+    {
+        SnapshotTest() : _engine(1234)
+        {
+            std::uniform_real_distribution<float> coord(-60.0f, 60.0f);
+            std::uniform_real_distribution<float> height(-10.0f, 10.0f);
+            std::uniform_real_distribution<float> size(0.0f, 5.0f);
+
+            for (std::size_t i = 0; i < POINT_COUNT; ++i)
+            {
+                Position const point(Origin.GetPositionX() + coord(_engine), Origin.GetPositionY() + coord(_engine), Origin.GetPositionZ() + height(_engine));
+                float const pointSize = size(_engine);
+                Points.push_back(point);
+                Sizes.push_back(pointSize);
+                Snapshot.Add(nullptr, point.GetPositionX(), point.GetPositionY(), point.GetPositionZ(), pointSize, false);
+            }
+
+            // on the borders and on the origin itself
+            for (float angle = 0.0f; angle < 2.0f * float(M_PI); angle += float(M_PI) / 8.0f)
+                for (float distance : { 0.0f, 5.0f, 20.0f })
+                {
+                    Position const point(Origin.GetPositionX() + std::cos(angle) * distance, Origin.GetPositionY() + std::sin(angle) * distance, Origin.GetPositionZ());
+                    Points.push_back(point);
+                    Sizes.push_back(0.0f);
+                    Snapshot.Add(nullptr, point.GetPositionX(), point.GetPositionY(), point.GetPositionZ(), 0.0f, false);
+                }
+        }
+
+        std::size_t GetCandidateCount() const
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < Snapshot.GetSize(); ++i)
+                if (Snapshot.IsCandidate(i))
+                    ++count;
+            return count;
+        }
+
+        std::mt19937 _engine;
+        Position const Origin{ 1500.0f, -2300.0f, 40.0f, 2.0f };
+        std::vector<Position> Points;
+        std::vector<float> Sizes;
+        SpellAreaTargetSnapshot Snapshot;
+    };
+}
+
+// the filters may keep objects out of the area (those on the origin have no angle), they must never drop one in it
+TEST_F(SnapshotTest, FilterRadius)
+{
+    float const range = 20.0f;
+    Snapshot.FilterRadius(Origin, range);
+
+    std::size_t inRange = 0;
+    for (std::size_t i = 0; i < Points.size(); ++i)
+    {
+        if (Points[i].IsInDist(&Origin, range + Sizes[i]))
+        {
+            ++inRange;
+            EXPECT_TRUE(Snapshot.IsCandidate(i)) << Points[i].ToString();
+        }
+        else if (!Points[i].IsInDist(&Origin, range + Sizes[i] + 0.1f))
+            EXPECT_FALSE(Snapshot.IsCandidate(i)) << Points[i].ToString();
+    }
+
+    EXPECT_GT(inRange, 0u);
+    EXPECT_LT(GetCandidateCount(), Points.size() / 2);
+}
+
+TEST_F(SnapshotTest, FilterRadiusKeepsOwnRange)
+{
+    Snapshot.Add(nullptr, Origin.GetPositionX() + 100.0f, Origin.GetPositionY(), Origin.GetPositionZ(), 0.0f, true);
+    Snapshot.FilterRadius(Origin, 20.0f);
+
+    EXPECT_TRUE(Snapshot.IsCandidate(Snapshot.GetSize() - 1));
+}
+
+TEST_F(SnapshotTest, FilterArc)
+{
+    for (float arc : { float(M_PI) / 2.0f, float(M_PI), 3.0f * float(M_PI) / 2.0f })
+    {
+        SpellAreaTargetSnapshot snapshot = Snapshot;
+        snapshot.FilterArc(Origin, arc, false);
+
+        for (std::size_t i = 0; i < Points.size(); ++i)
+            if (Origin.HasInArc(arc, &Points[i]))
+                EXPECT_TRUE(snapshot.IsCandidate(i)) << arc << ' ' << Points[i].ToString();
+            else if (!Origin.HasInArc(arc + 0.01f, &Points[i]) && Points[i].GetExactDist2d(&Origin) > 0.0f)
+                EXPECT_FALSE(snapshot.IsCandidate(i)) << arc << ' ' << Points[i].ToString();
+    }
+}
+
+TEST_F(SnapshotTest, FilterBackArc)
+{
+    for (float arc : { float(M_PI) / 2.0f, float(M_PI), 3.0f * float(M_PI) / 2.0f })
+    {
+        SpellAreaTargetSnapshot snapshot = Snapshot;
+        snapshot.FilterArc(Origin, arc, true);
+
+        // WorldObject::isInBack
+        for (std::size_t i = 0; i < Points.size(); ++i)
+            if (!Origin.HasInArc(2.0f * float(M_PI) - arc, &Points[i]))
+                EXPECT_TRUE(snapshot.IsCandidate(i)) << arc << ' ' << Points[i].ToString();
+            else if (Origin.HasInArc(2.0f * float(M_PI) - arc - 0.01f, &Points[i]) && Points[i].GetExactDist2d(&Origin) > 0.0f)
+                EXPECT_FALSE(snapshot.IsCandidate(i)) << arc << ' ' << Points[i].ToString();
+    }
+}
+
+TEST_F(SnapshotTest, FilterLine)
+{
+    float const width = 1.5f;
+    Snapshot.FilterLine(Origin, width);
+
+    for (std::size_t i = 0; i < Points.size(); ++i)
+        if (Origin.HasInLine(&Points[i], width + Sizes[i]))
+            EXPECT_TRUE(Snapshot.IsCandidate(i)) << Points[i].ToString();
+
+    EXPECT_LT(GetCandidateCount(), Points.size() / 2);
+}
+
+TEST_F(SnapshotTest, SelectChecksCandidates)
+{
+    Snapshot.FilterRadius(Origin, 20.0f);
+
+    struct Check
+    {
+        std::size_t Calls = 0;
+        bool operator()(WorldObject* /*target*/) { ++Calls; return true; }
+    } check;
+
+    std::list<WorldObject*> targets;
+    Snapshot.Select(targets, check);
+
+    EXPECT_EQ(check.Calls, GetCandidateCount());
+    EXPECT_EQ(targets.size(), GetCandidateCount());
+}